@@ -235,6 +235,36 @@ void A2600System::loadState(EmuApp &, IG::CStringView path)
 	updateSwitchValues();
 }
 
+size_t A2600System::stateSize()
+{
+	Serializer state;
+	if(!osystem.state().saveState(state))
+	{
+		throwFileWriteError();
+	}
+	return state.size();
+}
+
+size_t A2600System::saveState(std::span<uint8_t> buff)
+{
+	Serializer state{buff};
+	if(!osystem.state().saveState(state))
+	{
+		throwStateBufferSizeError();
+	}
+	return state.tellp();
+}
+
+void A2600System::loadState(std::span<const uint8_t> buff)
+{
+	Serializer state{{const_cast<uint8_t*>(buff.data()), buff.size()}, Serializer::Mode::ReadOnly};
+	if(!osystem.state().loadState(state))
+	{
+		throwFileReadError();
+	}
+	updateSwitchValues();
+}
+
 void EmuApp::onCustomizeNavView(EmuApp::NavView &view)
 {
 	const Gfx::LGradientStopDesc navViewGrad[] =
@@ -103,6 +103,9 @@ public:
 	std::string_view stateFilenameExt() const { return ".sta"; }
 	void loadState(EmuApp &, CStringView uri);
 	void saveState(CStringView path);
+	size_t stateSize();
+	size_t saveState(std::span<uint8_t> buff);
+	void loadState(std::span<const uint8_t> buff);
 	bool readConfig(ConfigType, MapIO &io, unsigned key, size_t readSize);
 	void writeConfig(ConfigType, FileIO &);
 	void reset(EmuApp &, ResetMode mode);
@@ -291,7 +291,10 @@ void A2600System::handleInputAction(EmuApp *app, InputAction a)
 			p1DiffB ^= true;
 			if(app)
 			{
-				app->postMessage(1, false, p1DiffB ? "P1 Difficulty -> B" : "P1 Difficulty -> A");
+				app->appContext().runOnMainThread([app, msg = p1DiffB ? "P1 Difficulty -> B" : "P1 Difficulty -> A"](ApplicationContext)
+				{
+					app->postMessage(1, false, msg);
+				});
 			}
 			ev.set(Event::ConsoleLeftDiffB, p1DiffB);
 			ev.set(Event::ConsoleLeftDiffA, !p1DiffB);
@@ -302,7 +305,10 @@ void A2600System::handleInputAction(EmuApp *app, InputAction a)
 			p2DiffB ^= true;
 			if(app)
 			{
-				app->postMessage(1, false, p2DiffB ? "P2 Difficulty -> B" : "P2 Difficulty -> A");
+				app->appContext().runOnMainThread([app, msg = p2DiffB ? "P2 Difficulty -> B" : "P2 Difficulty -> A"](ApplicationContext)
+				{
+					app->postMessage(1, false, msg);
+				});
 			}
 			ev.set(Event::ConsoleRightDiffB, p2DiffB);
 			ev.set(Event::ConsoleRightDiffA, !p2DiffB);
@@ -313,7 +319,10 @@ void A2600System::handleInputAction(EmuApp *app, InputAction a)
 			vcsColor ^= true;
 			if(app)
 			{
-				app->postMessage(1, false, vcsColor ? "Color Switch -> Color" : "Color Switch -> B&W");
+				app->appContext().runOnMainThread([app, msg = vcsColor ? "Color Switch -> Color" : "Color Switch -> B&W"](ApplicationContext)
+				{
+					app->postMessage(1, false, msg);
+				});
 			}
 			ev.set(Event::ConsoleColor, vcsColor);
 			ev.set(Event::ConsoleBlackWhite, !vcsColor);
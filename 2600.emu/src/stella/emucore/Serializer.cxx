@@ -20,6 +20,7 @@
 #include <imagine/base/ApplicationContext.hh>
 #include <imagine/io/IOStream.hh>
 #include <imagine/io/FileIO.hh>
+#include <imagine/io/MapIO.hh>
 #include <emuframework/EmuApp.hh>
 
 using std::ios;
@@ -73,6 +74,22 @@ Serializer::Serializer()
   }
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+Serializer::Serializer(std::span<uint8_t> buffer, Mode m)
+{
+  ios_base::openmode stream_mode = ios::in | ios::binary;
+  if(m != Mode::ReadOnly)
+    stream_mode |= ios::out;
+  auto str = make_unique<IG::IOStream<IG::MapIO>>(IG::MapIO{IG::IOBuffer{buffer, 0}}, stream_mode);
+  if(str && str->is_open())
+  {
+    myStream = std::move(str);
+    rewind();
+    myStream->exceptions( ios_base::failbit | ios_base::badbit |
+                          ios_base::eofbit );
+  }
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Serializer::setPosition(size_t pos)
 {
@@ -101,6 +118,12 @@ size_t Serializer::size()
   return s;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+size_t Serializer::tellp()
+{
+  return myStream->tellp();
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 uInt8 Serializer::getByte() const
 {
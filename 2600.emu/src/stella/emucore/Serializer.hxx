@@ -19,6 +19,7 @@
 #define SERIALIZER_HXX
 
 #include "bspf.hxx"
+#include <span>
 
 /**
   This class implements a Serializer device, whereby data is serialized and
@@ -52,6 +53,12 @@ class Serializer
     explicit Serializer(const string& filename, Mode m = Mode::ReadWrite);
     Serializer();
 
+    /**
+      Creates a new Serializer device that streams directly to/from an
+      existing memory buffer, which must outlive the Serializer.
+    */
+    explicit Serializer(std::span<uint8_t> buffer, Mode m = Mode::ReadWrite);
+
   public:
     /**
       Answers whether the serializer is currently initialized for reading
@@ -74,6 +81,11 @@ class Serializer
     */
     size_t size();
 
+    /**
+      Returns the current write location in the stream.
+    */
+    size_t tellp();
+
     /**
       Reads a byte value (unsigned 8-bit) from the current input stream.
 
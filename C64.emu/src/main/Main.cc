@@ -286,6 +286,23 @@ void C64System::loadState(EmuApp &, IG::CStringView path)
 		return throwFileReadError();
 }
 
+size_t C64System::stateSize()
+{
+	saveState(scratchStatePath());
+	return FS::file_size(scratchStatePath());
+}
+
+size_t C64System::saveState(std::span<uint8_t> buff)
+{
+	saveState(scratchStatePath());
+	return readScratchState(buff);
+}
+
+void C64System::loadState(std::span<const uint8_t> buff)
+{
+	loadState(EmuApp::get(appContext()), writeScratchState(buff));
+}
+
 VideoSystem C64System::videoSystem() const
 {
 	switch(intResource("MachineVideoStandard"))
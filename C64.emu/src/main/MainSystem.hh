@@ -22,6 +22,7 @@
 #include <imagine/fs/FS.hh>
 #include <emuframework/Option.hh>
 #include <emuframework/EmuSystem.hh>
+#include <atomic>
 #include <vector>
 #include <string>
 #include <string_view>
@@ -86,6 +87,7 @@ class C64System final: public EmuSystem
 public:
 	double systemFrameRate{60.};
 	std::binary_semaphore execSem{0}, execDoneSem{0};
+	std::atomic<ThreadId> viceThreadId{};
 	EmuAudio *audioPtr{};
 	struct video_canvas_s *activeCanvas{};
 	const char *sysFileDir{};
@@ -129,6 +131,7 @@ public:
 		makeDetachedThread(
 			[this]()
 			{
+				viceThreadId.store(thisThreadId(), std::memory_order_relaxed);
 				execSem.acquire();
 				logMsg("starting maincpu_mainloop()");
 				plugin.maincpu_mainloop();
@@ -189,6 +192,9 @@ public:
 	std::string_view stateFilenameExt() const { return ".vsf"; }
 	void loadState(EmuApp &, CStringView uri);
 	void saveState(CStringView path);
+	size_t stateSize();
+	size_t saveState(std::span<uint8_t> buff);
+	void loadState(std::span<const uint8_t> buff);
 	bool readConfig(ConfigType, MapIO &io, unsigned key, size_t readSize);
 	void writeConfig(ConfigType, FileIO &);
 	void reset(EmuApp &, ResetMode mode);
@@ -210,6 +216,7 @@ public:
 	VideoSystem videoSystem() const;
 	void closeSystem();
 	void renderFramebuffer(EmuVideo &);
+	void addThreadGroupIds(std::vector<ThreadId> &ids) const { ids.emplace_back(viceThreadId.load(std::memory_order_relaxed)); }
 	bool shouldFastForward() const;
 	bool onVideoRenderFormatChange(EmuVideo &, PixelFormat);
 
@@ -414,15 +414,9 @@ void C64System::handleKeyboardInput(InputAction a, bool positionalShift)
 
 void C64System::handleInputAction(EmuApp *app, InputAction a)
 {
-	bool positionalShift{};
-	if(app)
-	{
-		if(app->defaultVController().keyboard().shiftIsActive())
-		{
-			a.metaState |= Input::Meta::SHIFT;
-			positionalShift = true;
-		}
-	}
+	bool positionalShift = to_underlying(a.flags & InputActionFlagsMask::positionalShift);
+	if(positionalShift)
+		a.metaState |= Input::Meta::SHIFT;
 	switch(a.key >> KEY_MODE_SHIFT)
 	{
 		case JS_MODE:
@@ -475,23 +469,37 @@ void C64System::handleInputAction(EmuApp *app, InputAction a)
 							optionSwapJoystickPorts = JoystickMode::SWAPPED;
 						IG::fill(*plugin.joystick_value);
 						if(app)
-							app->postMessage(1, false, "Swapped Joystick Ports");
+						{
+							app->appContext().runOnMainThread([app](ApplicationContext)
+							{
+								app->postMessage(1, false, "Swapped Joystick Ports");
+							});
+						}
 					}
 					break;
 				}
 				case KBEX_TOGGLE_VKEYBOARD:
 				{
 					if(app && a.state == Input::Action::PUSHED)
-						app->toggleKeyboard();
+					{
+						app->appContext().runOnMainThread([app](ApplicationContext)
+						{
+							app->toggleKeyboard();
+						});
+					}
 					break;
 				}
 				case KBEX_POS_SHIFT_LOCK:
 				{
 					if(app && a.state == Input::Action::PUSHED)
 					{
-						bool active = app->defaultVController().keyboard().toggleShiftActive();
-						//logMsg("positional shift:%d", active);
-						handleKeyboardInput({c64KeyLeftShift, active ? Input::Action::PUSHED : Input::Action::RELEASED});
+						// the virtual keyboard belongs to the main thread, which sends the resulting shift key back
+						app->appContext().runOnMainThread([app](ApplicationContext)
+						{
+							bool active = app->defaultVController().keyboard().toggleShiftActive();
+							//logMsg("positional shift:%d", active);
+							app->sendInputAction({c64KeyLeftShift, active ? Input::Action::PUSHED : Input::Action::RELEASED});
+						});
 					}
 					break;
 				}
@@ -509,7 +517,6 @@ void C64System::handleInputAction(EmuApp *app, InputAction a)
 					if(app)
 					{
 						logMsg("pushed restore key");
-						app->syncEmulationThread();
 						plugin.machine_set_restore_key(a.state == Input::Action::PUSHED);
 					}
 					break;
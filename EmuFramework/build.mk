@@ -1,8 +1,11 @@
 include $(IMAGINE_PATH)/make/imagineStaticLibBase.mk
 
 SRC += \
+AdaptiveFrameSkip.cc \
+AudioResampler.cc \
 AutosaveManager.cc \
 ConfigFile.cc \
+ContentHash.cc \
 EmuApp.cc \
 EmuAudio.cc \
 EmuInput.cc \
@@ -12,10 +15,14 @@ EmuSystemTask.cc \
 EmuTiming.cc \
 EmuVideo.cc \
 EmuVideoLayer.cc \
+FrameDelay.cc \
 InputDeviceConfig.cc \
 InputDeviceData.cc \
+LibraryIndex.cc \
 OutputTimingManager.cc \
 pathUtils.cc \
+RewindManager.cc \
+ScreenshotWriter.cc \
 TurboInput.cc \
 VideoImageEffect.cc \
 VideoImageOverlay.cc \
@@ -33,6 +40,7 @@ gui/FilePathOptionView.cc \
 gui/FilePicker.cc \
 gui/GUIOptionView.cc \
 gui/InputManagerView.cc \
+gui/LibraryView.cc \
 gui/LoadProgressView.cc \
 gui/MainMenuView.cc \
 gui/PlaceVControlsView.cc \
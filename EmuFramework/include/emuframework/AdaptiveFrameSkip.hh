@@ -0,0 +1,62 @@
+#pragma once
+
+/*  This file is part of EmuFramework.
+
+	Imagine is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Imagine is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with EmuFramework.  If not, see <http://www.gnu.org/licenses/> */
+
+#include <imagine/time/Time.hh>
+#include <atomic>
+
+namespace EmuEx
+{
+
+using namespace IG;
+
+struct FrameSkipStats
+{
+	float effectiveFps{};
+	float skippedPercent{};
+};
+
+// Decides ahead of time which frames to run without video when the average cost of a frame with
+// video doesn't fit in the frame budget. Skips are spread out evenly by accumulating the needed
+// skip ratio, and two frames in a row are only skipped if more than half must be skipped.
+// Frames skipped to catch up after a late wakeup count against the same accumulator so
+// the frame following a catch-up burst isn't skipped as well.
+class AdaptiveFrameSkip
+{
+public:
+	static constexpr double maxSkipRatio = 0.75;
+
+	bool shouldSkipVideo(SteadyClockTime budget);
+	void addFrames(SteadyClockTime totalCost, int frames, bool hadVideo, SteadyClockTimePoint now);
+	void addCatchUpFrames(SteadyClockTime totalCost, int frames, SteadyClockTimePoint now);
+	// updated about once per second, safe to call from any thread
+	FrameSkipStats stats() const;
+	void reset();
+
+private:
+	SteadyClockTime videoCost{};
+	SteadyClockTime noVideoCost{};
+	SteadyClockTimePoint statsWindowStart{};
+	double skipAccumulator{};
+	int windowVideoFrames{};
+	int windowNoVideoFrames{};
+	std::atomic<float> effectiveFps{};
+	std::atomic<float> skippedPercent{};
+
+	double skipRatio(SteadyClockTime budget) const;
+};
+
+}
@@ -43,6 +43,9 @@ protected:
 	TextMenuItem soundBuffersItem[7];
 	MultiChoiceMenuItem soundBuffers;
 	BoolMenuItem addSoundBuffersOnUnderrun;
+	TextMenuItem resamplerItem[3];
+	MultiChoiceMenuItem resampler;
+	BoolMenuItem dynamicRateControl;
 	StaticArrayList<TextMenuItem, 5> audioRateItem;
 	MultiChoiceMenuItem audioRate;
 	IG_UseMemberIf(IG::Audio::Manager::HAS_SOLO_MIX, BoolMenuItem, audioSoloMix);
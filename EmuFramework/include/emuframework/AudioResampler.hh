@@ -0,0 +1,86 @@
+#pragma once
+
+/*  This file is part of EmuFramework.
+
+	Imagine is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Imagine is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with EmuFramework.  If not, see <http://www.gnu.org/licenses/> */
+
+#include <imagine/audio/Format.hh>
+#include <array>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+namespace EmuEx
+{
+
+using namespace IG;
+
+enum class AudioResamplerQuality : uint8_t
+{
+	fast, // nearest neighbor
+	cubic, // 4-point cubic Hermite
+	sinc, // polyphase Kaiser windowed-sinc
+};
+
+constexpr bool isValidAudioResamplerQuality(AudioResamplerQuality q) { return q <= AudioResamplerQuality::sinc; }
+
+// Streaming resampler used to fit audio to the output rate when a speed multiplier is active.
+// Input history and the fractional position are kept between calls so blocks join without gaps.
+class AudioResampler
+{
+public:
+	static constexpr int maxChannels = 2;
+
+	AudioResampler() = default;
+	void setQuality(AudioResamplerQuality);
+	AudioResamplerQuality quality() const { return quality_; }
+	// ratio is input frames consumed per output frame
+	void setRatio(double ratio);
+	double ratio() const { return ratio_; }
+	void reset();
+	// maximum frames resample() can output for the given input
+	size_t maxOutputFrames(size_t srcFrames) const;
+	// resamples into dest and returns the output frames, input that doesn't fit in destFrames is dropped
+	size_t resample(void *dest, size_t destFrames, const void *src, size_t srcFrames, Audio::Format);
+	// When switching to a ratio of 1, writes the input that hasn't been output yet as is and returns its frames,
+	// so passthrough output continues where the resampled output ended
+	size_t writePendingInput(void *dest, size_t destFrames, Audio::Format);
+	// Records input written without resampling as the filter history, so resampling can resume from it later
+	void keepHistory(const void *src, size_t srcFrames, Audio::Format);
+	static const char *implName();
+
+private:
+	std::array<std::vector<float>, maxChannels> history; // per channel input, starts at position 0
+	std::vector<float> filterTable; // (phases + 1) rows of taps
+	std::vector<float> filterDeltaTable; // difference to the next row for phase interpolation
+	double ratio_{1.};
+	double pos{};
+	double filterScale{};
+	int taps{};
+	int channels{};
+	AudioResamplerQuality quality_{AudioResamplerQuality::sinc};
+
+	int historyFrames() const;
+	void makeFilter();
+	void appendInput(const void *src, size_t srcFrames, Audio::Format);
+	size_t process(float *dest, size_t destFrames);
+	void dropConsumedInput(bool outputFull);
+	void trimToHistory();
+};
+
+// Runs each resampler quality at several speed ratios over a test tone and returns the
+// THD+N and time per output frame as JSON
+std::string benchmarkAudioResamplers();
+
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+/*  This file is part of EmuFramework.
+
+	Imagine is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Imagine is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with EmuFramework.  If not, see <http://www.gnu.org/licenses/> */
+
+#include <imagine/base/baseDefs.hh>
+#include <imagine/util/string/CStringView.hh>
+#include <array>
+#include <optional>
+#include <span>
+#include <cstdint>
+
+namespace IG
+{
+class IO;
+}
+
+namespace EmuEx
+{
+
+using namespace IG;
+
+using MD5Digest = std::array<uint8_t, 16>;
+using SHA1Digest = std::array<uint8_t, 20>;
+
+struct ContentDigest
+{
+	uint32_t crc32{};
+	MD5Digest md5{};
+	SHA1Digest sha1{};
+
+	constexpr bool operator==(const ContentDigest &) const = default;
+};
+
+// Computes the CRC32, MD5, and SHA1 of a data stream in a single pass, each chunk of input
+// is run through all three while it's still in cache
+class ContentHasher
+{
+public:
+	ContentHasher();
+	void update(std::span<const uint8_t>);
+	ContentDigest finish();
+
+private:
+	std::array<uint32_t, 4> md5State;
+	std::array<uint32_t, 5> sha1State;
+	uint64_t totalBytes{};
+	uint32_t crc{};
+	uint32_t blockBytes{};
+	std::array<uint8_t, 64> block;
+
+	void hashBlocks(const uint8_t *data, size_t blocks);
+};
+
+ContentDigest contentDigest(std::span<const uint8_t>);
+ContentDigest contentDigest(IO &);
+SHA1Digest sha1Digest(std::span<const uint8_t>);
+
+// Digest of the file at a path or URI, loaded from the disk cache when the file's size and
+// modification time match a previous result, or empty if the file can't be read or is larger than maxSize
+std::optional<ContentDigest> contentDigest(ApplicationContext, CStringView path, uint64_t maxSize = UINT64_MAX);
+
+// Digest of content whose CRC32 is already known, like an archive entry, cached by its CRC32 and size
+ContentDigest contentDigest(IO &, uint32_t crc32);
+
+// SHA1 of content already in memory, cached by its CRC32 and size since the CRC32 is much cheaper to compute
+SHA1Digest cachedSha1Digest(std::span<const uint8_t>);
+
+void setContentDigestCachePath(CStringView path);
+
+}
@@ -26,7 +26,11 @@
 #include <emuframework/VController.hh>
 #include <emuframework/Option.hh>
 #include <emuframework/AutosaveManager.hh>
+#include <emuframework/RewindManager.hh>
+#include <emuframework/AdaptiveFrameSkip.hh>
+#include <emuframework/LibraryIndex.hh>
 #include <emuframework/OutputTimingManager.hh>
+#include <emuframework/ScreenshotWriter.hh>
 #include <imagine/input/Input.hh>
 #include <imagine/input/android/MogaManager.hh>
 #include <imagine/gui/ViewManager.hh>
@@ -219,6 +223,7 @@ public:
 	static std::unique_ptr<View> makeCustomView(ViewAttachParams attach, ViewID id);
 	bool handleKeyInput(InputAction, const Input::Event &srcEvent);
 	void handleSystemKeyInput(InputAction);
+	void sendInputAction(InputAction);
 	void runTurboInputEvents();
 	void resetInput();
 	void setRunSpeed(double speed);
@@ -236,6 +241,9 @@ public:
 	const Screen &emuScreen() const;
 	Window &emuWindow();
 	AutosaveManager &autosaveManager() { return autosaveManager_; }
+	RewindManager &rewindManager() { return rewindManager_; }
+	LibraryIndex &libraryIndex() { return libraryIndex_; }
+	ScreenshotWriter &screenshotWriter() { return screenshotWriter_; }
 	FrameTimeConfig configFrameTime();
 	void setDisabledInputKeys(std::span<const unsigned> keys);
 	void unsetDisabledInputKeys();
@@ -250,6 +258,8 @@ public:
 	void runFrames(EmuSystemTaskContext, EmuVideo *, EmuAudio *, int frames, bool skipForward);
 	void skipFrames(EmuSystemTaskContext, int frames, EmuAudio *);
 	bool skipForwardFrames(EmuSystemTaskContext, int frames);
+	void runFrameWithRunAhead(EmuSystemTaskContext, EmuVideo *, EmuAudio *);
+	void runFrameWithAdaptiveSkip(EmuSystemTaskContext, EmuVideo *, EmuAudio *);
 	IG::Audio::Manager &audioManager() { return audioManager_; }
 	void renderSystemFramebuffer(EmuVideo &);
 	bool writeScreenshot(IG::PixmapView, CStringView path);
@@ -279,6 +289,7 @@ public:
 	void setIntendedFrameRate(Window &, FrameTimeConfig);
 	static std::u16string_view mainViewName();
 	void runBenchmarkOneShot(EmuVideo &);
+	int runHeadlessBenchmark(IG::ApplicationInitParams, IG::ApplicationContext);
 	void onSelectFileFromPicker(IG::IO, CStringView path, std::string_view displayName,
 		const Input::Event &, EmuSystemCreateParams, ViewAttachParams);
 	void handleOpenFileCommand(CStringView path);
@@ -330,6 +341,8 @@ public:
 	void setCPUAffinity(int cpuNumber, bool on);
 	bool cpuAffinity(int cpuNumber) const;
 	void applyCPUAffinity(bool active);
+	void applyThreadSchedulingPolicy(bool active);
+	std::vector<ThreadId> frameThreadIds();
 
 	// GUI Options
 	auto &pauseUnfocusedOption() { return optionPauseUnfocused; }
@@ -516,6 +529,9 @@ protected:
 	EmuSystemTask emuSystemTask;
 	mutable Gfx::Texture assetBuffImg[wise_enum::size<AssetFileID>];
 	AutosaveManager autosaveManager_;
+	RewindManager rewindManager_;
+	LibraryIndex libraryIndex_;
+	AdaptiveFrameSkip adaptiveFrameSkip;
 public:
 	InputManager inputManager;
 	OutputTimingManager outputTimingManager;
@@ -529,6 +545,7 @@ protected:
 	[[no_unique_address]] IG::VibrationManager vibrationManager_;
 	[[no_unique_address]] PerformanceHintManager perfHintManager;
 	[[no_unique_address]] PerformanceHintSession perfHintSession;
+	ScreenshotWriter screenshotWriter_{*this}; // declared after pixmapWriter so its thread exits first
 	BluetoothAdapter *bta{};
 	IG_UseMemberIf(MOGA_INPUT, std::unique_ptr<Input::MogaManager>, mogaManagerPtr);
 	RecentContentList recentContentList;
@@ -537,6 +554,7 @@ public:
 protected:
 	IG_UseMemberIf(Config::cpuAffinity, CPUMask, cpuAffinityMask){};
 	int savedAdvancedFrames{};
+	std::vector<uint8_t> runAheadState;
 	static constexpr int16_t defaultFastModeSpeed{800};
 	static constexpr int16_t defaultSlowModeSpeed{50};
 	int16_t fastModeSpeed{defaultFastModeSpeed};
@@ -579,12 +597,18 @@ public:
 	IG_UseMemberIf(Config::multipleScreenFrameRates, FrameRate, overrideScreenFrameRate){};
 	WindowFrameTimeSource windowFrameTimeSource{WindowFrameTimeSource::AUTO};
 	IG_UseMemberIf(Config::cpuAffinity, CPUAffinityMode, cpuAffinityMode){CPUAffinityMode::Auto};
+	IG_UseMemberIf(Config::envIsLinux, ThreadSchedulingPolicy, threadSchedulingPolicy){};
+	bool usingRealtimeScheduling{};
 	IG_UseMemberIf(Config::envIsAndroid && Config::DEBUG_BUILD, bool, useNoopThread){};
 	IG_UseMemberIf(enableFrameTimeStats, bool, showFrameTimeStats){};
 	IG_UseMemberIf(Gfx::supportsPresentModes, Gfx::PresentMode, presentMode){};
 	IG_UseMemberIf(Gfx::supportsPresentationTime, bool, usePresentationTime){true};
 	bool allowBlankFrameInsertion{};
 	bool enableBlankFrameInsertion{};
+	bool useFrameDelay{};
+	bool useAdaptiveFrameSkip{};
+	static constexpr uint8_t maxRunAheadFrames{4};
+	uint8_t runAheadFrames{};
 
 protected:
 	struct ConfigParams
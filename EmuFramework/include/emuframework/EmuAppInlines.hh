@@ -65,7 +65,11 @@ namespace IG
 void ApplicationContext::onInit(ApplicationInitParams initParams)
 {
 	auto &app = initApplication<EmuEx::MainApp>(initParams, *this);
+	#ifdef CONFIG_EMUFRAMEWORK_HEADLESS_BENCHMARK
+	exit(app.runHeadlessBenchmark(initParams, *this));
+	#else
 	app.mainInitCommon(initParams, *this);
+	#endif
 }
 
 }
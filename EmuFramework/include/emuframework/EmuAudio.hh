@@ -15,13 +15,16 @@
 	You should have received a copy of the GNU General Public License
 	along with EmuFramework.  If not, see <http://www.gnu.org/licenses/> */
 
+#include <emuframework/AudioResampler.hh>
 #include <imagine/audio/OutputStream.hh>
 #include <imagine/time/Time.hh>
+#include <imagine/thread/Thread.hh>
 #include <imagine/vmem/RingBuffer.hh>
 #include <imagine/util/used.hh>
 #include <imagine/util/bitset.hh>
 #include <imagine/util/enum.hh>
 #include <memory>
+#include <vector>
 #include <atomic>
 
 namespace IG
@@ -44,6 +47,15 @@ enum class AudioFlagsMask: uint8_t
 
 IG_DEFINE_ENUM_BIT_FLAG_FUNCTIONS(AudioFlagsMask);
 
+struct AudioStats
+{
+	Microseconds bufferLatency{};
+	Microseconds deviceLatency{};
+	float rateCorrection{1.f};
+	int underruns{};
+	int overruns{};
+};
+
 class EmuAudio
 {
 public:
@@ -62,6 +74,12 @@ public:
 	void close();
 	void flush();
 	void writeFrames(const void *samples, size_t framesToWrite);
+	// Returns space for up to maxFrames frames in format() for the core to render into, then
+	// commitWrite() adds the frames actually rendered. The space is inside the ring buffer when
+	// the resampling ratio is exactly 1, including while rate control is within its dead band,
+	// so the samples aren't copied again.
+	void *beginWrite(size_t maxFrames);
+	void commitWrite(size_t frames);
 	void setRate(int rate);
 	int rate() const { return rate_; }
 	int maxRate() const { return defaultRate; }
@@ -76,6 +94,15 @@ public:
 	bool isEnabled() const;
 	void setEnabledDuringAltSpeed(bool on);
 	bool isEnabledDuringAltSpeed() const;
+	// the speed, resampler, and rate control settings are applied by the writing thread on its next write
+	void setResamplerQuality(AudioResamplerQuality);
+	AudioResamplerQuality resamplerQuality() const { return requestedQuality.load(std::memory_order_relaxed); }
+	void setDynamicRateControl(bool on);
+	bool dynamicRateControlEnabled() const { return requestedRateControl.load(std::memory_order_relaxed); }
+	AudioStats stats() const;
+	// applied by the output thread on its next callback
+	void setThreadCPUAffinityMask(CPUMask);
+	void setThreadSchedulingPolicy(ThreadSchedulingPolicy);
 	IG::Audio::Format format() const;
 	explicit operator bool() const { return bool(rBuff); }
 	void writeConfig(FileIO &) const;
@@ -85,8 +112,20 @@ protected:
 	IG::Audio::OutputStream audioStream;
 	const IG::Audio::Manager &audioManager;
 	RingBuffer rBuff;
+	std::vector<uint8_t> writeScratch; // used by beginWrite() when samples must be resampled first
+	AudioResampler resampler;
 	SteadyClockTimePoint lastUnderrunTime{};
 	double speedMultiplier{1.};
+	double resampleRatio{1.}; // ratio for the current write, from the speed multiplier and rate correction
+	double smoothedFillFrames{};
+	std::atomic<float> rateCorrection{1.f};
+	std::atomic<double> requestedSpeed{1.};
+	std::atomic<AudioResamplerQuality> requestedQuality{AudioResamplerQuality::sinc};
+	std::atomic_bool requestedRateControl{true};
+	std::atomic_bool rateControlResetRequested{};
+	std::atomic_bool settingsChanged{};
+	std::atomic_int underruns{};
+	std::atomic_int overruns{};
 	size_t targetBufferFillBytes{};
 	size_t bufferIncrementBytes{};
 	int defaultRate;
@@ -94,10 +133,16 @@ protected:
 	float maxVolume_{1.};
 	float currentVolume{1.};
 	std::atomic<AudioWriteState> audioWriteState{AudioWriteState::BUFFER};
+	std::atomic<CPUMask> threadCPUMask{};
+	std::atomic<ThreadSchedulingPolicy> threadPolicy{};
+	std::atomic_bool threadSchedulingChanged{};
+	ThreadSchedulingPolicy appliedThreadPolicy{};
 	int8_t channels{2};
 	AudioFlagsMask flagsMask{AudioFlagsMask::defaultMask};
 	IG_UseMemberIf(IG::Audio::Config::MULTIPLE_SYSTEM_APIS, IG::Audio::Api, audioAPI){};
 	bool addSoundBuffersOnUnderrun{};
+	bool dynamicRateControl{true};
+	bool writingInPlace{};
 public:
 	bool addSoundBuffersOnUnderrunSetting{};
 	int8_t defaultSoundBuffers{3};
@@ -110,6 +155,15 @@ public:
 	void resizeAudioBuffer(size_t targetBufferFillBytes);
 	void updateVolume();
 	void updateAddBuffersOnUnderrun();
+	void updateRateCorrection();
+	void resetRateControl();
+	void applyRequestedSettings();
+	bool needsResampling() const { return resampleRatio != 1.; }
+	void prepareWrite();
+	void updateWriteState();
+	void writePreparedFrames(const void *samples, size_t framesToWrite);
+	void startWritesIfBuffered(size_t bytesWritten);
+	void applyThreadScheduling();
 };
 
 }
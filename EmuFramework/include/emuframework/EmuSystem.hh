@@ -19,15 +19,19 @@
 #include <imagine/base/baseDefs.hh>
 #include <imagine/base/ApplicationContext.hh>
 #include <imagine/time/Time.hh>
+#include <imagine/thread/Thread.hh>
 #include <imagine/audio/SampleFormat.hh>
 #include <imagine/util/rectangle2.h>
 #include <imagine/util/enum.hh>
 #include <imagine/util/bitset.hh>
+#include <imagine/util/memory/UniqueFileDescriptor.hh>
 #include <emuframework/EmuTiming.hh>
 #include <emuframework/VController.hh>
 #include <optional>
 #include <string>
+#include <span>
 #include <string_view>
+#include <vector>
 
 namespace IG
 {
@@ -79,6 +83,16 @@ struct EmuSystemCreateParams
 	uint8_t systemFlags;
 };
 
+struct BenchmarkResults
+{
+	std::vector<SteadyClockTime> frameTimes; // sorted from fastest to slowest
+	SteadyClockTime totalTime{};
+
+	double fps() const { return frameTimes.size() / duration_cast<FloatSeconds>(totalTime).count(); }
+	SteadyClockTime percentile(int p) const;
+	SteadyClockTime max() const { return frameTimes.size() ? frameTimes.back() : SteadyClockTime{}; }
+};
+
 enum class ConfigType : uint8_t
 {
 	MAIN, SESSION, CORE
@@ -87,6 +101,7 @@ enum class ConfigType : uint8_t
 enum class InputActionFlagsMask: uint8_t
 {
 	turbo = bit(0),
+	positionalShift = bit(1), // virtual keyboard shift was active when the action was sent
 };
 
 IG_DEFINE_ENUM_BIT_FLAG_FUNCTIONS(InputActionFlagsMask);
@@ -213,6 +228,9 @@ public:
 	std::string_view stateFilenameExt() const;
 	void loadState(EmuApp &, CStringView uri);
 	void saveState(CStringView path);
+	size_t stateSize();
+	size_t saveState(std::span<uint8_t> buff);
+	void loadState(std::span<const uint8_t> buff);
 	bool readConfig(ConfigType, MapIO &io, unsigned key, size_t readSize);
 	void writeConfig(ConfigType, FileIO &);
 	void reset(EmuApp &, ResetMode mode);
@@ -249,6 +267,8 @@ public:
 	bool shouldFastForward() const;
 	FS::FileString contentDisplayNameForPath(CStringView path) const;
 	IG::Rotation contentRotation() const;
+	// threads other than EmuSystemTask that run emulation work, given the same CPU affinity and scheduling
+	void addThreadGroupIds(std::vector<ThreadId> &) const;
 
 	ApplicationContext appContext() const { return appCtx; }
 	bool isActive() const { return state == State::ACTIVE; }
@@ -348,7 +368,7 @@ public:
 	void configFrameTime(int outputRate, FrameTime outputFrameTime);
 	auto advanceFramesWithTime(SteadyClockTimePoint time) { return emuTiming.advanceFramesWithTime(time); }
 	void setSpeedMultiplier(EmuAudio &, double speed);
-	SteadyClockTime benchmark(EmuVideo &video);
+	BenchmarkResults benchmark(EmuVideo &video, int frames = 180, EmuAudio *audio = {});
 	bool hasContent() const;
 	void resetFrameTime();
 	void pause(EmuApp &);
@@ -356,6 +376,7 @@ public:
 	void closeRuntimeSystem(EmuApp &);
 	static void throwFileReadError();
 	static void throwFileWriteError();
+	static void throwStateBufferSizeError();
 	static void throwMissingContentDirError();
 
 protected:
@@ -375,6 +396,7 @@ protected:
 	FS::FileString contentFileName_; // name + extension of content, inside archive if any
 	FS::FileString contentName_; // name of content from the original location without extension
 	std::string contentDisplayName_; // more descriptive content name set by system
+	mutable IG::UniqueFileDescriptor scratchStateFd; // memory file backing scratchStatePath(), if supported
 	FS::PathString contentSaveDirectory_;
 	FS::PathString userSaveDirectory_;
 
@@ -382,6 +404,11 @@ protected:
 	void setupContentFilePaths(CStringView filePath, std::string_view displayName);
 	void updateContentSaveDirectory();
 	void closeAndSetupNew(CStringView path, std::string_view displayName);
+	// helpers for systems that can only save/load states via a file path,
+	// backed by a memory file where supported so no storage I/O occurs
+	FS::PathString scratchStatePath() const;
+	size_t readScratchState(std::span<uint8_t> buff) const;
+	FS::PathString writeScratchState(std::span<const uint8_t> buff) const;
 
 public:
 	IG::OnFrameDelegate onFrameUpdate;
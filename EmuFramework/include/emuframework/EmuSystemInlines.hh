@@ -209,6 +209,21 @@ void EmuSystem::saveState(CStringView uri)
 	static_cast<MainSystem*>(this)->saveState(uri);
 }
 
+size_t EmuSystem::stateSize()
+{
+	return static_cast<MainSystem*>(this)->stateSize();
+}
+
+size_t EmuSystem::saveState(std::span<uint8_t> buff)
+{
+	return static_cast<MainSystem*>(this)->saveState(buff);
+}
+
+void EmuSystem::loadState(std::span<const uint8_t> buff)
+{
+	static_cast<MainSystem*>(this)->loadState(buff);
+}
+
 void EmuSystem::clearInputBuffers(EmuInputView &view)
 {
 	static_cast<MainSystem*>(this)->clearInputBuffers(view);
@@ -258,6 +273,12 @@ IG::Rotation EmuSystem::contentRotation() const
 	return {};
 }
 
+void EmuSystem::addThreadGroupIds(std::vector<ThreadId> &ids) const
+{
+	if(&MainSystem::addThreadGroupIds != &EmuSystem::addThreadGroupIds)
+		static_cast<const MainSystem*>(this)->addThreadGroupIds(ids);
+}
+
 void EmuSystem::onStart()
 {
 	if(&MainSystem::onStart != &EmuSystem::onStart)
@@ -15,9 +15,15 @@
 	You should have received a copy of the GNU General Public License
 	along with EmuFramework.  If not, see <http://www.gnu.org/licenses/> */
 
+#include <emuframework/EmuSystem.hh>
+#include <emuframework/FrameDelay.hh>
 #include <imagine/base/MessagePort.hh>
 #include <imagine/thread/Thread.hh>
+#include <imagine/thread/SPSCQueue.hh>
+#include <imagine/time/Time.hh>
+#include <span>
 #include <variant>
+#include <vector>
 
 namespace EmuEx
 {
@@ -36,6 +42,7 @@ public:
 		UNSET,
 		RUN_FRAME,
 		PAUSE,
+		APPLY_INPUT,
 		EXIT,
 	};
 
@@ -43,39 +50,67 @@ public:
 	{
 		EmuVideo *video{};
 		EmuAudio *audio{};
+		SteadyClockTimePoint deadline{}; // when set, emulation may be delayed to finish just before this time
+		SteadyClockTime frameTime{};
 		int8_t frames{};
 		bool skipForward{};
 		bool fastForward{};
 	};
 
 	struct PauseCommand {};
+	struct ApplyInputCommand {};
 	struct ExitCommand {};
 
-	using CommandVariant = std::variant<RunFrameCommand, PauseCommand, ExitCommand>;
+	using CommandVariant = std::variant<RunFrameCommand, PauseCommand, ApplyInputCommand, ExitCommand>;
 
 	struct CommandMessage
 	{
 		std::binary_semaphore *semPtr{};
 		CommandVariant command{RunFrameCommand{}};
+		SteadyClockTimePoint sendTime{SteadyClock::now()};
 
 		void setReplySemaphore(std::binary_semaphore *semPtr_) { assert(!semPtr); semPtr = semPtr_; };
 	};
 
+	struct InputRecord
+	{
+		uint64_t frame;
+		InputAction action;
+	};
+
 	EmuSystemTask(EmuApp &);
 	void start();
 	void pause();
 	void stop();
-	void runFrame(EmuVideo *, EmuAudio *, int8_t frames, bool skipForward, bool fastForward);
+	void runFrame(EmuVideo *, EmuAudio *, int8_t frames, bool skipForward, bool fastForward,
+		SteadyClockTimePoint deadline = {}, SteadyClockTime frameTime = {});
+	void sendInputAction(InputAction);
+	void setInputRecording(bool on);
+	std::span<const InputRecord> inputRecords() const { return inputLog; }
+	uint64_t frameIndex() const { return frameIndex_; }
+	SteadyClockTime commandLatency() const { return commandLatency_.load(std::memory_order_relaxed); }
+	SteadyClockTime commandJitter() const { return commandJitter_.load(std::memory_order_relaxed); }
 	void sendVideoFormatChangedReply(EmuVideo &);
 	void sendFrameFinishedReply(EmuVideo &);
-	void sendScreenshotReply(bool success);
 	auto threadId() const { return threadId_; }
 
 private:
 	EmuApp &app;
-	MessagePort<CommandMessage> commandPort{"EmuSystemTask Command"};
+	SPSCMessagePort<CommandMessage> commandPort{"EmuSystemTask Command"};
+	SPSCQueue<InputAction, 256> inputQueue;
+	std::vector<InputRecord> inputLog;
+	uint64_t frameIndex_{};
+	std::atomic<SteadyClockTime> commandLatency_{};
+	std::atomic<SteadyClockTime> commandJitter_{};
+	FrameDelay frameDelay;
 	std::thread taskThread;
 	ThreadId threadId_{};
+	bool recordInput{};
+
+	void applyQueuedInput();
+	void applyInput(InputAction);
+	void updateCommandLatency(SteadyClockTime);
+	void waitForFrameStart(SteadyClockTimePoint deadline, SteadyClockTime frameTime);
 };
 
 }
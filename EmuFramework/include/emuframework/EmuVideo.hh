@@ -20,7 +20,9 @@
 #include <emuframework/EmuSystemTaskContext.hh>
 #include <imagine/gfx/PixmapBufferTexture.hh>
 #include <imagine/gfx/SyncFence.hh>
+#include <atomic>
 #include <optional>
+#include <vector>
 
 namespace EmuEx
 {
@@ -53,6 +55,7 @@ public:
 	constexpr EmuVideo() = default;
 	void setRendererTask(Gfx::RendererTask &);
 	bool hasRendererTask() const;
+	void setNullSink(EmuSystem &, IG::PixelFormat);
 	bool setFormat(IG::PixmapDesc desc, EmuSystemTaskContext task = {});
 	void dispatchFormatChanged();
 	void resetImage(IG::PixelFormat newFmt = {});
@@ -69,6 +72,7 @@ public:
 	bool addFence(Gfx::RendererCommands &cmds);
 	void clear();
 	void takeGameScreenshot();
+	bool toggleScreenshotBurst();
 	bool isExternalTexture() const;
 	Gfx::PixmapBufferTexture &image();
 	Gfx::Renderer &renderer() const;
@@ -92,17 +96,21 @@ protected:
 	Gfx::RendererTask *rTask{};
 	Gfx::SyncFence fence;
 	Gfx::PixmapBufferTexture vidImg;
+	std::vector<uint8_t> nullSinkBuff;
+	IG::PixmapDesc nullSinkDesc;
 	FrameFinishedDelegate onFrameFinished;
 	FormatChangedDelegate onFormatChanged;
 	IG::PixelFormat renderFmt;
 	Gfx::TextureBufferMode bufferMode{};
 	bool screenshotNextFrame{};
+	std::atomic_bool screenshotBurst{};
 	bool singleBuffer{};
 	bool needsFence{};
 	Gfx::ColorSpace colSpace{Gfx::ColorSpace::LINEAR};
 	bool useLinearFilter{true};
 
-	void doScreenshot(EmuSystemTaskContext, IG::PixmapView pix);
+	bool needsScreenshot() const;
+	void doScreenshot(IG::PixmapView pix);
 	void postFrameFinished(EmuSystemTaskContext);
 	void syncImageAccess();
 	Gfx::TextureSamplerConfig samplerConfig() const { return samplerConfigForLinearFilter(useLinearFilter); }
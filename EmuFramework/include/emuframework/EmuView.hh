@@ -28,6 +28,8 @@ class EmuInputView;
 class EmuVideoLayer;
 class EmuSystem;
 struct FrameTimeStats;
+struct AudioStats;
+struct FrameSkipStats;
 
 class EmuView : public View
 {
@@ -41,9 +43,7 @@ public:
 	bool inputEvent(const Input::Event &) final;
 	bool hasLayer() const { return layer; }
 	void setLayoutInputView(EmuInputView *view) { inputView = view; }
-	void updateFrameTimeStats(FrameTimeStats, SteadyClockTimePoint currentFrameTimestamp);
-	void updateAudioStats(int underruns, int overruns, int callbacks, double avgCallbackFrames, int frames);
-	void clearAudioStats();
+	void updateFrameTimeStats(FrameTimeStats, AudioStats, FrameSkipStats, SteadyClockTimePoint currentFrameTimestamp);
 	EmuVideoLayer *videoLayer() const { return layer; }
 	EmuSystem &system() { return *sysPtr; }
 
@@ -57,10 +57,6 @@ private:
 		WRect rect{};
 	};
 	IG_UseMemberIf(enableFrameTimeStats, FrameTimeStatsUI, frameTimeStats);
-	#ifdef CONFIG_EMUFRAMEWORK_AUDIO_STATS
-	Gfx::Text audioStatsText{};
-	WRect audioStatsRect{};
-	#endif
 
 	void placeFrameTimeStats();
 };
@@ -0,0 +1,51 @@
+#pragma once
+
+/*  This file is part of EmuFramework.
+
+	Imagine is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Imagine is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with EmuFramework.  If not, see <http://www.gnu.org/licenses/> */
+
+#include <imagine/time/Time.hh>
+#include <array>
+
+namespace EmuEx
+{
+
+using namespace IG;
+
+// Schedules the start of emulation as late as possible before a frame's present deadline so
+// input is sampled closer to when the frame is shown. The start is based on the longest of the
+// recent emulation times plus a margin for drawing, and the margin grows after an overrun.
+class FrameDelay
+{
+public:
+	static constexpr size_t historySize = 32;
+
+	// time to start emulating a frame that must be done by deadline, or an empty time point to start now
+	SteadyClockTimePoint startTime(SteadyClockTimePoint deadline, SteadyClockTime frameTime) const;
+	void addFrame(SteadyClockTime emulationTime, SteadyClockTimePoint endTime, SteadyClockTimePoint deadline);
+	void reset();
+	SteadyClockTime margin() const { return margin_; }
+
+private:
+	std::array<SteadyClockTime, historySize> emulationTimes{};
+	SteadyClockTime maxEmulationTime{};
+	SteadyClockTime margin_{initialMargin};
+	size_t nextIdx{};
+	size_t frames{};
+
+	static constexpr SteadyClockTime initialMargin{Milliseconds{4}};
+	static constexpr SteadyClockTime minMargin{Milliseconds{2}};
+};
+
+}
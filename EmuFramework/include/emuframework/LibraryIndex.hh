@@ -0,0 +1,146 @@
+#pragma once
+
+/*  This file is part of EmuFramework.
+
+	Imagine is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Imagine is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with EmuFramework.  If not, see <http://www.gnu.org/licenses/> */
+
+#include <emuframework/ContentHash.hh>
+#include <imagine/base/ApplicationContext.hh>
+#include <imagine/base/CustomEvent.hh>
+#include <imagine/fs/FSDefs.hh>
+#include <imagine/util/DelegateFunc.hh>
+#include <imagine/util/memory/UniqueFileDescriptor.hh>
+#include <imagine/util/string/CStringView.hh>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace IG
+{
+class MapIO;
+class FileIO;
+}
+
+namespace EmuEx
+{
+
+using namespace IG;
+
+struct LibraryEntry
+{
+	std::string path; // file path or URI
+	std::string name;
+	std::string archiveEntry; // for archives, the name of the content file that would be loaded from it
+	uint64_t size{}; // size of the content, unknown (0) for URIs
+	int64_t lastWriteTime{}; // seconds since the epoch
+	ContentDigest digest{};
+	bool hasDigest{};
+
+	bool isArchive() const { return archiveEntry.size(); }
+};
+
+// Immutable view of the index the UI reads without locking, replaced as a whole after each scan
+struct LibrarySnapshot
+{
+	std::vector<LibraryEntry> entries; // sorted by name
+	std::vector<uint32_t> recentIdxs; // entry indices, most recently modified first
+};
+
+// Walks the library directories on a low priority thread, keeping the name, size, modification time,
+// archive contents, and content digest of each file that passes the name filter. The index is saved
+// to disk and later scans only re-list directories whose modification time changed. On Linux, inotify
+// watches on the scanned directories trigger rescans of just the changed ones.
+class LibraryIndex
+{
+public:
+	using NameFilterFunc = bool(*)(std::string_view name);
+	// files larger than this are indexed without a digest
+	static constexpr uint64_t maxDigestSize = 32 * 1024 * 1024;
+	static constexpr int maxDepth = 8;
+
+	LibraryIndex(ApplicationContext);
+	~LibraryIndex();
+	void setCachePath(CStringView path);
+	void setNameFilter(NameFilterFunc);
+	void setOnUpdate(DelegateFunc<void()>);
+	std::vector<std::string> directories() const;
+	bool addDirectory(std::string_view path);
+	bool removeDirectory(std::string_view path);
+	void start();
+	void rescan();
+	void stop();
+	bool isRunning() const { return thread.joinable(); }
+	std::shared_ptr<const LibrarySnapshot> snapshot() const;
+	bool isScanning() const { return scanning.load(std::memory_order_relaxed); }
+	bool hasChangeNotifications() const;
+	bool readConfig(MapIO &, unsigned key, size_t size);
+	void writeConfig(FileIO &) const;
+
+private:
+	struct Directory
+	{
+		int64_t lastWriteTime{};
+		std::vector<std::string> subdirs;
+		std::vector<LibraryEntry> entries; // sorted by path
+		int watch{-1};
+		uint8_t depth{};
+	};
+
+	ApplicationContext ctx;
+	std::vector<std::string> directories_;
+	FS::PathString cachePath;
+	NameFilterFunc nameFilter{};
+	DelegateFunc<void()> onUpdate;
+	// only accessed by the worker thread while it runs
+	std::unordered_map<std::string, Directory> dirs;
+	std::vector<std::string> changedDirs;
+	#ifdef __linux__
+	UniqueFileDescriptor notifyFd;
+	UniqueFileDescriptor wakeFd;
+	std::unordered_map<int, std::string> watchPaths;
+	#else
+	std::condition_variable wakeCondition;
+	#endif
+	std::shared_ptr<const LibrarySnapshot> snapshot_;
+	mutable std::mutex mutex; // guards directories_ and snapshot_
+	CustomEvent onUpdateEvent{"LibraryIndex::onUpdateEvent"};
+	std::thread thread;
+	std::atomic_bool stopRequested{};
+	std::atomic_bool rescanRequested{};
+	std::atomic_bool scanning{};
+
+	void run();
+	bool scanDirectory(const std::string &path, int depth, bool recurseKnownDirs);
+	bool needsScan(const std::string &path) const;
+	bool updateFile(const std::string &path, std::string_view name, std::vector<LibraryEntry> &entries,
+		const Directory *prevDir);
+	bool addDigests();
+	void publish();
+	bool pruneDirectories(const std::vector<std::string> &roots);
+	void watchDirectory(const std::string &path, Directory &);
+	void unwatchDirectory(const std::string &path, Directory &);
+	bool waitForChanges();
+	void wake();
+	bool readIndex();
+	void writeIndex() const;
+	bool stopping() const { return stopRequested.load(std::memory_order_relaxed); }
+};
+
+}
@@ -48,6 +48,7 @@ protected:
 	TextMenuItem loadGame;
 	TextMenuItem systemActions;
 	TextMenuItem recentGames;
+	TextMenuItem library;
 	TextMenuItem bundledGames;
 	TextMenuItem options;
 	TextMenuItem onScreenInputManager;
@@ -34,6 +34,8 @@ enum class FrameTimeStatEvent
 	startOfDraw,
 	aboutToPresent,
 	endOfDraw,
+	startOfRunAhead,
+	endOfRunAhead,
 };
 
 struct FrameTimeStats
@@ -45,6 +47,10 @@ struct FrameTimeStats
 	SteadyClockTimePoint startOfDraw{};
 	SteadyClockTimePoint aboutToPresent{};
 	SteadyClockTimePoint endOfDraw{};
+	SteadyClockTimePoint startOfRunAhead{};
+	SteadyClockTimePoint endOfRunAhead{};
+	SteadyClockTime commandLatency{};
+	SteadyClockTime commandJitter{};
 	int missedFrameCallbacks{};
 };
 
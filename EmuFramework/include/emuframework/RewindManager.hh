@@ -0,0 +1,107 @@
+#pragma once
+
+/*  This file is part of EmuFramework.
+
+	Imagine is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Imagine is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with EmuFramework.  If not, see <http://www.gnu.org/licenses/> */
+
+#include <emuframework/config.hh>
+#include <imagine/time/Time.hh>
+#include <atomic>
+#include <deque>
+#include <vector>
+#include <span>
+#include <cstdint>
+
+namespace IG
+{
+class MapIO;
+class FileIO;
+}
+
+namespace EmuEx
+{
+
+using namespace IG;
+
+class EmuSystem;
+
+// Captures a state snapshot every snapshotInterval frames into a fixed size ring buffer,
+// each one stored as a run-length encoded XOR delta against the previous snapshot.
+// Rewinding undoes the newest delta to recover the prior snapshot and loads it.
+// All capture and restore functions must be called from the emulation thread.
+class RewindManager
+{
+public:
+	struct Stats
+	{
+		size_t snapshots{};
+		size_t usedBytes{};
+		size_t lastSnapshotBytes{};
+		size_t stateBytes{};
+		SteadyClockTime lastCaptureTime{};
+		SteadyClockTime lastRestoreTime{};
+	};
+
+	static constexpr uint16_t defaultMaxMemoryMiB = 0;
+	static constexpr uint8_t defaultSnapshotInterval = 2;
+
+	RewindManager() = default;
+	void onFramesRun(EmuSystem &, int frames);
+	bool rewindFrame(EmuSystem &);
+	void reset();
+	void setRewinding(bool on);
+	bool isRewinding() const { return rewinding.load(std::memory_order_relaxed); }
+	bool isEnabled() const { return maxMemoryMiB; }
+	void setMaxMemory(uint16_t mib);
+	uint16_t maxMemory() const { return maxMemoryMiB; }
+	void setSnapshotInterval(uint8_t frames);
+	uint8_t snapshotInterval() const { return snapshotInterval_; }
+	const Stats &stats() const { return stats_; }
+	bool readConfig(MapIO &, unsigned key, size_t size);
+	void writeConfig(FileIO &) const;
+
+private:
+	struct Entry
+	{
+		size_t offset;
+		uint32_t size;
+		uint32_t stateSize;
+	};
+
+	using Word = uint64_t;
+
+	std::vector<uint8_t> ring;
+	std::vector<Word> prevState; // newest snapshot, or all zeros when no entries exist
+	std::vector<Word> currState;
+	std::vector<uint8_t> deltaBuff;
+	std::deque<Entry> entries;
+	size_t writeOffset{};
+	size_t stateSizeHint{};
+	Stats stats_;
+	int framesSinceSnapshot{};
+	uint16_t maxMemoryMiB{defaultMaxMemoryMiB};
+	uint8_t snapshotInterval_{defaultSnapshotInterval};
+	bool inRewind{};
+	std::atomic_bool rewinding{};
+
+	void capture(EmuSystem &);
+	void resizeStateBuffers(size_t stateSize);
+	size_t saveStateToBuffer(EmuSystem &);
+	uint8_t *allocEntry(size_t size);
+	void updateUsage();
+	static size_t encodeDelta(std::span<const Word> curr, std::span<const Word> prev, uint8_t *out);
+	static void applyDelta(std::span<Word> state, const uint8_t *delta, size_t deltaSize);
+};
+
+}
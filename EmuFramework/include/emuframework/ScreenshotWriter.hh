@@ -0,0 +1,90 @@
+#pragma once
+
+/*  This file is part of EmuFramework.
+
+	Imagine is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Imagine is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with EmuFramework.  If not, see <http://www.gnu.org/licenses/> */
+
+#include <emuframework/config.hh>
+#include <imagine/pixmap/MemPixmap.hh>
+#include <imagine/fs/FSDefs.hh>
+#include <imagine/thread/SPSCQueue.hh>
+#include <array>
+#include <atomic>
+#include <semaphore>
+#include <thread>
+
+namespace EmuEx
+{
+
+using namespace IG;
+
+class EmuApp;
+
+// Copies frames into a pool of buffers and encodes them on a background thread so
+// taking screenshots never blocks the emulation thread. Frames are dropped if every
+// buffer is still waiting to be written. In burst mode every frame is captured
+// until the burst ends, then a single summary message is posted. Burst file names
+// are built on the writer thread from the frame's index within the burst.
+// capture() and the burst functions must be called from one thread at a time.
+class ScreenshotWriter
+{
+public:
+	static constexpr size_t poolSize = 8;
+
+	ScreenshotWriter(EmuApp &app): app{app} {}
+	~ScreenshotWriter();
+	bool capture(PixmapView, const FS::PathString &path = {});
+	void beginBurst();
+	void endBurst();
+	bool inBurst() const { return inBurst_; }
+	int burstFrames() const { return burstFrames_; }
+
+private:
+	struct Job
+	{
+		MemPixmap pix;
+		FS::PathString path;
+		uint32_t burstId{}; // 0 if not part of a burst
+		int burstFrame{};
+	};
+
+	struct BurstResult
+	{
+		int written, failed, dropped;
+	};
+
+	EmuApp &app;
+	std::array<Job, poolSize> jobs;
+	SPSCQueue<uint8_t, poolSize> freeJobs; // writer thread -> capturing thread
+	SPSCQueue<uint8_t, poolSize> queuedJobs; // capturing thread -> writer thread
+	std::counting_semaphore<> workSem{0};
+	std::thread thread;
+	std::atomic_int burstWritten{};
+	std::atomic_int burstFailed{};
+	std::atomic_int burstDropped{};
+	std::atomic_bool burstEnded{};
+	std::atomic_bool quit{};
+	FS::PathString burstBasePath; // writer thread only
+	uint32_t burstBaseId{}; // writer thread only
+	uint32_t burstId{};
+	int burstFrames_{};
+	bool inBurst_{};
+
+	void start();
+	void run();
+	void postResult(bool success);
+	FS::PathString burstPath(const Job &);
+};
+
+}
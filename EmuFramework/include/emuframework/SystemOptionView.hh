@@ -42,6 +42,13 @@ protected:
 	MultiChoiceMenuItem fastModeSpeed;
 	TextMenuItem slowModeSpeedItem[3];
 	MultiChoiceMenuItem slowModeSpeed;
+	TextMenuItem rewindMemoryItem[5];
+	MultiChoiceMenuItem rewindMemory;
+	TextMenuItem rewindIntervalItem[4];
+	MultiChoiceMenuItem rewindInterval;
+	TextMenuItem rewindStats;
+	TextMenuItem runAheadItem[5];
+	MultiChoiceMenuItem runAhead;
 	IG_UseMemberIf(Config::envIsAndroid, BoolMenuItem, performanceMode);
 	IG_UseMemberIf(Config::envIsAndroid && Config::DEBUG_BUILD, BoolMenuItem, noopThread);
 	IG_UseMemberIf(Config::cpuAffinity, TextMenuItem, cpuAffinity);
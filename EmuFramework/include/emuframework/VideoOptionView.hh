@@ -83,6 +83,8 @@ protected:
 	IG_UseMemberIf(Config::multipleScreenFrameRates, std::vector<TextMenuItem>, screenFrameRateItems);
 	IG_UseMemberIf(Config::multipleScreenFrameRates, MultiChoiceMenuItem, screenFrameRate);
 	IG_UseMemberIf(Gfx::supportsPresentationTime, BoolMenuItem, presentationTime);
+	BoolMenuItem frameDelay;
+	BoolMenuItem adaptiveFrameSkip;
 	BoolMenuItem blankFrameInsertion;
 	TextMenuItem brightnessItem[2];
 	TextMenuItem redItem[2];
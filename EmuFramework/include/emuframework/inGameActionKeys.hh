@@ -21,7 +21,7 @@
 namespace EmuEx::Controls
 {
 
-inline constexpr std::array<const std::string_view, 14> gameActionName
+inline constexpr std::array<const std::string_view, 16> gameActionName
 {
 	"Load Game",
 	"Open System Actions",
@@ -37,6 +37,8 @@ inline constexpr std::array<const std::string_view, 14> gameActionName
 	"Exit App",
 	"Slow-motion",
 	"Toggle Slow-motion",
+	"Rewind",
+	"Toggle Screenshot Burst",
 };
 
 constexpr auto gameActionKeys = gameActionName.size();
@@ -49,7 +51,7 @@ using GameActionKeyArray = std::array<unsigned, gameActionKeys>;
 {"Set In-Emulation Actions", gameActionName, 0}
 
 #define EMU_CONTROLS_IN_GAME_ACTIONS_UNBINDED_PROFILE_INIT \
-0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
 
 #define EMU_CONTROLS_IN_GAME_ACTIONS_ICP_NUBS_PROFILE_INIT \
 Input::iControlPad::RNUB_DOWN, \
@@ -61,7 +63,7 @@ Input::iControlPad::RNUB_UP, \
 Input::iControlPad::LNUB_UP, \
 0, \
 0, \
-0, 0, 0, 0, 0
+0, 0, 0, 0, 0, 0, 0
 
 #define EMU_CONTROLS_IN_GAME_ACTIONS_ICADE_PROFILE_INIT \
 0, \
@@ -73,7 +75,7 @@ Input::ICade::Z, \
 0, \
 0, \
 0, \
-0, 0, 0, 0, 0
+0, 0, 0, 0, 0, 0, 0
 
 #define EMU_CONTROLS_IN_GAME_ACTIONS_WIIMOTE_PROFILE_INIT \
 0, \
@@ -85,7 +87,7 @@ Input::Wiimote::HOME, \
 0, \
 0, \
 0, \
-0, 0, 0, 0, 0
+0, 0, 0, 0, 0, 0, 0
 
 #define EMU_CONTROLS_IN_GAME_ACTIONS_WII_CC_PROFILE_INIT \
 0, \
@@ -97,7 +99,7 @@ Input::WiiCC::HOME, \
 Input::WiiCC::ZR, \
 0, \
 0, \
-0, 0, 0, 0, 0
+0, 0, 0, 0, 0, 0, 0
 
 #define EMU_CONTROLS_IN_GAME_ACTIONS_ANDROID_NAV_PROFILE_INIT \
 0, \
@@ -109,7 +111,7 @@ Input::Keycode::MENU, \
 Input::Keycode::SEARCH, \
 0, \
 Input::Keycode::BACK, \
-0, 0, 0, 0, 0
+0, 0, 0, 0, 0, 0, 0
 
 #define EMU_CONTROLS_IN_GAME_ACTIONS_ANDROID_GENERIC_GAMEPAD_PROFILE_INIT \
 0, \
@@ -121,7 +123,7 @@ Input::Keycode::JS2_YAXIS_NEG, \
 Input::Keycode::JS_RTRIGGER_AXIS, \
 0, \
 0, \
-0, 0, 0, 0, 0
+0, 0, 0, 0, 0, 0, 0
 
 #define EMU_CONTROLS_IN_GAME_ACTIONS_OUYA_PROFILE_INIT \
 0, \
@@ -133,7 +135,7 @@ Input::Keycode::MENU, \
 Input::Keycode::Ouya::R2, \
 0, \
 0, \
-0, 0, 0, 0, 0
+0, 0, 0, 0, 0, 0, 0
 
 #define EMU_CONTROLS_IN_GAME_ACTIONS_OUYA_MINIMAL_PROFILE_INIT \
 0, \
@@ -145,7 +147,7 @@ Input::Keycode::MENU, \
 0, \
 0, \
 0, \
-0, 0, 0, 0, 0
+0, 0, 0, 0, 0, 0, 0
 
 #define EMU_CONTROLS_IN_GAME_ACTIONS_NVIDIA_SHIELD_PROFILE_INIT \
 0, \
@@ -157,7 +159,7 @@ Input::Keycode::MENU, \
 Input::Keycode::JS_RTRIGGER_AXIS, \
 0, \
 Input::Keycode::BACK, \
-0, 0, 0, 0, 0
+0, 0, 0, 0, 0, 0, 0
 
 #define EMU_CONTROLS_IN_GAME_ACTIONS_NVIDIA_SHIELD_MINIMAL_PROFILE_INIT \
 0, \
@@ -169,7 +171,7 @@ Input::Keycode::BACK, \
 Input::Keycode::JS_RTRIGGER_AXIS, \
 0, \
 Input::Keycode::BACK, \
-0, 0, 0, 0, 0
+0, 0, 0, 0, 0, 0, 0
 
 #define EMU_CONTROLS_IN_GAME_ACTIONS_ANDROID_PS3_GAMEPAD_PROFILE_INIT \
 0, \
@@ -181,7 +183,7 @@ Input::Keycode::GAME_1, \
 Input::Keycode::GAME_R2, \
 0, \
 0, \
-0, 0, 0, 0, 0
+0, 0, 0, 0, 0, 0, 0
 
 #define EMU_CONTROLS_IN_GAME_ACTIONS_ANDROID_PS3_GAMEPAD_MINIMAL_PROFILE_INIT \
 0, \
@@ -193,7 +195,7 @@ Input::Keycode::GAME_1, \
 0, \
 0, \
 0, \
-0, 0, 0, 0, 0
+0, 0, 0, 0, 0, 0, 0
 
 #define EMU_CONTROLS_IN_GAME_ACTIONS_GENERIC_KB_PROFILE_INIT \
 Input::Keycode::F2, \
@@ -205,7 +207,7 @@ Input::Keycode::RIGHT_BRACKET, \
 Input::Keycode::GRAVE, \
 0, \
 Input::Keycode::BACK_KEY, \
-0, 0, 0, 0, 0
+0, 0, 0, 0, 0, 0, 0
 
 #define EMU_CONTROLS_IN_GAME_ACTIONS_GENERIC_KB_ALT_PROFILE_INIT \
 Input::Keycode::F10, \
@@ -217,7 +219,7 @@ Input::Keycode::RIGHT_BRACKET, \
 Input::Keycode::GRAVE, \
 0, \
 Input::Keycode::BACK_KEY, \
-0, 0, 0, 0, 0
+0, 0, 0, 0, 0, 0, 0
 
 #define EMU_CONTROLS_IN_GAME_ACTIONS_GENERIC_KB_ALT2_PROFILE_INIT \
 0, \
@@ -229,7 +231,7 @@ Input::Keycode::F12, \
 Input::Keycode::GRAVE, \
 0, \
 Input::Keycode::BACK_KEY, \
-0, 0, 0, 0, 0
+0, 0, 0, 0, 0, 0, 0
 
 #ifdef __ANDROID__
 #define EMU_CONTROLS_IN_GAME_ACTIONS_GENERIC_KB_MINIMAL_PROFILE_INIT \
@@ -242,7 +244,7 @@ Input::Keycode::MENU, \
 Input::Keycode::SEARCH, \
 0, \
 0, \
-0, 0, 0, 0, 0
+0, 0, 0, 0, 0, 0, 0
 #else
 #define EMU_CONTROLS_IN_GAME_ACTIONS_GENERIC_KB_MINIMAL_PROFILE_INIT \
 0, \
@@ -254,7 +256,7 @@ Input::Keycode::MENU, \
 Input::Keycode::F11, \
 0, \
 0, \
-0, 0, 0, 0, 0
+0, 0, 0, 0, 0, 0, 0
 #endif
 
 #define PS3PAD_OPEN_MENU_KEY Input::PS3::PS
@@ -269,7 +271,7 @@ Input::Keycode::F11, \
 	Input::PS3::R2, \
 	0, \
 	0, \
-	0, 0, 0, 0, 0
+	0, 0, 0, 0, 0, 0, 0
 
 #define EMU_CONTROLS_IN_GAME_ACTIONS_GENERIC_PS3PAD_ALT_MINIMAL_PROFILE_INIT \
 	0, \
@@ -281,7 +283,7 @@ Input::Keycode::F11, \
 	0, \
 	0, \
 	0, \
-	0, 0, 0, 0, 0
+	0, 0, 0, 0, 0, 0, 0
 
 #define EMU_CONTROLS_IN_GAME_ACTIONS_PANDORA_PROFILE_INIT \
 	Input::Keycode::L, \
@@ -293,7 +295,7 @@ Input::Keycode::F11, \
 	Input::Keycode::Pandora::R, \
 	0, \
 	Input::Keycode::BACK_SPACE, \
-	0, 0, 0, 0, 0
+	0, 0, 0, 0, 0, 0, 0
 
 #define EMU_CONTROLS_IN_GAME_ACTIONS_PANDORA_ALT_PROFILE_INIT \
 	Input::Keycode::L, \
@@ -305,7 +307,7 @@ Input::Keycode::F11, \
 	Input::Keycode::_0, \
 	0, \
 	Input::Keycode::BACK_SPACE, \
-	0, 0, 0, 0, 0
+	0, 0, 0, 0, 0, 0, 0
 
 #define EMU_CONTROLS_IN_GAME_ACTIONS_PANDORA_ALT_MINIMAL_PROFILE_INIT \
 	0, \
@@ -317,7 +319,7 @@ Input::Keycode::F11, \
 	Input::Keycode::Pandora::R, \
 	0, \
 	0, \
-	0, 0, 0, 0, 0
+	0, 0, 0, 0, 0, 0, 0
 
 #define EMU_CONTROLS_IN_GAME_ACTIONS_APPLEGC_PROFILE_INIT \
 	0, \
@@ -329,7 +331,7 @@ Input::Keycode::F11, \
 	Input::AppleGC::R2, \
 	0, \
 	0, \
-	0, 0, 0, 0, 0
+	0, 0, 0, 0, 0, 0, 0
 
 #define EMU_CONTROLS_IN_GAME_ACTIONS_APPLEGC_MINIMAL_PROFILE_INIT \
 	0, \
@@ -341,7 +343,7 @@ Input::Keycode::F11, \
 	0, \
 	0, \
 	0, \
-	0, 0, 0, 0, 0
+	0, 0, 0, 0, 0, 0, 0
 
 #define EMU_CONTROLS_IN_GAME_ACTIONS_8BITDO_SF30_PRO_PROFILE_INIT \
 0, \
@@ -353,7 +355,7 @@ Input::Keycode::JS2_YAXIS_NEG, \
 Input::Keycode::GAME_R2, \
 0, \
 Input::Keycode::GAME_L2, \
-0, 0, 0, 0, 0
+0, 0, 0, 0, 0, 0, 0
 
 #define EMU_CONTROLS_IN_GAME_ACTIONS_8BITDO_SF30_PRO_MINIMAL_PROFILE_INIT \
 0, \
@@ -365,7 +367,7 @@ Input::Keycode::JS2_YAXIS_NEG, \
 Input::Keycode::GAME_R2, \
 0, \
 Input::Keycode::GAME_L2, \
-0, 0, 0, 0, 0
+0, 0, 0, 0, 0, 0, 0
 
 #define EMU_CONTROLS_IN_GAME_ACTIONS_8BITDO_SN30_PRO_PLUS_PROFILE_INIT \
 0, \
@@ -377,7 +379,7 @@ Input::Keycode::JS2_YAXIS_NEG, \
 Input::Keycode::GAME_R2, \
 0, \
 Input::Keycode::GAME_L2, \
-0, 0, 0, 0, 0
+0, 0, 0, 0, 0, 0, 0
 
 #define EMU_CONTROLS_IN_GAME_ACTIONS_8BITDO_SN30_PRO_PLUS_MINIMAL_PROFILE_INIT \
 0, \
@@ -389,7 +391,7 @@ Input::Keycode::JS2_YAXIS_NEG, \
 Input::Keycode::GAME_R2, \
 0, \
 Input::Keycode::GAME_L2, \
-0, 0, 0, 0, 0
+0, 0, 0, 0, 0, 0, 0
 
 #define EMU_CONTROLS_IN_GAME_ACTIONS_8BITDO_M30_GAMEPAD_PROFILE_INIT \
 0, \
@@ -401,7 +403,7 @@ Input::Keycode::JS2_YAXIS_NEG, \
 Input::Keycode::GAME_R2, \
 0, \
 Input::Keycode::GAME_L2, \
-0, 0, 0, 0, 0
+0, 0, 0, 0, 0, 0, 0
 
 #define EMU_CONTROLS_IN_GAME_ACTIONS_8BITDO_M30_GAMEPAD_MINIMAL_PROFILE_INIT \
 0, \
@@ -413,4 +415,4 @@ Input::Keycode::JS2_YAXIS_NEG, \
 Input::Keycode::GAME_R2, \
 0, \
 Input::Keycode::GAME_L2, \
-0, 0, 0, 0, 0
+0, 0, 0, 0, 0, 0, 0
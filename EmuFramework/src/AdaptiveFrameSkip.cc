@@ -0,0 +1,103 @@
+/*  This file is part of EmuFramework.
+
+	Imagine is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Imagine is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with EmuFramework.  If not, see <http://www.gnu.org/licenses/> */
+
+#define LOGTAG "FrameSkip"
+#include <emuframework/AdaptiveFrameSkip.hh>
+#include <imagine/logger/logger.h>
+#include <algorithm>
+
+namespace EmuEx
+{
+
+static void updateAverage(SteadyClockTime &avg, SteadyClockTime sample)
+{
+	avg = avg.count() ? avg + (sample - avg) / 8 : sample;
+}
+
+double AdaptiveFrameSkip::skipRatio(SteadyClockTime budget) const
+{
+	if(videoCost <= budget)
+		return 0;
+	if(!noVideoCost.count())
+		return 0.5; // skip some frames to measure the cost without video
+	if(noVideoCost >= videoCost)
+		return 0; // skipping video won't help
+	double ratio = double((videoCost - budget).count()) / (videoCost - noVideoCost).count();
+	return std::min(ratio, maxSkipRatio);
+}
+
+bool AdaptiveFrameSkip::shouldSkipVideo(SteadyClockTime budget)
+{
+	auto ratio = skipRatio(budget);
+	if(!ratio)
+	{
+		skipAccumulator = 0;
+		return false;
+	}
+	// with a ratio of 0.5 or less the accumulator can't reach 1 on two frames in a row
+	skipAccumulator += ratio;
+	if(skipAccumulator < 1.)
+		return false;
+	skipAccumulator -= 1.;
+	return true;
+}
+
+void AdaptiveFrameSkip::addFrames(SteadyClockTime totalCost, int frames, bool hadVideo, SteadyClockTimePoint now)
+{
+	if(frames <= 0)
+		return;
+	updateAverage(hadVideo ? videoCost : noVideoCost, totalCost / frames);
+	(hadVideo ? windowVideoFrames : windowNoVideoFrames) += frames;
+	if(!hasTime(statsWindowStart))
+	{
+		statsWindowStart = now;
+		return;
+	}
+	auto elapsed = duration_cast<FloatSeconds>(now - statsWindowStart);
+	if(elapsed < FloatSeconds{1.})
+		return;
+	auto totalFrames = windowVideoFrames + windowNoVideoFrames;
+	effectiveFps.store(windowVideoFrames / elapsed.count(), std::memory_order_relaxed);
+	skippedPercent.store(windowNoVideoFrames * 100.f / totalFrames, std::memory_order_relaxed);
+	statsWindowStart = now;
+	windowVideoFrames = windowNoVideoFrames = 0;
+}
+
+void AdaptiveFrameSkip::addCatchUpFrames(SteadyClockTime totalCost, int frames, SteadyClockTimePoint now)
+{
+	if(frames <= 0)
+		return;
+	// the skips already happened, limit the credit to one frame so a long stall doesn't
+	// disable adaptive skipping for a long time afterwards
+	skipAccumulator = std::max(skipAccumulator - frames, -1.);
+	addFrames(totalCost, frames, false, now);
+}
+
+FrameSkipStats AdaptiveFrameSkip::stats() const
+{
+	return {effectiveFps.load(std::memory_order_relaxed), skippedPercent.load(std::memory_order_relaxed)};
+}
+
+void AdaptiveFrameSkip::reset()
+{
+	videoCost = noVideoCost = {};
+	statsWindowStart = {};
+	skipAccumulator = 0;
+	windowVideoFrames = windowNoVideoFrames = 0;
+	effectiveFps.store(0, std::memory_order_relaxed);
+	skippedPercent.store(0, std::memory_order_relaxed);
+}
+
+}
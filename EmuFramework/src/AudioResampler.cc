@@ -0,0 +1,530 @@
+/*  This file is part of EmuFramework.
+
+	Imagine is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Imagine is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with EmuFramework.  If not, see <http://www.gnu.org/licenses/> */
+
+#define LOGTAG "AudioResampler"
+#include <emuframework/AudioResampler.hh>
+#include <imagine/time/Time.hh>
+#include <imagine/util/algorithm.h>
+#include <imagine/util/ranges.hh>
+#include <imagine/logger/logger.h>
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+#include <span>
+#include <format>
+#if defined __x86_64__ || defined __i386__
+#define EMU_RESAMPLER_X86
+#include <immintrin.h>
+#elif defined __ARM_NEON
+#define EMU_RESAMPLER_NEON
+#include <arm_neon.h>
+#endif
+
+namespace EmuEx
+{
+
+// Sinc filter design, taps scale with the decimation ratio to keep the same transition band,
+// phases are linearly interpolated so the table stays small
+constexpr int sincPhases = 256;
+constexpr int baseSincTaps = 32;
+constexpr int maxSincTaps = 128;
+constexpr double kaiserBeta = 8.6; // ~-85dB stop band
+constexpr double sincRolloff = 0.91;
+
+// Dot product of the input with filter coefficients interpolated between two phases,
+// all implementations require n to be a multiple of 8
+using InterpDotFunc = float(*)(const float *x, const float *coef, const float *delta, float frac, size_t n);
+
+static float interpDotScalar(const float *x, const float *coef, const float *delta, float frac, size_t n)
+{
+	float sum{};
+	for(size_t i = 0; i < n; i++)
+		sum += x[i] * (coef[i] + frac * delta[i]);
+	return sum;
+}
+
+#ifdef EMU_RESAMPLER_X86
+
+[[gnu::target("sse2")]]
+static float interpDotSSE2(const float *x, const float *coef, const float *delta, float frac, size_t n)
+{
+	auto f = _mm_set1_ps(frac);
+	auto sum0 = _mm_setzero_ps();
+	auto sum1 = _mm_setzero_ps();
+	for(size_t i = 0; i < n; i += 8)
+	{
+		auto c0 = _mm_add_ps(_mm_loadu_ps(coef + i), _mm_mul_ps(f, _mm_loadu_ps(delta + i)));
+		auto c1 = _mm_add_ps(_mm_loadu_ps(coef + i + 4), _mm_mul_ps(f, _mm_loadu_ps(delta + i + 4)));
+		sum0 = _mm_add_ps(sum0, _mm_mul_ps(_mm_loadu_ps(x + i), c0));
+		sum1 = _mm_add_ps(sum1, _mm_mul_ps(_mm_loadu_ps(x + i + 4), c1));
+	}
+	auto sum = _mm_add_ps(sum0, sum1);
+	sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+	sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 1));
+	return _mm_cvtss_f32(sum);
+}
+
+[[gnu::target("avx2")]]
+static float interpDotAVX2(const float *x, const float *coef, const float *delta, float frac, size_t n)
+{
+	auto f = _mm256_set1_ps(frac);
+	auto sum = _mm256_setzero_ps();
+	for(size_t i = 0; i < n; i += 8)
+	{
+		auto c = _mm256_add_ps(_mm256_loadu_ps(coef + i), _mm256_mul_ps(f, _mm256_loadu_ps(delta + i)));
+		sum = _mm256_add_ps(sum, _mm256_mul_ps(_mm256_loadu_ps(x + i), c));
+	}
+	auto sum4 = _mm_add_ps(_mm256_castps256_ps128(sum), _mm256_extractf128_ps(sum, 1));
+	sum4 = _mm_add_ps(sum4, _mm_movehl_ps(sum4, sum4));
+	sum4 = _mm_add_ss(sum4, _mm_shuffle_ps(sum4, sum4, 1));
+	return _mm_cvtss_f32(sum4);
+}
+
+#endif
+
+#ifdef EMU_RESAMPLER_NEON
+
+static float interpDotNEON(const float *x, const float *coef, const float *delta, float frac, size_t n)
+{
+	auto sum0 = vdupq_n_f32(0);
+	auto sum1 = vdupq_n_f32(0);
+	for(size_t i = 0; i < n; i += 8)
+	{
+		auto c0 = vmlaq_n_f32(vld1q_f32(coef + i), vld1q_f32(delta + i), frac);
+		auto c1 = vmlaq_n_f32(vld1q_f32(coef + i + 4), vld1q_f32(delta + i + 4), frac);
+		sum0 = vmlaq_f32(sum0, vld1q_f32(x + i), c0);
+		sum1 = vmlaq_f32(sum1, vld1q_f32(x + i + 4), c1);
+	}
+	auto sum = vaddq_f32(sum0, sum1);
+	auto sum2 = vadd_f32(vget_low_f32(sum), vget_high_f32(sum));
+	return vget_lane_f32(vpadd_f32(sum2, sum2), 0);
+}
+
+#endif
+
+struct InterpDotImpl
+{
+	InterpDotFunc func;
+	const char *name;
+};
+
+static const InterpDotImpl &interpDotImpl()
+{
+	static const InterpDotImpl impl = []() -> InterpDotImpl
+	{
+		#if defined EMU_RESAMPLER_X86
+		if(__builtin_cpu_supports("avx2"))
+			return {interpDotAVX2, "AVX2"};
+		else if(__builtin_cpu_supports("sse2"))
+			return {interpDotSSE2, "SSE2"};
+		#elif defined EMU_RESAMPLER_NEON
+		return {interpDotNEON, "NEON"};
+		#endif
+		return {interpDotScalar, "scalar"};
+	}();
+	return impl;
+}
+
+const char *AudioResampler::implName() { return interpDotImpl().name; }
+
+// zeroth order modified Bessel function of the first kind
+static double besselI0(double x)
+{
+	double sum = 1., term = 1.;
+	for(int k = 1; k < 64; k++)
+	{
+		term *= (x / (2. * k)) * (x / (2. * k));
+		sum += term;
+		if(term < sum * 1e-12)
+			break;
+	}
+	return sum;
+}
+
+void AudioResampler::setQuality(AudioResamplerQuality q)
+{
+	if(q == quality_)
+		return;
+	quality_ = q;
+	makeFilter();
+}
+
+void AudioResampler::setRatio(double r)
+{
+	assumeExpr(r > 0.);
+	ratio_ = r;
+	// small changes from rate control keep the current filter
+	if(!taps || (quality_ == AudioResamplerQuality::sinc &&
+		std::abs(std::max(1., r) - filterScale) > filterScale * .01))
+	{
+		makeFilter();
+	}
+}
+
+int AudioResampler::historyFrames() const { return taps / 2 - 1; }
+
+void AudioResampler::makeFilter()
+{
+	auto oldTaps = taps;
+	filterTable = {};
+	filterDeltaTable = {};
+	switch(quality_)
+	{
+		case AudioResamplerQuality::fast: taps = 2; break;
+		case AudioResamplerQuality::cubic: taps = 4; break;
+		case AudioResamplerQuality::sinc:
+		{
+			auto scale = filterScale = std::max(1., ratio_);
+			taps = std::min(int(std::ceil(baseSincTaps * scale / 8.)) * 8, maxSincTaps);
+			double cutoff = 0.5 * sincRolloff / scale; // in cycles per input sample
+			double halfWidth = taps / 2;
+			double i0Beta = besselI0(kaiserBeta);
+			filterTable.resize((sincPhases + 1) * taps);
+			for(auto p : iotaCount(sincPhases + 1))
+			{
+				auto row = &filterTable[p * taps];
+				double frac = double(p) / sincPhases;
+				double sum{};
+				for(auto k : iotaCount(taps))
+				{
+					double d = (k - (taps / 2 - 1)) - frac;
+					double x = 2. * cutoff * d;
+					double sinc = d == 0. ? 1. : std::sin(std::numbers::pi * x) / (std::numbers::pi * x);
+					double w = d / halfWidth;
+					double window = std::abs(w) >= 1. ? 0. : besselI0(kaiserBeta * std::sqrt(1. - w * w)) / i0Beta;
+					row[k] = sinc * window;
+					sum += row[k];
+				}
+				// normalize each phase for unity DC gain
+				for(auto k : iotaCount(taps))
+					row[k] /= sum;
+			}
+			filterDeltaTable.resize(sincPhases * taps);
+			for(auto i : iotaCount(sincPhases * taps))
+				filterDeltaTable[i] = filterTable[i + taps] - filterTable[i];
+			break;
+		}
+	}
+	if(taps != oldTaps)
+		reset();
+	logMsg("using %s filter with %d taps for ratio:%f (%s)", quality_ == AudioResamplerQuality::sinc ? "sinc" :
+		quality_ == AudioResamplerQuality::cubic ? "cubic" : "nearest", taps, ratio_, implName());
+}
+
+void AudioResampler::reset()
+{
+	for(auto &h : history)
+	{
+		h.clear();
+		h.resize(std::max(historyFrames(), 0));
+	}
+	pos = std::max(historyFrames(), 0);
+}
+
+size_t AudioResampler::maxOutputFrames(size_t srcFrames) const
+{
+	double available = double(history[0].size() + srcFrames) - taps / 2 - pos;
+	if(available <= 0.)
+		return 0;
+	return std::ceil(available / ratio_) + 1;
+}
+
+void AudioResampler::appendInput(const void *src, size_t srcFrames, Audio::Format format)
+{
+	if(format.channels != channels)
+	{
+		channels = format.channels;
+		reset();
+	}
+	assumeExpr(channels >= 1 && channels <= maxChannels);
+	for(auto ch : iotaCount(channels))
+	{
+		auto &h = history[ch];
+		auto oldSize = h.size();
+		h.resize(oldSize + srcFrames);
+		auto dest = &h[oldSize];
+		if(format.sample.isFloat())
+		{
+			auto s = (const float*)src + ch;
+			for(size_t i = 0; i < srcFrames; i++)
+				dest[i] = s[i * channels];
+		}
+		else
+		{
+			auto s = (const int16_t*)src + ch;
+			for(size_t i = 0; i < srcFrames; i++)
+				dest[i] = s[i * channels] * (1.f / 32768.f);
+		}
+	}
+}
+
+size_t AudioResampler::process(float *dest, size_t destFrames)
+{
+	const auto len = ptrdiff_t(history[0].size());
+	const auto lead = historyFrames();
+	const auto lastTap = taps / 2;
+	size_t frames{};
+	auto interpDot = interpDotImpl().func;
+	for(; frames < destFrames; frames++)
+	{
+		auto ip = ptrdiff_t(pos);
+		if(ip + lastTap >= len)
+			break;
+		float frac = pos - ip;
+		for(auto ch : iotaCount(channels))
+		{
+			auto x = &history[ch][ip - lead];
+			float out;
+			switch(quality_)
+			{
+				case AudioResamplerQuality::fast:
+					out = x[0];
+					break;
+				case AudioResamplerQuality::cubic:
+				{
+					auto c1 = .5f * (x[2] - x[0]);
+					auto c2 = x[0] - 2.5f * x[1] + 2.f * x[2] - .5f * x[3];
+					auto c3 = .5f * (x[3] - x[0]) + 1.5f * (x[1] - x[2]);
+					out = ((c3 * frac + c2) * frac + c1) * frac + x[1];
+					break;
+				}
+				default:
+				{
+					float phase = frac * sincPhases;
+					auto p = int(phase);
+					out = interpDot(x, &filterTable[p * taps], &filterDeltaTable[p * taps], phase - p, taps);
+				}
+			}
+			dest[frames * channels + ch] = out;
+		}
+		pos += ratio_;
+	}
+	return frames;
+}
+
+void AudioResampler::dropConsumedInput(bool outputFull)
+{
+	const auto len = ptrdiff_t(history[0].size());
+	const auto lead = historyFrames();
+	// drop input that's no longer needed, or everything but the filter history if the output is full
+	auto ip = ptrdiff_t(pos);
+	auto consumed = std::clamp(ip - lead, ptrdiff_t{}, len);
+	if(outputFull && len - consumed > taps)
+		consumed = len - taps;
+	for(auto ch : iotaCount(channels))
+	{
+		auto &h = history[ch];
+		h.erase(h.begin(), h.begin() + consumed);
+	}
+	pos = std::max(pos - consumed, double(lead) + (pos - ip));
+}
+
+size_t AudioResampler::resample(void *dest, size_t destFrames, const void *src, size_t srcFrames, Audio::Format format)
+{
+	if(!taps)
+		makeFilter();
+	appendInput(src, srcFrames, format);
+	size_t frames{};
+	if(format.sample.isFloat())
+	{
+		frames = process((float*)dest, destFrames);
+	}
+	else
+	{
+		assumeExpr(format.sample.bytes() == 2);
+		std::array<float, 1024> buff;
+		auto framesPerBlock = buff.size() / channels;
+		while(frames < destFrames)
+		{
+			auto blockFrames = process(buff.data(), std::min(framesPerBlock, destFrames - frames));
+			auto d = (int16_t*)dest + frames * channels;
+			for(auto i : iotaCount(blockFrames * channels))
+				d[i] = std::clamp(std::lround(buff[i] * 32768.f), -32768l, 32767l);
+			frames += blockFrames;
+			if(blockFrames < framesPerBlock)
+				break;
+		}
+	}
+	dropConsumedInput(frames == destFrames);
+	return frames;
+}
+
+size_t AudioResampler::writePendingInput(void *dest, size_t destFrames, Audio::Format format)
+{
+	if(format.channels != channels) // nothing buffered yet, or in another format
+		return 0;
+	const auto len = history[0].size();
+	// the next output frame would be centered at pos, round to the nearest input frame
+	auto start = std::min(size_t(std::max(std::lround(pos), 0l)), len);
+	auto frames = std::min(len - start, destFrames);
+	for(auto ch : iotaCount(channels))
+	{
+		auto s = &history[ch][start];
+		if(format.sample.isFloat())
+		{
+			auto d = (float*)dest + ch;
+			for(size_t i = 0; i < frames; i++)
+				d[i * channels] = s[i];
+		}
+		else
+		{
+			auto d = (int16_t*)dest + ch;
+			for(size_t i = 0; i < frames; i++)
+				d[i * channels] = std::clamp(std::lround(s[i] * 32768.f), -32768l, 32767l);
+		}
+	}
+	trimToHistory();
+	return frames;
+}
+
+void AudioResampler::keepHistory(const void *src, size_t srcFrames, Audio::Format format)
+{
+	if(!taps)
+		makeFilter();
+	// only the most recent frames can be part of the filter history
+	auto keepFrames = std::min(srcFrames, size_t(std::max(historyFrames(), 0)));
+	appendInput((const char*)src + format.framesToBytes(srcFrames - keepFrames), keepFrames, format);
+	trimToHistory();
+}
+
+// drops all input except the filter history so the next output frame starts at the following input
+void AudioResampler::trimToHistory()
+{
+	const auto lead = std::max(historyFrames(), 0);
+	for(auto &h : history)
+	{
+		if(h.size() > size_t(lead))
+			h.erase(h.begin(), h.end() - lead);
+		else
+			h.insert(h.begin(), lead - h.size(), 0.f);
+	}
+	pos = lead;
+}
+
+struct ToneResult
+{
+	double thdnDb;
+	double nsPerFrame;
+};
+
+// Resamples a stereo 16-bit tone in 60Hz sized blocks, then fits a sine at the expected output
+// frequency and returns the power of the residual relative to the fit
+static ToneResult measureTone(AudioResamplerQuality quality, double ratio, double toneHz)
+{
+	constexpr int rate = 48000;
+	constexpr size_t blockFrames = rate / 60;
+	constexpr size_t blocks = 180;
+	constexpr size_t skipFrames = 256; // ignore the filter start-up
+	Audio::Format format{rate, Audio::SampleFormats::i16, 2};
+	AudioResampler resampler;
+	resampler.setQuality(quality);
+	resampler.setRatio(ratio);
+	std::vector<int16_t> input(blockFrames * 2);
+	std::vector<int16_t> output;
+	std::vector<int16_t> block;
+	SteadyClockTime time{};
+	size_t srcPos{};
+	for([[maybe_unused]] auto b : iotaCount(blocks))
+	{
+		for(auto i : iotaCount(blockFrames))
+		{
+			auto v = int16_t(std::lround(16384. * std::sin(2. * std::numbers::pi * toneHz * double(srcPos++) / rate)));
+			input[i * 2] = input[i * 2 + 1] = v;
+		}
+		block.resize(resampler.maxOutputFrames(blockFrames) * 2);
+		auto start = SteadyClock::now();
+		auto frames = resampler.resample(block.data(), block.size() / 2, input.data(), blockFrames, format);
+		time += SteadyClock::now() - start;
+		output.insert(output.end(), block.begin(), block.begin() + frames * 2);
+	}
+	auto outFrames = output.size() / 2;
+	double w = 2. * std::numbers::pi * toneHz * ratio / rate;
+	double ss{}, cc{}, sc{}, ys{}, yc{};
+	for(auto i = skipFrames; i < outFrames; i++)
+	{
+		double s = std::sin(w * i), c = std::cos(w * i), y = output[i * 2];
+		ss += s * s; cc += c * c; sc += s * c; ys += y * s; yc += y * c;
+	}
+	double det = ss * cc - sc * sc;
+	double a = (ys * cc - yc * sc) / det;
+	double b = (yc * ss - ys * sc) / det;
+	double signal{}, noise{};
+	for(auto i = skipFrames; i < outFrames; i++)
+	{
+		double fit = a * std::sin(w * i) + b * std::cos(w * i);
+		double res = output[i * 2] - fit;
+		signal += fit * fit;
+		noise += res * res;
+	}
+	return {10. * std::log10(noise / signal), double(time.count()) / outFrames};
+}
+
+// Resamples a tone above the output Nyquist frequency at 2x speed and returns its output
+// power relative to the input, which ideally is fully filtered out
+static double measureAliasing(AudioResamplerQuality quality)
+{
+	constexpr int rate = 48000;
+	constexpr size_t blockFrames = rate / 60;
+	constexpr double toneHz = 15000.;
+	Audio::Format format{rate, Audio::SampleFormats::f32, 1};
+	AudioResampler resampler;
+	resampler.setQuality(quality);
+	resampler.setRatio(2.);
+	std::vector<float> input(blockFrames), output;
+	double power{};
+	size_t srcPos{}, outFrames{};
+	for(auto b : iotaCount(60))
+	{
+		for(auto &v : input)
+			v = .5 * std::sin(2. * std::numbers::pi * toneHz * double(srcPos++) / rate);
+		output.resize(resampler.maxOutputFrames(blockFrames));
+		auto frames = resampler.resample(output.data(), output.size(), input.data(), blockFrames, format);
+		if(b < 2) // ignore the filter start-up
+			continue;
+		for(auto v : std::span{output.data(), frames})
+			power += v * v;
+		outFrames += frames;
+	}
+	return 10. * std::log10(power / outFrames / .125);
+}
+
+std::string benchmarkAudioResamplers()
+{
+	constexpr std::array<double, 4> ratios{0.5, 0.75, 1.5, 2.};
+	constexpr std::array<std::pair<AudioResamplerQuality, const char*>, 3> qualities
+	{{
+		{AudioResamplerQuality::fast, "fast"},
+		{AudioResamplerQuality::cubic, "cubic"},
+		{AudioResamplerQuality::sinc, "sinc"},
+	}};
+	std::string json = std::format("{{\"impl\": \"{}\", \"toneHz\": 997, \"results\": [", AudioResampler::implName());
+	bool first = true;
+	for(auto [quality, name] : qualities)
+	{
+		for(auto ratio : ratios)
+		{
+			auto r = measureTone(quality, ratio, 997.);
+			json += std::format("{}\n  {{\"quality\": \"{}\", \"ratio\": {}, \"thdnDb\": {:.1f}, \"nsPerFrame\": {:.1f}}}",
+				first ? "" : ",", name, ratio, r.thdnDb, r.nsPerFrame);
+			first = false;
+		}
+		json += std::format(",\n  {{\"quality\": \"{}\", \"ratio\": 2, \"aliasToneHz\": 15000, \"aliasDb\": {:.1f}}}",
+			name, measureAliasing(quality));
+	}
+	json += "\n]}\n";
+	return json;
+}
+
+}
@@ -130,12 +130,17 @@ void EmuApp::saveConfigFile(FileIO &io)
 	writeOptionValueIfNotDefault(io, CFGKEY_FRAME_RATE_PAL, outputTimingManager.frameTimeOption(VideoSystem::PAL), OutputTimingManager::autoOption);
 	inputManager.vController.writeConfig(io);
 	autosaveManager_.writeConfig(io);
+	rewindManager_.writeConfig(io);
+	libraryIndex_.writeConfig(io);
 	emuAudio.writeConfig(io);
 	doIfUsed(overrideScreenFrameRate, [&](auto &rate)
 	{
 		writeOptionValueIfNotDefault(io, CFGKEY_OVERRIDE_SCREEN_FRAME_RATE, rate, FrameRate{0});
 	});
 	writeOptionValueIfNotDefault(io, CFGKEY_BLANK_FRAME_INSERTION, allowBlankFrameInsertion, false);
+	writeOptionValueIfNotDefault(io, CFGKEY_RUN_AHEAD_FRAMES, runAheadFrames, 0);
+	writeOptionValueIfNotDefault(io, CFGKEY_FRAME_DELAY, useFrameDelay, false);
+	writeOptionValueIfNotDefault(io, CFGKEY_ADAPTIVE_FRAME_SKIP, useAdaptiveFrameSkip, false);
 	if(videoBrightnessRGB != Gfx::Vec3{1.f, 1.f, 1.f})
 		writeOptionValue(io, CFGKEY_VIDEO_BRIGHTNESS, videoBrightnessRGB);
 	#ifdef CONFIG_BLUETOOTH_SCAN_CACHE_USAGE
@@ -146,6 +151,8 @@ void EmuApp::saveConfigFile(FileIO &io)
 		writeOptionValue(io, CFGKEY_CPU_AFFINITY_MASK, cpuAffinityMask);
 	if(used(cpuAffinityMode))
 		writeOptionValueIfNotDefault(io, CFGKEY_CPU_AFFINITY_MODE, cpuAffinityMode, CPUAffinityMode::Auto);
+	if(used(threadSchedulingPolicy))
+		writeOptionValueIfNotDefault(io, CFGKEY_THREAD_SCHEDULING_POLICY, threadSchedulingPolicy, ThreadSchedulingPolicy::Normal);
 	if(used(presentMode) && supportsPresentModes())
 		writeOptionValueIfNotDefault(io, CFGKEY_RENDERER_PRESENT_MODE, presentMode, Gfx::PresentMode::Auto);
 	if(used(usePresentationTime) && renderer.supportsPresentationTime())
@@ -209,6 +216,10 @@ EmuApp::ConfigParams EmuApp::loadConfigFile(IG::ApplicationContext ctx)
 						return true;
 					if(autosaveManager_.readConfig(io, key, size))
 						return true;
+					if(rewindManager_.readConfig(io, key, size))
+						return true;
+					if(libraryIndex_.readConfig(io, key, size))
+						return true;
 					if(emuAudio.readConfig(io, key, size))
 						return true;
 					logMsg("skipping key %u", (unsigned)key);
@@ -276,6 +287,8 @@ EmuApp::ConfigParams EmuApp::loadConfigFile(IG::ApplicationContext ctx)
 					return used(cpuAffinityMask) ? readOptionValue(io, size, cpuAffinityMask) : false;
 				case CFGKEY_CPU_AFFINITY_MODE:
 					return used(cpuAffinityMode) ? readOptionValue(io, size, cpuAffinityMode, [](auto m){return m <= lastEnum<CPUAffinityMode>;}) : false;
+				case CFGKEY_THREAD_SCHEDULING_POLICY:
+					return used(threadSchedulingPolicy) ? readOptionValue(io, size, threadSchedulingPolicy, [](auto m){return m <= ThreadSchedulingPolicy::RoundRobin;}) : false;
 				case CFGKEY_RENDERER_PRESENT_MODE:
 					return used(presentMode) && supportsPresentModes() ? readOptionValue(io, size, presentMode, [](auto m){return m <= lastEnum<Gfx::PresentMode>;}) : false;
 				case CFGKEY_RENDERER_PRESENTATION_TIME:
@@ -292,6 +305,9 @@ EmuApp::ConfigParams EmuApp::loadConfigFile(IG::ApplicationContext ctx)
 				case CFGKEY_SHOW_HIDDEN_FILES: return readOptionValue(io, size, showHiddenFilesInPicker);
 				case CFGKEY_OVERRIDE_SCREEN_FRAME_RATE: return readOptionValue(io, size, overrideScreenFrameRate);
 				case CFGKEY_BLANK_FRAME_INSERTION: return readOptionValue(io, size, allowBlankFrameInsertion);
+				case CFGKEY_RUN_AHEAD_FRAMES: return readOptionValue(io, size, runAheadFrames, [](auto f){return f <= maxRunAheadFrames;});
+				case CFGKEY_FRAME_DELAY: return readOptionValue(io, size, useFrameDelay);
+				case CFGKEY_ADAPTIVE_FRAME_SKIP: return readOptionValue(io, size, useAdaptiveFrameSkip);
 				case CFGKEY_CONTENT_ROTATION: return readOptionValue(io, size, contentRotation_, [](auto r){return r <= lastEnum<Rotation>;});
 				case CFGKEY_VIDEO_LANDSCAPE_ASPECT_RATIO: return readOptionValue(io, size, videoLayer().landscapeAspectRatio, isValidAspectRatio);
 				case CFGKEY_VIDEO_PORTRAIT_ASPECT_RATIO: return readOptionValue(io, size, videoLayer().portraitAspectRatio, isValidAspectRatio);
@@ -0,0 +1,587 @@
+/*  This file is part of EmuFramework.
+
+	Imagine is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Imagine is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with EmuFramework.  If not, see <http://www.gnu.org/licenses/> */
+
+#define LOGTAG "ContentHash"
+#include <emuframework/ContentHash.hh>
+#include <imagine/base/ApplicationContext.hh>
+#include <imagine/io/IO.hh>
+#include <imagine/io/FileIO.hh>
+#include <imagine/fs/FS.hh>
+#include <imagine/logger/logger.h>
+#include <zlib.h>
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+#if defined __x86_64__ || defined __i386__
+#define EMUEX_SHA1_X86
+#include <immintrin.h>
+#elif defined __aarch64__ && (defined __ARM_FEATURE_SHA2 || defined __ARM_FEATURE_CRYPTO)
+#define EMUEX_SHA1_ARM
+#include <arm_neon.h>
+#endif
+
+namespace EmuEx
+{
+
+// input is hashed in chunks this size so all three hashes read it from L1/L2 cache
+constexpr size_t chunkSize = 16 * 1024;
+constexpr size_t readBufferSize = 256 * 1024;
+
+constexpr std::array<uint32_t, 4> md5InitialState{0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476};
+constexpr std::array<uint32_t, 5> sha1InitialState{0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476, 0xc3d2e1f0};
+
+constexpr std::array<uint32_t, 64> md5K
+{
+	0xd76aa478, 0xe8c7b756, 0x242070db, 0xc1bdceee,
+	0xf57c0faf, 0x4787c62a, 0xa8304613, 0xfd469501,
+	0x698098d8, 0x8b44f7af, 0xffff5bb1, 0x895cd7be,
+	0x6b901122, 0xfd987193, 0xa679438e, 0x49b40821,
+	0xf61e2562, 0xc040b340, 0x265e5a51, 0xe9b6c7aa,
+	0xd62f105d, 0x02441453, 0xd8a1e681, 0xe7d3fbc8,
+	0x21e1cde6, 0xc33707d6, 0xf4d50d87, 0x455a14ed,
+	0xa9e3e905, 0xfcefa3f8, 0x676f02d9, 0x8d2a4c8a,
+	0xfffa3942, 0x8771f681, 0x6d9d6122, 0xfde5380c,
+	0xa4beea44, 0x4bdecfa9, 0xf6bb4b60, 0xbebfbc70,
+	0x289b7ec6, 0xeaa127fa, 0xd4ef3085, 0x04881d05,
+	0xd9d4d039, 0xe6db99e5, 0x1fa27cf8, 0xc4ac5665,
+	0xf4292244, 0x432aff97, 0xab9423a7, 0xfc93a039,
+	0x655b59c3, 0x8f0ccc92, 0xffeff47d, 0x85845dd1,
+	0x6fa87e4f, 0xfe2ce6e0, 0xa3014314, 0x4e0811a1,
+	0xf7537e82, 0xbd3af235, 0x2ad7d2bb, 0xeb86d391,
+};
+
+constexpr std::array<uint8_t, 16> md5Shifts{7, 12, 17, 22, 5, 9, 14, 20, 4, 11, 16, 23, 6, 10, 15, 21};
+
+static uint32_t load32LE(const uint8_t *p) { return p[0] | p[1] << 8 | p[2] << 16 | uint32_t(p[3]) << 24; }
+static uint32_t load32BE(const uint8_t *p) { return uint32_t(p[0]) << 24 | p[1] << 16 | p[2] << 8 | p[3]; }
+
+static void md5Blocks(std::array<uint32_t, 4> &state, const uint8_t *data, size_t blocks)
+{
+	for(; blocks; blocks--, data += 64)
+	{
+		std::array<uint32_t, 16> m;
+		for(size_t i = 0; i < m.size(); i++)
+			m[i] = load32LE(data + i * 4);
+		auto [a, b, c, d] = state;
+		for(unsigned i = 0; i < 64; i++)
+		{
+			uint32_t f, g;
+			switch(i / 16)
+			{
+				case 0: f = (b & c) | (~b & d); g = i; break;
+				case 1: f = (d & b) | (~d & c); g = (5 * i + 1) % 16; break;
+				case 2: f = b ^ c ^ d; g = (3 * i + 5) % 16; break;
+				default: f = c ^ (b | ~d); g = (7 * i) % 16; break;
+			}
+			f += a + md5K[i] + m[g];
+			a = d;
+			d = c;
+			c = b;
+			b += std::rotl(f, md5Shifts[(i / 16) * 4 + i % 4]);
+		}
+		state[0] += a;
+		state[1] += b;
+		state[2] += c;
+		state[3] += d;
+	}
+}
+
+static void sha1BlocksScalar(uint32_t *state, const uint8_t *data, size_t blocks)
+{
+	for(; blocks; blocks--, data += 64)
+	{
+		std::array<uint32_t, 80> w;
+		for(size_t i = 0; i < 16; i++)
+			w[i] = load32BE(data + i * 4);
+		for(size_t i = 16; i < w.size(); i++)
+			w[i] = std::rotl(w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16], 1);
+		uint32_t a = state[0], b = state[1], c = state[2], d = state[3], e = state[4];
+		for(size_t i = 0; i < w.size(); i++)
+		{
+			uint32_t f, k;
+			if(i < 20) { f = (b & c) | (~b & d); k = 0x5a827999; }
+			else if(i < 40) { f = b ^ c ^ d; k = 0x6ed9eba1; }
+			else if(i < 60) { f = (b & c) | (b & d) | (c & d); k = 0x8f1bbcdc; }
+			else { f = b ^ c ^ d; k = 0xca62c1d6; }
+			auto temp = std::rotl(a, 5) + f + e + k + w[i];
+			e = d;
+			d = c;
+			c = std::rotl(b, 30);
+			b = a;
+			a = temp;
+		}
+		state[0] += a;
+		state[1] += b;
+		state[2] += c;
+		state[3] += d;
+		state[4] += e;
+	}
+}
+
+#ifdef EMUEX_SHA1_X86
+// Each call runs 4 of the 80 rounds, the message schedule for later rounds is computed
+// alongside so the 4 message registers rotate through the whole block
+template <int i>
+[[gnu::target("sha,sse4.1"), gnu::always_inline]]
+inline void sha1RoundsSHANI(__m128i &abcd, __m128i (&e)[2], __m128i (&msg)[4])
+{
+	auto &m = msg[i % 4];
+	auto &eIn = e[i % 2];
+	if constexpr(i == 0)
+		eIn = _mm_add_epi32(eIn, m);
+	else
+		eIn = _mm_sha1nexte_epu32(eIn, m);
+	e[(i + 1) % 2] = abcd;
+	if constexpr(i >= 3 && i <= 18)
+		msg[(i + 1) % 4] = _mm_sha1msg2_epu32(msg[(i + 1) % 4], m);
+	abcd = _mm_sha1rnds4_epu32(abcd, eIn, i / 5);
+	if constexpr(i >= 1 && i <= 16)
+		msg[(i + 3) % 4] = _mm_sha1msg1_epu32(msg[(i + 3) % 4], m);
+	if constexpr(i >= 2 && i <= 17)
+		msg[(i + 2) % 4] = _mm_xor_si128(msg[(i + 2) % 4], m);
+}
+
+template <int ...i>
+[[gnu::target("sha,sse4.1"), gnu::always_inline]]
+inline void sha1BlockSHANI(__m128i &abcd, __m128i (&e)[2], __m128i (&msg)[4], std::integer_sequence<int, i...>)
+{
+	(sha1RoundsSHANI<i>(abcd, e, msg), ...);
+}
+
+[[gnu::target("sha,sse4.1")]]
+static void sha1BlocksSHANI(uint32_t *state, const uint8_t *data, size_t blocks)
+{
+	const auto byteSwapMask = _mm_set_epi64x(0x0001020304050607ULL, 0x08090a0b0c0d0e0fULL);
+	auto abcd = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i*)state), 0x1B);
+	auto e0 = _mm_set_epi32(state[4], 0, 0, 0);
+	for(; blocks; blocks--, data += 64)
+	{
+		auto abcdSaved = abcd;
+		auto e0Saved = e0;
+		__m128i e[2]{e0, {}};
+		__m128i msg[4];
+		for(int i = 0; i < 4; i++)
+			msg[i] = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(data + i * 16)), byteSwapMask);
+		sha1BlockSHANI(abcd, e, msg, std::make_integer_sequence<int, 20>{});
+		e0 = _mm_sha1nexte_epu32(e[0], e0Saved);
+		abcd = _mm_add_epi32(abcd, abcdSaved);
+	}
+	_mm_storeu_si128((__m128i*)state, _mm_shuffle_epi32(abcd, 0x1B));
+	state[4] = _mm_extract_epi32(e0, 3);
+}
+#endif
+
+#ifdef EMUEX_SHA1_ARM
+template <int i>
+[[gnu::always_inline]]
+inline void sha1RoundsARM(uint32x4_t &abcd, uint32_t (&e)[2], uint32x4_t (&tmp)[2], uint32x4_t (&msg)[4])
+{
+	constexpr uint32_t k[]{0x5a827999, 0x6ed9eba1, 0x8f1bbcdc, 0xca62c1d6};
+	e[(i + 1) % 2] = vsha1h_u32(vgetq_lane_u32(abcd, 0));
+	if constexpr(i / 5 == 0)
+		abcd = vsha1cq_u32(abcd, e[i % 2], tmp[i % 2]);
+	else if constexpr(i / 5 == 2)
+		abcd = vsha1mq_u32(abcd, e[i % 2], tmp[i % 2]);
+	else
+		abcd = vsha1pq_u32(abcd, e[i % 2], tmp[i % 2]);
+	if constexpr(i <= 17)
+		tmp[i % 2] = vaddq_u32(msg[(i + 2) % 4], vdupq_n_u32(k[(i + 2) / 5]));
+	if constexpr(i >= 1 && i <= 16)
+		msg[(i + 3) % 4] = vsha1su1q_u32(msg[(i + 3) % 4], msg[(i + 2) % 4]);
+	if constexpr(i <= 15)
+		msg[i % 4] = vsha1su0q_u32(msg[i % 4], msg[(i + 1) % 4], msg[(i + 2) % 4]);
+}
+
+template <int ...i>
+[[gnu::always_inline]]
+inline void sha1BlockARM(uint32x4_t &abcd, uint32_t (&e)[2], uint32x4_t (&tmp)[2], uint32x4_t (&msg)[4], std::integer_sequence<int, i...>)
+{
+	(sha1RoundsARM<i>(abcd, e, tmp, msg), ...);
+}
+
+static void sha1BlocksARM(uint32_t *state, const uint8_t *data, size_t blocks)
+{
+	auto abcd = vld1q_u32(state);
+	uint32_t e0 = state[4];
+	for(; blocks; blocks--, data += 64)
+	{
+		auto abcdSaved = abcd;
+		uint32_t e[2]{e0, 0};
+		uint32x4_t msg[4];
+		for(int i = 0; i < 4; i++)
+			msg[i] = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(data + i * 16)));
+		uint32x4_t tmp[2]{vaddq_u32(msg[0], vdupq_n_u32(0x5a827999)), vaddq_u32(msg[1], vdupq_n_u32(0x5a827999))};
+		sha1BlockARM(abcd, e, tmp, msg, std::make_integer_sequence<int, 20>{});
+		e0 += e[0];
+		abcd = vaddq_u32(abcd, abcdSaved);
+	}
+	vst1q_u32(state, abcd);
+	state[4] = e0;
+}
+#endif
+
+using SHA1BlocksFunc = void(*)(uint32_t *state, const uint8_t *data, size_t blocks);
+
+static SHA1BlocksFunc selectSHA1Blocks()
+{
+	#if defined EMUEX_SHA1_X86
+	__builtin_cpu_init();
+	if(__builtin_cpu_supports("sha") && __builtin_cpu_supports("sse4.1"))
+	{
+		logMsg("using SHA-NI for SHA1");
+		return sha1BlocksSHANI;
+	}
+	#elif defined EMUEX_SHA1_ARM
+	logMsg("using ARMv8 crypto extensions for SHA1");
+	return sha1BlocksARM;
+	#endif
+	return sha1BlocksScalar;
+}
+
+static SHA1BlocksFunc sha1Blocks()
+{
+	static const SHA1BlocksFunc func = selectSHA1Blocks();
+	return func;
+}
+
+ContentHasher::ContentHasher():
+	md5State{md5InitialState},
+	sha1State{sha1InitialState},
+	crc{uint32_t(crc32_z(0, nullptr, 0))} {}
+
+void ContentHasher::hashBlocks(const uint8_t *data, size_t blocks)
+{
+	md5Blocks(md5State, data, blocks);
+	sha1Blocks()(sha1State.data(), data, blocks);
+}
+
+void ContentHasher::update(std::span<const uint8_t> data)
+{
+	totalBytes += data.size();
+	while(data.size())
+	{
+		auto chunk = data.first(std::min(data.size(), chunkSize));
+		data = data.subspan(chunk.size());
+		crc = crc32_z(crc, chunk.data(), chunk.size());
+		if(blockBytes)
+		{
+			auto copySize = std::min(block.size() - blockBytes, chunk.size());
+			std::copy_n(chunk.data(), copySize, block.data() + blockBytes);
+			blockBytes += copySize;
+			chunk = chunk.subspan(copySize);
+			if(blockBytes < block.size())
+				continue;
+			hashBlocks(block.data(), 1);
+			blockBytes = 0;
+		}
+		auto blocks = chunk.size() / block.size();
+		hashBlocks(chunk.data(), blocks);
+		auto tail = chunk.subspan(blocks * block.size());
+		std::ranges::copy(tail, block.data());
+		blockBytes = tail.size();
+	}
+}
+
+ContentDigest ContentHasher::finish()
+{
+	// MD5 and SHA1 share the same padding except for the byte order of the bit count
+	std::array<uint8_t, 128> padding{};
+	std::copy_n(block.data(), blockBytes, padding.data());
+	padding[blockBytes] = 0x80;
+	size_t paddedSize = blockBytes + 9 > block.size() ? 128 : 64;
+	uint64_t bits = totalBytes * 8;
+	auto lengthPos = padding.data() + paddedSize - 8;
+	for(size_t i = 0; i < 8; i++)
+		lengthPos[i] = bits >> (i * 8);
+	md5Blocks(md5State, padding.data(), paddedSize / 64);
+	for(size_t i = 0; i < 8; i++)
+		lengthPos[i] = bits >> (56 - i * 8);
+	sha1Blocks()(sha1State.data(), padding.data(), paddedSize / 64);
+	ContentDigest digest{.crc32 = crc};
+	for(size_t i = 0; i < md5State.size(); i++)
+	{
+		for(size_t b = 0; b < 4; b++)
+			digest.md5[i * 4 + b] = md5State[i] >> (b * 8);
+	}
+	for(size_t i = 0; i < sha1State.size(); i++)
+	{
+		for(size_t b = 0; b < 4; b++)
+			digest.sha1[i * 4 + b] = sha1State[i] >> (24 - b * 8);
+	}
+	*this = {};
+	return digest;
+}
+
+ContentDigest contentDigest(std::span<const uint8_t> data)
+{
+	ContentHasher hasher;
+	hasher.update(data);
+	return hasher.finish();
+}
+
+ContentDigest contentDigest(IO &io)
+{
+	ContentHasher hasher;
+	if(auto map = io.map(); map.size())
+	{
+		io.advise(0, map.size(), IOAdvice::Sequential);
+		hasher.update(map);
+		return hasher.finish();
+	}
+	auto buff = std::make_unique_for_overwrite<uint8_t[]>(readBufferSize);
+	io.seek(0, IOSeekMode::Set);
+	while(true)
+	{
+		auto bytesRead = io.read(buff.get(), readBufferSize);
+		if(bytesRead <= 0)
+		{
+			if(bytesRead == -1)
+				throw std::runtime_error{"Error reading file"};
+			break;
+		}
+		hasher.update({buff.get(), size_t(bytesRead)});
+	}
+	return hasher.finish();
+}
+
+SHA1Digest sha1Digest(std::span<const uint8_t> data)
+{
+	auto state = sha1InitialState;
+	auto blocks = data.size() / 64;
+	sha1Blocks()(state.data(), data.data(), blocks);
+	auto tail = data.subspan(blocks * 64);
+	std::array<uint8_t, 128> padding{};
+	std::ranges::copy(tail, padding.data());
+	padding[tail.size()] = 0x80;
+	size_t paddedSize = tail.size() + 9 > 64 ? 128 : 64;
+	uint64_t bits = uint64_t(data.size()) * 8;
+	for(size_t i = 0; i < 8; i++)
+		padding[paddedSize - 8 + i] = bits >> (56 - i * 8);
+	sha1Blocks()(state.data(), padding.data(), paddedSize / 64);
+	SHA1Digest digest;
+	for(size_t i = 0; i < state.size(); i++)
+	{
+		for(size_t b = 0; b < 4; b++)
+			digest[i * 4 + b] = state[i] >> (24 - b * 8);
+	}
+	return digest;
+}
+
+// Cache file layout: magic, version, then fixed size records appended as new digests are computed,
+// a later record with the same key replaces an earlier one
+
+struct DigestCacheRecord
+{
+	uint64_t key;
+	uint64_t size;
+	int64_t lastWriteTime;
+	ContentDigest digest;
+};
+
+static_assert(sizeof(DigestCacheRecord) == 64);
+
+constexpr uint32_t cacheMagic = 0x54474944; // "DIGT"
+constexpr uint32_t cacheVersion = 1;
+constexpr size_t cacheHeaderSize = 8;
+
+static FS::PathString cachePath;
+static std::unordered_map<uint64_t, DigestCacheRecord> cacheRecords;
+static FileIO cacheFile; // kept open to append new records
+static size_t cacheFileRecords{};
+static bool cacheLoaded{};
+static std::mutex cacheMutex;
+
+static uint64_t fnv1a(std::span<const uint8_t> data, uint64_t hash = 0xcbf29ce484222325)
+{
+	for(auto b : data)
+	{
+		hash ^= b;
+		hash *= 0x100000001b3;
+	}
+	return hash;
+}
+
+static uint64_t pathKey(CStringView path)
+{
+	std::string_view str{path};
+	return fnv1a({(const uint8_t*)str.data(), str.size()});
+}
+
+static uint64_t crcKey(uint32_t crc32)
+{
+	// a leading 0 byte can't appear in a path so these keys never match a path's
+	std::array<uint8_t, 5> bytes{0, uint8_t(crc32), uint8_t(crc32 >> 8), uint8_t(crc32 >> 16), uint8_t(crc32 >> 24)};
+	return fnv1a(bytes);
+}
+
+static int64_t toSeconds(FS::file_time_type t)
+{
+	return std::chrono::duration_cast<std::chrono::seconds>(t.time_since_epoch()).count();
+}
+
+static void writeCacheHeader(FileIO &io)
+{
+	io.put(cacheMagic);
+	io.put(cacheVersion);
+}
+
+static void rewriteCache()
+{
+	cacheFile = FileIO{cachePath, OpenFlagsMask::New | OpenFlagsMask::Test};
+	if(!cacheFile)
+		return;
+	writeCacheHeader(cacheFile);
+	for(const auto &[key, rec] : cacheRecords)
+		cacheFile.put(rec);
+	cacheFileRecords = cacheRecords.size();
+	logMsg("compacted digest cache to %zu records", cacheFileRecords);
+}
+
+static void loadCache()
+{
+	if(cacheLoaded || cachePath.empty())
+		return;
+	cacheLoaded = true;
+	FileIO io{cachePath, IOAccessHint::Sequential, OpenFlagsMask::Test};
+	if(!io)
+		return;
+	if(io.get<uint32_t>() != cacheMagic || io.get<uint32_t>() != cacheVersion)
+	{
+		logMsg("ignoring digest cache with old format");
+		return;
+	}
+	while(true)
+	{
+		auto rec = io.getExpected<DigestCacheRecord>();
+		if(!rec)
+			break;
+		cacheRecords.insert_or_assign(rec->key, *rec);
+		cacheFileRecords++;
+	}
+	logMsg("loaded %zu records from digest cache", cacheRecords.size());
+	if(cacheFileRecords > cacheRecords.size() * 2 + 256)
+		rewriteCache();
+}
+
+static std::optional<ContentDigest> findCachedDigest(uint64_t key, uint64_t size, int64_t lastWriteTime)
+{
+	loadCache();
+	auto it = cacheRecords.find(key);
+	if(it == cacheRecords.end() || it->second.size != size || it->second.lastWriteTime != lastWriteTime)
+		return {};
+	return it->second.digest;
+}
+
+static void addCachedDigest(const DigestCacheRecord &rec)
+{
+	cacheRecords.insert_or_assign(rec.key, rec);
+	if(cachePath.empty())
+		return;
+	if(!cacheFile)
+	{
+		cacheFile = FileIO{cachePath, OpenFlagsMask::Write | OpenFlagsMask::Create | OpenFlagsMask::Test};
+		if(!cacheFile)
+			return;
+		if(cacheFile.seek(0, IOSeekMode::End) < off_t(cacheHeaderSize))
+		{
+			cacheFile.truncate(0);
+			cacheFile.seek(0, IOSeekMode::Set);
+			writeCacheHeader(cacheFile);
+			cacheFileRecords = 0;
+		}
+	}
+	cacheFile.put(rec);
+	cacheFileRecords++;
+}
+
+std::optional<ContentDigest> contentDigest(ApplicationContext ctx, CStringView path, uint64_t maxSize)
+{
+	IO io{ctx.openFileUri(path, IOAccessHint::Sequential, OpenFlagsMask::Test)};
+	if(!io)
+		return {};
+	uint64_t size = io.size();
+	if(size > maxSize)
+		return {};
+	auto lastWriteTime = toSeconds(ctx.fileUriLastWriteTime(path));
+	auto key = pathKey(path);
+	{
+		std::scoped_lock lock{cacheMutex};
+		if(auto digest = findCachedDigest(key, size, lastWriteTime))
+			return digest;
+	}
+	try
+	{
+		auto digest = contentDigest(io);
+		std::scoped_lock lock{cacheMutex};
+		addCachedDigest({key, size, lastWriteTime, digest});
+		return digest;
+	}
+	catch(std::exception &err)
+	{
+		logErr("error hashing %s:%s", path.data(), err.what());
+		return {};
+	}
+}
+
+ContentDigest contentDigest(IO &io, uint32_t crc32)
+{
+	uint64_t size = io.size();
+	auto key = crcKey(crc32);
+	{
+		std::scoped_lock lock{cacheMutex};
+		if(auto digest = findCachedDigest(key, size, 0))
+			return *digest;
+	}
+	auto digest = contentDigest(io);
+	if(digest.crc32 != crc32)
+	{
+		logWarn("CRC32 mismatch, expected:%08X got:%08X", crc32, digest.crc32);
+		return digest;
+	}
+	std::scoped_lock lock{cacheMutex};
+	addCachedDigest({key, size, 0, digest});
+	return digest;
+}
+
+SHA1Digest cachedSha1Digest(std::span<const uint8_t> data)
+{
+	auto key = crcKey(crc32_z(0, data.data(), data.size()));
+	{
+		std::scoped_lock lock{cacheMutex};
+		if(auto digest = findCachedDigest(key, data.size(), 0))
+			return digest->sha1;
+	}
+	auto digest = contentDigest(data);
+	std::scoped_lock lock{cacheMutex};
+	addCachedDigest({key, data.size(), 0, digest});
+	return digest.sha1;
+}
+
+void setContentDigestCachePath(CStringView path)
+{
+	std::scoped_lock lock{cacheMutex};
+	cachePath = path;
+	cacheFile = {};
+	cacheRecords.clear();
+	cacheFileRecords = 0;
+	cacheLoaded = false;
+}
+
+}
@@ -28,6 +28,7 @@
 #include <emuframework/AudioOptionView.hh>
 #include <emuframework/VideoOptionView.hh>
 #include <emuframework/FilePathOptionView.hh>
+#include <emuframework/ContentHash.hh>
 #include "gui/AutosaveSlotView.hh"
 #include "privateInput.hh"
 #include "WindowData.hh"
@@ -38,6 +39,8 @@
 #include <imagine/base/Application.hh>
 #include <imagine/fs/FS.hh>
 #include <imagine/fs/ArchiveFS.hh>
+#include <imagine/fs/ArchiveIndex.hh>
+#include <imagine/fs/ArchiveEntryCache.hh>
 #include <imagine/io/IO.hh>
 #include <imagine/gfx/Renderer.hh>
 #include <imagine/gfx/RendererTask.hh>
@@ -58,6 +61,7 @@ static EmuApp *gAppPtr{};
 [[gnu::weak]] bool EmuApp::hasIcon = true;
 [[gnu::weak]] bool EmuApp::needsGlobalInstance = false;
 constexpr float pausedVideoBrightnessScale = .75f;
+constexpr int frameThreadRealtimePriority = 2;
 
 constexpr AssetDesc assetDesc[wise_enum::size<AssetID>]
 {
@@ -110,6 +114,7 @@ EmuApp::EmuApp(ApplicationInitParams initParams, ApplicationContext &ctx):
 	emuVideoLayer{emuVideo, defaultVideoAspectRatio()},
 	emuSystemTask{*this},
 	autosaveManager_{*this},
+	libraryIndex_{ctx},
 	inputManager{ctx},
 	pixmapReader{ctx},
 	pixmapWriter{ctx},
@@ -249,6 +254,7 @@ void EmuApp::setCPUNeedsLowLatency(IG::ApplicationContext ctx, bool needed)
 	if(useSustainedPerformanceMode)
 		ctx.setSustainedPerformanceMode(needed);
 	applyCPUAffinity(needed);
+	applyThreadSchedulingPolicy(needed);
 }
 
 static void suspendEmulation(EmuApp &app)
@@ -264,6 +270,7 @@ void EmuApp::closeSystem()
 	showUI();
 	emuSystemTask.stop();
 	system().closeRuntimeSystem(*this);
+	rewindManager_.reset();
 	autosaveManager_.resetSlot();
 	viewController().onSystemClosed();
 }
@@ -458,6 +465,11 @@ void EmuApp::mainInitCommon(IG::ApplicationInitParams initParams, IG::Applicatio
 	system().onOptionsLoaded();
 	loadSystemOptions();
 	updateLegacySavePathOnStoragePath(ctx, system());
+	FS::setArchiveIndexCacheDirectory(FS::pathString(ctx.cachePath(), "archiveIndex"));
+	setContentDigestCachePath(FS::pathString(ctx.cachePath(), "contentDigests"));
+	libraryIndex_.setCachePath(FS::pathString(ctx.cachePath(), "libraryIndex"));
+	libraryIndex_.setNameFilter(EmuSystem::defaultFsFilter);
+	libraryIndex_.start();
 	if(auto launchGame = parseCommandArgs(initParams.commandArgs());
 		launchGame)
 		system().setInitialLoadPath(launchGame);
@@ -603,7 +615,14 @@ void EmuApp::mainInitCommon(IG::ApplicationInitParams initParams, IG::Applicatio
 						if(win.isReady())
 						{
 							if(showFrameTimeStats)
-								viewController.emuView.updateFrameTimeStats(frameTimeStats, params.timestamp);
+							{
+								doIfUsed(frameTimeStats, [&](auto &stats)
+								{
+									stats.commandLatency = emuSystemTask.commandLatency();
+									stats.commandJitter = emuSystemTask.commandJitter();
+								});
+								viewController.emuView.updateFrameTimeStats(frameTimeStats, emuAudio.stats(), adaptiveFrameSkip.stats(), params.timestamp);
+							}
 							record(FrameTimeStatEvent::startOfFrame, params.timestamp);
 							record(FrameTimeStatEvent::startOfEmulation);
 						}
@@ -615,7 +634,11 @@ void EmuApp::mainInitCommon(IG::ApplicationInitParams initParams, IG::Applicatio
 						win.setDrawEventPriority(Window::drawEventPriorityLocked);
 					}
 					EmuAudio *audioPtr = audio ? &audio : nullptr;
-					emuSystemTask.runFrame(videoPtr, audioPtr, frameInfo.advanced, skipForward, altSpeed);
+					// the frame is due by the next vsync, emulation can start late if it finishes before that
+					SteadyClockTimePoint deadline{};
+					if(useFrameDelay && videoPtr && !altSpeed && interval <= 1)
+						deadline = params.timestamp + params.frameTime;
+					emuSystemTask.runFrame(videoPtr, audioPtr, frameInfo.advanced, skipForward, altSpeed, deadline, params.frameTime);
 					if(videoPtr)
 					{
 						if(usePresentationTime)
@@ -732,6 +755,7 @@ void EmuApp::mainInitCommon(IG::ApplicationInitParams initParams, IG::Applicatio
 					{
 						viewManager.defaultFace.freeCaches();
 						viewManager.defaultBoldFace.freeCaches();
+						FS::clearArchiveEntryCache();
 						if(e.running)
 							viewController().prepareDraw();
 					},
@@ -889,11 +913,80 @@ void EmuApp::handleOpenFileCommand(CStringView path)
 void EmuApp::runBenchmarkOneShot(EmuVideo &emuVideo)
 {
 	logMsg("starting benchmark");
-	auto time = system().benchmark(emuVideo);
+	auto results = system().benchmark(emuVideo);
 	autosaveManager_.resetSlot(noAutosaveName);
 	closeSystem();
-	logMsg("done in: %f", duration_cast<FloatSeconds>(time).count());
-	postMessage(2, 0, std::format("{:.2f} fps", 180. / time.count()));
+	logMsg("done in: %f", duration_cast<FloatSeconds>(results.totalTime).count());
+	postMessage(2, 0, std::format("{:.2f} fps", results.fps()));
+}
+
+// Loads the content given on the command line and runs it with no window, renderer, or audio device,
+// printing the timing results as JSON to stdout
+int EmuApp::runHeadlessBenchmark(IG::ApplicationInitParams initParams, IG::ApplicationContext ctx)
+{
+	auto args = initParams.commandArgs();
+	const char *contentPath{};
+	int frames = 1800;
+	for(auto arg : std::span{args.v, size_t(args.c)}.subspan(1))
+	{
+		if(sscanf(arg, "--frames=%d", &frames) == 1)
+			continue;
+		if(std::string_view{arg} == "--audio-resampler")
+		{
+			fputs(benchmarkAudioResamplers().c_str(), stdout);
+			return 0;
+		}
+		contentPath = arg;
+	}
+	if(!contentPath || frames < 1)
+	{
+		fprintf(stderr, "usage: %s [--frames=N] <content path>\n       %s --audio-resampler\n", args.v[0], args.v[0]);
+		return 1;
+	}
+	auto appConfig = loadConfigFile(ctx);
+	system().onOptionsLoaded();
+	loadSystemOptions();
+	FS::setArchiveIndexCacheDirectory(FS::pathString(ctx.cachePath(), "archiveIndex"));
+	setContentDigestCachePath(FS::pathString(ctx.cachePath(), "contentDigests"));
+	try
+	{
+		system().createWithMedia({}, contentPath, ctx.fileUriDisplayName(contentPath), {},
+			[](int pos, int max, const char *label){ return true; });
+	}
+	catch(std::exception &err)
+	{
+		fprintf(stderr, "error loading %s: %s\n", contentPath, err.what());
+		return 1;
+	}
+	emuVideo.setNullSink(system(), EmuSystem::canRenderRGBA8888 ? IG::PIXEL_RGBA8888 : IG::PIXEL_RGB565);
+	// cores still synthesize audio so its cost is counted, the null sink discards it at the output rate
+	#ifdef CONFIG_AUDIO_TIMED
+	emuAudio.setOutputAPI(IG::Audio::Api::NULL_SINK);
+	emuAudio.setEnabled(true);
+	#endif
+	system().configFrameTime(emuAudio.format().rate, system().frameTime());
+	startAudio();
+	logMsg("running %d frame benchmark", frames);
+	bool hasAudio = bool(emuAudio);
+	auto results = system().benchmark(emuVideo, frames, hasAudio ? &emuAudio : nullptr);
+	emuAudio.close();
+	auto toMs = [](SteadyClockTime t){ return duration_cast<std::chrono::duration<double, std::milli>>(t).count(); };
+	std::string contentName;
+	for(auto c : system().contentFileName())
+	{
+		if(c == '"' || c == '\\')
+			contentName += '\\';
+		contentName += c;
+	}
+	auto json = std::format("{{\"system\": \"{}\", \"content\": \"{}\", \"frames\": {}, \"audio\": {}, \"seconds\": {:.3f}, \"fps\": {:.2f}, "
+		"\"frameTimeMs\": {{\"p50\": {:.3f}, \"p95\": {:.3f}, \"p99\": {:.3f}, \"max\": {:.3f}}}}}\n",
+		system().shortSystemName(), contentName, frames, hasAudio,
+		duration_cast<FloatSeconds>(results.totalTime).count(), results.fps(),
+		toMs(results.percentile(50)), toMs(results.percentile(95)), toMs(results.percentile(99)), toMs(results.max()));
+	fputs(json.c_str(), stdout);
+	autosaveManager_.resetSlot(noAutosaveName);
+	system().closeRuntimeSystem(*this);
+	return 0;
 }
 
 void EmuApp::showEmulation()
@@ -920,6 +1013,7 @@ void EmuApp::startEmulation()
 			win.postDraw(1);
 		});
 	frameTimeStats = {};
+	adaptiveFrameSkip.reset();
 	emuSystemTask.start();
 	setCPUNeedsLowLatency(appContext(), true);
 	system().start(*this);
@@ -1013,6 +1107,8 @@ void EmuApp::reloadSystem(EmuSystemCreateParams params)
 
 void EmuApp::onSystemCreated()
 {
+	rewindManager_.reset();
+	runAheadState = {};
 	updateContentRotation();
 	viewController().onSystemCreated();
 }
@@ -1282,6 +1378,14 @@ bool EmuApp::handleKeyInput(InputAction action, const Input::Event &srcEvent)
 			video().takeGameScreenshot();
 			return true;
 		}
+		case guiKeyIdxToggleScreenshotBurst:
+		{
+			if(!isPushed)
+				break;
+			auto burst = video().toggleScreenshotBurst();
+			postMessage(1, false, burst ? "Started screenshot burst" : "Stopping screenshot burst");
+			return true;
+		}
 		case guiKeyIdxToggleFastForward:
 		{
 			if(!isPushed)
@@ -1324,6 +1428,11 @@ bool EmuApp::handleKeyInput(InputAction action, const Input::Event &srcEvent)
 			viewController().inputView.toggleAltSpeedMode(AltSpeedMode::slow);
 			break;
 		}
+		case guiKeyIdxRewind:
+		{
+			rewindManager_.setRewinding(isPushed);
+			break;
+		}
 		default:
 		{
 			handleSystemKeyInput(action);
@@ -1348,7 +1457,15 @@ void EmuApp::handleSystemKeyInput(InputAction action)
 			inputManager.turboActions.removeEvent(action.key);
 		}
 	}
-	system().handleInputAction(this, action);
+	sendInputAction(action);
+}
+
+void EmuApp::sendInputAction(InputAction action)
+{
+	// the virtual keyboard belongs to the main thread, so its shift state is captured with the action
+	if(defaultVController().keyboard().shiftIsActive())
+		action.flags |= InputActionFlagsMask::positionalShift;
+	emuSystemTask.sendInputAction(action);
 }
 
 void EmuApp::runTurboInputEvents()
@@ -1505,6 +1622,15 @@ FrameTimeConfig EmuApp::configFrameTime()
 
 void EmuApp::runFrames(EmuSystemTaskContext taskCtx, EmuVideo *video, EmuAudio *audio, int frames, bool skipForward)
 {
+	if(rewindManager_.isRewinding()) [[unlikely]]
+	{
+		// step back one snapshot per output frame and present it without audio
+		if(rewindManager_.rewindFrame(system()))
+		{
+			system().runFrame(taskCtx, video, nullptr);
+			return;
+		}
+	}
 	if(skipForward) [[unlikely]]
 	{
 		if(skipForwardFrames(taskCtx, frames - 1))
@@ -1518,13 +1644,83 @@ void EmuApp::runFrames(EmuSystemTaskContext taskCtx, EmuVideo *video, EmuAudio *
 			system().setSpeedMultiplier(*audio, 1.);
 		}
 	}
+	else if(useAdaptiveFrameSkip && frames > 1)
+	{
+		auto startTime = SteadyClock::now();
+		skipFrames(taskCtx, frames - 1, audio);
+		auto endTime = SteadyClock::now();
+		adaptiveFrameSkip.addCatchUpFrames(endTime - startTime, frames - 1, endTime);
+	}
 	else
 	{
 		skipFrames(taskCtx, frames - 1, audio);
 	}
 	runTurboInputEvents();
-	system().runFrame(taskCtx, video, audio);
+	if(useAdaptiveFrameSkip && video && !skipForward) [[unlikely]]
+		runFrameWithAdaptiveSkip(taskCtx, video, audio);
+	else if(runAheadFrames && video) [[unlikely]]
+		runFrameWithRunAhead(taskCtx, video, audio);
+	else
+		system().runFrame(taskCtx, video, audio);
 	system().updateBackupMemoryCounter();
+	rewindManager_.onFramesRun(system(), frames);
+}
+
+void EmuApp::runFrameWithAdaptiveSkip(EmuSystemTaskContext taskCtx, EmuVideo *video, EmuAudio *audio)
+{
+	// leave some of the frame time for drawing and presenting
+	auto budget = duration_cast<SteadyClockTime>(system().frameTime() * 0.75 / system().targetSpeed);
+	auto startTime = SteadyClock::now();
+	bool skipVideo = adaptiveFrameSkip.shouldSkipVideo(budget);
+	if(skipVideo)
+	{
+		system().runFrame(taskCtx, nullptr, audio);
+		video->startUnchangedFrame(taskCtx);
+	}
+	else if(runAheadFrames)
+	{
+		runFrameWithRunAhead(taskCtx, video, audio);
+	}
+	else
+	{
+		system().runFrame(taskCtx, video, audio);
+	}
+	auto endTime = SteadyClock::now();
+	adaptiveFrameSkip.addFrames(endTime - startTime, 1, !skipVideo, endTime);
+}
+
+void EmuApp::runFrameWithRunAhead(EmuSystemTaskContext taskCtx, EmuVideo *video, EmuAudio *audio)
+{
+	// run the real frame for audio, then emulate ahead to present a frame that already reflects
+	// the current input, and finally restore the real frame's state
+	system().runFrame(taskCtx, nullptr, audio);
+	record(FrameTimeStatEvent::startOfRunAhead);
+	try
+	{
+		if(runAheadState.empty())
+			runAheadState.resize(system().stateSize());
+		size_t stateSize;
+		try
+		{
+			stateSize = system().saveState(std::span{runAheadState});
+		}
+		catch(...)
+		{
+			runAheadState.resize(system().stateSize());
+			stateSize = system().saveState(std::span{runAheadState});
+		}
+		for(auto i : iotaCount(runAheadFrames - 1))
+		{
+			system().runFrame(taskCtx, nullptr, nullptr);
+		}
+		system().runFrame(taskCtx, video, nullptr);
+		system().loadState({runAheadState.data(), stateSize});
+	}
+	catch(std::exception &err)
+	{
+		logErr("error in run-ahead:%s", err.what());
+	}
+	record(FrameTimeStatEvent::endOfRunAhead);
 }
 
 void EmuApp::skipFrames(EmuSystemTaskContext taskCtx, int frames, EmuAudio *audio)
@@ -1562,8 +1758,8 @@ FS::PathString EmuApp::makeNextScreenshotFilename()
 	auto &sys = system();
 	auto userPath = sys.userPath(userScreenshotPath);
 	sys.createContentLocalDirectory(userPath, subDirName);
-	return sys.contentLocalDirectory(userPath, subDirName,
-		appContext().formatDateAndTimeAsFilename(WallClock::now()).append(".png"));
+	auto name = appContext().formatDateAndTimeAsFilename(WallClock::now());
+	return sys.contentLocalDirectory(userPath, subDirName, name.append(".png"));
 }
 
 void EmuApp::setMogaManagerActive(bool on, bool notify)
@@ -1966,7 +2162,37 @@ void EmuApp::applyCPUAffinity(bool active)
 	auto mask = active ?
 		(cpuAffinityMode == CPUAffinityMode::Auto ? appContext().performanceCPUMask() : CPUMask(cpuAffinityMask)) : 0;
 	logMsg("applying CPU affinity mask 0x%X", (unsigned)mask);
-	setThreadCPUAffinityMask(frameThreadGroup, mask);
+	setThreadCPUAffinityMask(frameThreadIds(), mask);
+	emuAudio.setThreadCPUAffinityMask(mask);
+}
+
+void EmuApp::applyThreadSchedulingPolicy(bool active)
+{
+	doIfUsed(threadSchedulingPolicy, [&](auto policy)
+	{
+		if(!active || policy == ThreadSchedulingPolicy::Normal)
+		{
+			if(!usingRealtimeScheduling)
+				return;
+			policy = ThreadSchedulingPolicy::Normal;
+		}
+		usingRealtimeScheduling = policy != ThreadSchedulingPolicy::Normal;
+		logMsg("applying thread scheduling policy:%d", int(policy));
+		for(auto id : frameThreadIds())
+		{
+			setThreadSchedulingPolicy(id, policy, frameThreadRealtimePriority);
+		}
+		emuAudio.setThreadSchedulingPolicy(policy);
+	});
+}
+
+std::vector<ThreadId> EmuApp::frameThreadIds()
+{
+	std::vector<ThreadId> ids{emuSystemTask.threadId(), renderer.task().threadId()};
+	system().addThreadGroupIds(ids);
+	// skip threads that aren't running, an ID of 0 would refer to the calling thread
+	std::erase(ids, ThreadId{});
+	return ids;
 }
 
 void EmuApp::setCPUAffinity(int cpuNumber, bool on)
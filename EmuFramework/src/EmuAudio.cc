@@ -25,50 +25,13 @@
 namespace EmuEx
 {
 
-struct AudioStats
-{
-	constexpr AudioStats() = default;
-	int underruns{};
-	int overruns{};
-	std::atomic_uint callbacks{};
-	std::atomic_uint callbackBytes{};
-
-	void reset()
-	{
-		underruns = overruns = 0;
-		callbacks = 0;
-		callbackBytes = 0;
-	}
-};
-
-#ifdef CONFIG_EMUFRAMEWORK_AUDIO_STATS
-static AudioStats audioStats{};
-static IG::Timer audioStatsTimer{"audioStatsTimer"};
-#endif
-
-static void startAudioStats(IG::Audio::Format format)
-{
-	#ifdef CONFIG_EMUFRAMEWORK_AUDIO_STATS
-	audioStats.reset();
-	audioStatsTimer.run(IG::Seconds(1), IG::Seconds(1), {},
-		[format]()
-		{
-			auto frames = format.bytesToFrames(audioStats.callbackBytes);
-			emuViewController.updateEmuAudioStats(audioStats.underruns, audioStats.overruns,
-				audioStats.callbacks, frames / (double)audioStats.callbacks, frames);
-			audioStats.callbacks = 0;
-			audioStats.callbackBytes = 0;
-		});
-	#endif
-}
-
-static void stopAudioStats()
-{
-	#ifdef CONFIG_EMUFRAMEWORK_AUDIO_STATS
-	audioStatsTimer.deinit();
-	clearEmuAudioStats();
-	#endif
-}
+// Rate control limits and how quickly it reacts to buffer fill changes
+constexpr double maxRateCorrection = 0.005;
+constexpr double fillSmoothing = 0.05;
+// fill error around the target that's left uncorrected so the ratio stays at exactly 1 and samples can be written in place
+constexpr double rateControlDeadband = 0.1;
+// above the emulation threads so mixing isn't delayed by a long frame
+constexpr int audioThreadRealtimePriority = 3;
 
 EmuAudio::EmuAudio(const IG::Audio::Manager &audioManager):
 	audioManager{audioManager},
@@ -177,11 +140,9 @@ void EmuAudio::start(FloatSeconds bufferDuration)
 			outputFormat,
 			[this, outputSampleFormat = outputFormat.sample, inputSampleFormat = inputFormat.sample, channels = outputFormat.channels](void *samples, size_t frames)
 			{
+				if(threadSchedulingChanged.load(std::memory_order_acquire)) [[unlikely]]
+					applyThreadScheduling();
 				IG::Audio::Format outputFormat{{}, outputSampleFormat, channels};
-				#ifdef CONFIG_EMUFRAMEWORK_AUDIO_STATS
-				audioStats.callbacks++;
-				audioStats.callbackBytes += bytes;
-				#endif
 				if(audioWriteState == AudioWriteState::ACTIVE)
 				{
 					IG::Audio::Format inputFormat = {{}, inputSampleFormat, channels};
@@ -205,9 +166,7 @@ void EmuAudio::start(FloatSeconds bufferDuration)
 							audioWriteState = AudioWriteState::UNDERRUN;
 						}
 						lastUnderrunTime = now;
-						#ifdef CONFIG_EMUFRAMEWORK_AUDIO_STATS
-						audioStats.underruns++;
-						#endif
+						underruns.fetch_add(1, std::memory_order_relaxed);
 					}
 					return true;
 				}
@@ -219,12 +178,14 @@ void EmuAudio::start(FloatSeconds bufferDuration)
 			}
 		};
 		outputConf.wantedLatencyHint = {};
-		startAudioStats(inputFormat);
+		// a new stream may call back on a new thread
+		appliedThreadPolicy = {};
+		if(threadCPUMask.load(std::memory_order_relaxed) || threadPolicy.load(std::memory_order_relaxed) != ThreadSchedulingPolicy::Normal)
+			threadSchedulingChanged.store(true, std::memory_order_release);
 		audioStream.open(outputConf);
 	}
 	else
 	{
-		startAudioStats(inputFormat);
 		if(shouldStartAudioWrites())
 		{
 			if(Config::DEBUG_BUILD)
@@ -241,8 +202,8 @@ void EmuAudio::start(FloatSeconds bufferDuration)
 
 void EmuAudio::stop()
 {
-	stopAudioStats();
 	audioWriteState = AudioWriteState::BUFFER;
+	resetRateControl();
 	if(audioStream)
 		audioStream.close();
 	rBuff.clear();
@@ -253,14 +214,15 @@ void EmuAudio::close()
 	stop();
 	audioStream.reset();
 	rBuff = {};
+	writeScratch = {};
 }
 
 void EmuAudio::flush()
 {
 	if(!audioStream) [[unlikely]]
 		return;
-	stopAudioStats();
 	audioWriteState = AudioWriteState::BUFFER;
+	resetRateControl();
 	if(audioStream)
 		audioStream.flush();
 	rBuff.clear();
@@ -271,6 +233,63 @@ void EmuAudio::writeFrames(const void *samples, size_t framesToWrite)
 	if(!framesToWrite) [[unlikely]]
 		return;
 	assumeExpr(rBuff);
+	prepareWrite();
+	writePreparedFrames(samples, framesToWrite);
+}
+
+void *EmuAudio::beginWrite(size_t maxFrames)
+{
+	assumeExpr(rBuff);
+	// any buffer resize must happen before handing out a pointer into it
+	prepareWrite();
+	auto bytes = format().framesToBytes(maxFrames);
+	if(!needsResampling() && bytes <= rBuff.freeSpace())
+	{
+		writingInPlace = true;
+		return rBuff.writeAddr();
+	}
+	writingInPlace = false;
+	if(writeScratch.size() < bytes)
+		writeScratch.resize(bytes);
+	return writeScratch.data();
+}
+
+void EmuAudio::commitWrite(size_t frames)
+{
+	if(!frames) [[unlikely]]
+		return;
+	if(writingInPlace)
+	{
+		auto inputFormat = format();
+		auto bytes = inputFormat.framesToBytes(frames);
+		resampler.keepHistory(rBuff.writeAddr(), frames, inputFormat);
+		rBuff.commitWrite(bytes);
+		startWritesIfBuffered(bytes);
+	}
+	else
+	{
+		writePreparedFrames(writeScratch.data(), frames);
+	}
+}
+
+// Applies pending settings and buffer changes, then picks the resampling ratio for the next write
+void EmuAudio::prepareWrite()
+{
+	applyRequestedSettings();
+	updateWriteState();
+	updateRateCorrection();
+	resampleRatio = speedMultiplier * rateCorrection.load(std::memory_order_relaxed);
+	if(!needsResampling())
+	{
+		// output any input the resampler still holds from the last write before writing samples directly
+		auto inputFormat = format();
+		auto frames = resampler.writePendingInput(rBuff.writeAddr(), inputFormat.bytesToFrames(rBuff.freeSpace()), inputFormat);
+		rBuff.commitWrite(inputFormat.framesToBytes(frames));
+	}
+}
+
+void EmuAudio::updateWriteState()
+{
 	auto inputFormat = format();
 	switch(audioWriteState)
 	{
@@ -289,38 +308,54 @@ void EmuAudio::writeFrames(const void *samples, size_t framesToWrite)
 		default:
 		break;
 	}
-	const size_t sampleFrames = framesToWrite;
-	if(speedMultiplier != 1.) [[unlikely]]
-	{
-		framesToWrite = std::ceil((double)framesToWrite / speedMultiplier);
-		framesToWrite = std::max(framesToWrite, 1zu);
-	}
-	auto bytes = inputFormat.framesToBytes(framesToWrite);
+}
+
+void EmuAudio::writePreparedFrames(const void *samples, size_t framesToWrite)
+{
+	auto inputFormat = format();
 	auto freeBytes = rBuff.freeSpace();
-	if(bytes <= freeBytes)
+	size_t bytes;
+	if(needsResampling())
 	{
-		if(sampleFrames != framesToWrite)
+		resampler.setRatio(resampleRatio);
+		auto maxFrames = resampler.maxOutputFrames(framesToWrite);
+		auto freeFrames = inputFormat.bytesToFrames(freeBytes);
+		if(maxFrames > freeFrames)
 		{
-			simpleResample(rBuff.writeAddr(), framesToWrite, samples, sampleFrames, inputFormat);
-			rBuff.commitWrite(bytes);
+			logMsg("overrun, only %zu out of %zu frames free", freeFrames, maxFrames);
+			overruns.fetch_add(1, std::memory_order_relaxed);
 		}
-		else
-			rBuff.writeUnchecked(samples, bytes);
+		auto frames = resampler.resample(rBuff.writeAddr(), std::min(maxFrames, freeFrames), samples, framesToWrite, inputFormat);
+		bytes = inputFormat.framesToBytes(frames);
+		rBuff.commitWrite(bytes);
 	}
 	else
 	{
-		logMsg("overrun, only %zu out of %zu bytes free", freeBytes, bytes);
-		#ifdef CONFIG_EMUFRAMEWORK_AUDIO_STATS
-		audioStats.overruns++;
-		#endif
-		auto freeFrames = inputFormat.bytesToFrames(freeBytes);
-		simpleResample(rBuff.writeAddr(), freeFrames, samples, sampleFrames, inputFormat);
-		rBuff.commitWrite(freeBytes);
+		resampler.keepHistory(samples, framesToWrite, inputFormat);
+		bytes = inputFormat.framesToBytes(framesToWrite);
+		if(bytes <= freeBytes)
+		{
+			rBuff.writeUnchecked(samples, bytes);
+		}
+		else
+		{
+			logMsg("overrun, only %zu out of %zu bytes free", freeBytes, bytes);
+			overruns.fetch_add(1, std::memory_order_relaxed);
+			auto freeFrames = inputFormat.bytesToFrames(freeBytes);
+			simpleResample(rBuff.writeAddr(), freeFrames, samples, framesToWrite, inputFormat);
+			rBuff.commitWrite(inputFormat.framesToBytes(freeFrames));
+		}
 	}
-	if(audioWriteState == AudioWriteState::BUFFER && shouldStartAudioWrites(bytes))
+	startWritesIfBuffered(bytes);
+}
+
+void EmuAudio::startWritesIfBuffered(size_t bytesWritten)
+{
+	if(audioWriteState == AudioWriteState::BUFFER && shouldStartAudioWrites(bytesWritten))
 	{
 		if(Config::DEBUG_BUILD)
 		{
+			auto inputFormat = format();
 			auto bytes = rBuff.size();
 			auto capacity = rBuff.capacity();
 			logMsg("starting audio writes with buffer fill %zu/%zu bytes %.2f/%.2f secs",
@@ -330,6 +365,67 @@ void EmuAudio::writeFrames(const void *samples, size_t framesToWrite)
 	}
 }
 
+// Nudges the resampling ratio so the ring buffer plus the backend's own latency settles at the
+// target fill level instead of drifting until an underrun or overrun
+void EmuAudio::updateRateCorrection()
+{
+	if(!dynamicRateControl || audioWriteState != AudioWriteState::ACTIVE)
+	{
+		rateCorrection.store(1.f, std::memory_order_relaxed);
+		return;
+	}
+	auto inputFormat = format();
+	double fillFrames = inputFormat.bytesToFrames(rBuff.size());
+	smoothedFillFrames = smoothedFillFrames ? smoothedFillFrames + (fillFrames - smoothedFillFrames) * fillSmoothing : fillFrames;
+	double deviceFrames = inputFormat.timeToFrames(audioStream.latency());
+	double targetFrames = std::max(double(inputFormat.bytesToFrames(targetBufferFillBytes)) - deviceFrames,
+		double(inputFormat.bytesToFrames(bufferIncrementBytes)));
+	auto error = std::clamp((smoothedFillFrames - targetFrames) / targetFrames, -1., 1.);
+	error = std::abs(error) <= rateControlDeadband ? 0. :
+		(error - std::copysign(rateControlDeadband, error)) / (1. - rateControlDeadband);
+	// a fuller buffer consumes input faster, producing fewer output frames
+	rateCorrection.store(1. + error * maxRateCorrection, std::memory_order_relaxed);
+}
+
+AudioStats EmuAudio::stats() const
+{
+	auto inputFormat = format();
+	return
+	{
+		.bufferLatency = duration_cast<Microseconds>(inputFormat.bytesToTime(rBuff.size())),
+		.deviceLatency = audioStream.latency(),
+		.rateCorrection = rateCorrection.load(std::memory_order_relaxed),
+		.underruns = underruns.load(std::memory_order_relaxed),
+		.overruns = overruns.load(std::memory_order_relaxed),
+	};
+}
+
+void EmuAudio::setThreadCPUAffinityMask(CPUMask mask)
+{
+	if(threadCPUMask.exchange(mask, std::memory_order_relaxed) != mask)
+		threadSchedulingChanged.store(true, std::memory_order_release);
+}
+
+void EmuAudio::setThreadSchedulingPolicy(ThreadSchedulingPolicy policy)
+{
+	if(threadPolicy.exchange(policy, std::memory_order_relaxed) != policy)
+		threadSchedulingChanged.store(true, std::memory_order_release);
+}
+
+void EmuAudio::applyThreadScheduling()
+{
+	threadSchedulingChanged.store(false, std::memory_order_relaxed);
+	auto id = thisThreadId();
+	IG::setThreadCPUAffinityMask(std::array{id}, threadCPUMask.load(std::memory_order_relaxed));
+	// only touch the policy once it's been changed since some APIs already use real-time output threads
+	if(auto policy = threadPolicy.load(std::memory_order_relaxed);
+		policy != appliedThreadPolicy)
+	{
+		IG::setThreadSchedulingPolicy(id, policy, audioThreadRealtimePriority);
+		appliedThreadPolicy = policy;
+	}
+}
+
 void EmuAudio::setRate(int newRate)
 {
 	assert(newRate <= defaultRate);
@@ -356,19 +452,54 @@ void EmuAudio::setStereo(bool on)
 
 void EmuAudio::setSpeedMultiplier(double speed)
 {
-	if(speedMultiplier == speed)
+	if(requestedSpeed.exchange(speed, std::memory_order_relaxed) == speed)
 		return;
-	speedMultiplier = speed;
+	settingsChanged.store(true, std::memory_order_release);
 	logMsg("set speed multiplier:%f", speed);
 	updateVolume();
 	updateAddBuffersOnUnderrun();
+}
+
+// Called from the UI thread, so only request the reset since the writing thread may be inside the resampler
+void EmuAudio::resetRateControl()
+{
+	rateCorrection.store(1.f, std::memory_order_relaxed);
+	rateControlResetRequested.store(true, std::memory_order_relaxed);
+	settingsChanged.store(true, std::memory_order_release);
+}
+
+void EmuAudio::setDynamicRateControl(bool on)
+{
+	requestedRateControl.store(on, std::memory_order_relaxed);
+	resetRateControl();
+}
 
+void EmuAudio::setResamplerQuality(AudioResamplerQuality q)
+{
+	requestedQuality.store(q, std::memory_order_relaxed);
+	settingsChanged.store(true, std::memory_order_release);
+}
+
+// Runs on the thread writing samples before each write, the only thread that touches the resampler
+void EmuAudio::applyRequestedSettings()
+{
+	if(!settingsChanged.exchange(false, std::memory_order_acquire)) [[likely]]
+		return;
+	bool resetResampler = rateControlResetRequested.exchange(false, std::memory_order_relaxed);
+	speedMultiplier = requestedSpeed.load(std::memory_order_relaxed);
+	dynamicRateControl = requestedRateControl.load(std::memory_order_relaxed);
+	resampler.setQuality(requestedQuality.load(std::memory_order_relaxed));
+	if(resetResampler)
+	{
+		smoothedFillFrames = 0;
+		resampler.reset();
+	}
 }
 
 void EmuAudio::updateVolume()
 {
 	assumeExpr(maxVolume_ >= 0.f && maxVolume_ <= 1.25f);
-	if(speedMultiplier != 1.)
+	if(requestedSpeed.load(std::memory_order_relaxed) != 1.)
 	{
 		if(isEnabledDuringAltSpeed())
 			currentVolume = maxVolume_ * .5f;
@@ -381,7 +512,7 @@ void EmuAudio::updateVolume()
 	}
 }
 
-void EmuAudio::updateAddBuffersOnUnderrun() { addSoundBuffersOnUnderrun = speedMultiplier == 1. ? addSoundBuffersOnUnderrunSetting : false; }
+void EmuAudio::updateAddBuffersOnUnderrun() { addSoundBuffersOnUnderrun = requestedSpeed.load(std::memory_order_relaxed) == 1. ? addSoundBuffersOnUnderrunSetting : false; }
 
 constexpr bool isValidVolumeSetting(int8_t vol) { return vol >= 0 && vol <= 125; }
 
@@ -451,6 +582,8 @@ void EmuAudio::writeConfig(FileIO &io) const
 	writeOptionValueIfNotDefault(io, CFGKEY_SOUND_BUFFERS, soundBuffers, defaultSoundBuffers);
 	writeOptionValueIfNotDefault(io, CFGKEY_SOUND_VOLUME, maxVolume(), 100);
 	writeOptionValueIfNotDefault(io, CFGKEY_ADD_SOUND_BUFFERS_ON_UNDERRUN, addSoundBuffersOnUnderrunSetting, false);
+	writeOptionValueIfNotDefault(io, CFGKEY_AUDIO_RESAMPLER, resamplerQuality(), AudioResamplerQuality::sinc);
+	writeOptionValueIfNotDefault(io, CFGKEY_AUDIO_RATE_CONTROL, dynamicRateControlEnabled(), true);
 	if(used(audioAPI))
 		writeOptionValueIfNotDefault(io, CFGKEY_AUDIO_API, audioAPI, Audio::Api::DEFAULT);
 }
@@ -464,6 +597,9 @@ bool EmuAudio::readConfig(MapIO &io, unsigned key, size_t size)
 		case CFGKEY_SOUND_BUFFERS: return readOptionValue(io, size, soundBuffers, optionIsValidWithMinMax<1, 7, int8_t>);
 		case CFGKEY_SOUND_VOLUME: return readOptionValue<int8_t>(io, size, [&](auto v){ setMaxVolume(v); }, isValidVolumeSetting);
 		case CFGKEY_ADD_SOUND_BUFFERS_ON_UNDERRUN: return readOptionValue(io, size, addSoundBuffersOnUnderrunSetting);
+		case CFGKEY_AUDIO_RESAMPLER: return readOptionValue<AudioResamplerQuality>(io, size,
+			[&](auto q){ setResamplerQuality(q); }, isValidAudioResamplerQuality);
+		case CFGKEY_AUDIO_RATE_CONTROL: return readOptionValue<bool>(io, size, [&](auto on){ setDynamicRateControl(on); });
 		case CFGKEY_AUDIO_API: return used(audioAPI) ? readOptionValue(io, size, audioAPI) : false;
 	}
 	return false;
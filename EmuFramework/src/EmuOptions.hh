@@ -74,6 +74,11 @@ enum { CFGKEY_SOUND = 0, CFGKEY_TOUCH_CONTROL_DISPLAY = 1,
 	CFGKEY_VIDEO_LANDSCAPE_ASPECT_RATIO = 106, CFGKEY_VIDEO_PORTRAIT_ASPECT_RATIO = 107,
 	CFGKEY_CPU_AFFINITY_MASK = 108, CFGKEY_CPU_AFFINITY_MODE = 109,
 	CFGKEY_RENDERER_PRESENT_MODE = 110, CFGKEY_BLANK_FRAME_INSERTION = 111,
+	CFGKEY_REWIND_MAX_MEMORY = 112, CFGKEY_REWIND_SNAPSHOT_INTERVAL = 113,
+	CFGKEY_RUN_AHEAD_FRAMES = 114, CFGKEY_AUDIO_RESAMPLER = 115,
+	CFGKEY_AUDIO_RATE_CONTROL = 116, CFGKEY_FRAME_DELAY = 117,
+	CFGKEY_ADAPTIVE_FRAME_SKIP = 118, CFGKEY_THREAD_SCHEDULING_POLICY = 119,
+	CFGKEY_LIBRARY_PATHS = 120,
 	// 256+ is reserved
 };
 
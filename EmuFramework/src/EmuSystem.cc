@@ -21,16 +21,24 @@
 #include <emuframework/EmuVideo.hh>
 #include <imagine/base/ApplicationContext.hh>
 #include <imagine/fs/ArchiveFS.hh>
+#include <imagine/fs/ArchiveIndex.hh>
 #include <imagine/fs/FSUtils.hh>
 #include <imagine/io/IO.hh>
+#include <imagine/io/FileIO.hh>
 #include <imagine/input/DragTracker.hh>
 #include <imagine/util/utility.h>
 #include <imagine/util/math/int.hh>
 #include <imagine/util/ScopeGuard.hh>
 #include <imagine/util/string.h>
+#include <imagine/util/format.hh>
 #include <algorithm>
 #include <cstring>
 #include "pathUtils.hh"
+#ifdef __linux__
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
 
 namespace EmuEx
 {
@@ -276,14 +284,31 @@ void EmuSystem::start(EmuApp &app)
 	app.autosaveManager().startTimer();
 }
 
-SteadyClockTime EmuSystem::benchmark(EmuVideo &video)
+BenchmarkResults EmuSystem::benchmark(EmuVideo &video, int frames, EmuAudio *audio)
 {
+	BenchmarkResults results;
+	results.frameTimes.reserve(frames);
 	auto before = SteadyClock::now();
-	for(auto i : iotaCount(180))
+	auto frameStart = before;
+	for(auto i : iotaCount(frames))
 	{
-		runFrame({}, &video, nullptr);
+		runFrame({}, &video, audio);
+		auto frameEnd = SteadyClock::now();
+		results.frameTimes.emplace_back(frameEnd - frameStart);
+		frameStart = frameEnd;
 	}
-	return SteadyClock::now() - before;
+	results.totalTime = frameStart - before;
+	std::ranges::sort(results.frameTimes);
+	return results;
+}
+
+SteadyClockTime BenchmarkResults::percentile(int p) const
+{
+	if(frameTimes.empty())
+		return {};
+	// nearest-rank method
+	auto rank = divRoundUp(frameTimes.size() * size_t(p), 100uz);
+	return frameTimes[std::clamp(rank, 1uz, frameTimes.size()) - 1];
 }
 
 void EmuSystem::configFrameTime(int outputRate, FrameTime outputFrameTime)
@@ -365,19 +390,31 @@ void EmuSystem::loadContentFromFile(IO file, CStringView path, std::string_view
 	{
 		IO io{};
 		FS::FileString originalName{};
-		for(auto &entry : FS::ArchiveIterator{std::move(file)})
+		if(auto index = FS::archiveIndex(path))
 		{
-			if(entry.type() == FS::file_type::directory)
+			if(auto entryPtr = index->findFirst([](std::string_view name){ return EmuSystem::defaultFsFilter(name); }))
 			{
-				continue;
+				logMsg("archive file entry:%s", entryPtr->name.c_str());
+				originalName = entryPtr->name;
+				io = index->open(*entryPtr);
 			}
-			auto name = entry.name();
-			logMsg("archive file entry:%s", name.data());
-			if(EmuSystem::defaultFsFilter(name))
+		}
+		else
+		{
+			for(auto &entry : FS::ArchiveIterator{std::move(file)})
 			{
-				originalName = name;
-				io = entry.releaseIO();
-				break;
+				if(entry.type() == FS::file_type::directory)
+				{
+					continue;
+				}
+				auto name = entry.name();
+				logMsg("archive file entry:%s", name.data());
+				if(EmuSystem::defaultFsFilter(name))
+				{
+					originalName = name;
+					io = entry.releaseIO();
+					break;
+				}
 			}
 		}
 		if(!io)
@@ -405,6 +442,42 @@ void EmuSystem::throwFileWriteError()
 	throw std::runtime_error("Error writing file");
 }
 
+void EmuSystem::throwStateBufferSizeError()
+{
+	throw std::runtime_error("State buffer too small");
+}
+
+FS::PathString EmuSystem::scratchStatePath() const
+{
+	#ifdef __linux__
+	if(scratchStateFd == -1)
+		scratchStateFd = UniqueFileDescriptor{int(syscall(__NR_memfd_create, "ScratchState", MFD_CLOEXEC))};
+	if(scratchStateFd != -1)
+		return IG::format<FS::PathString>("/proc/self/fd/{}", scratchStateFd.get());
+	#endif
+	return FS::pathString(appContext().cachePath(), "scratch.state");
+}
+
+size_t EmuSystem::readScratchState(std::span<uint8_t> buff) const
+{
+	auto path = scratchStatePath();
+	auto size = FS::file_size(path);
+	if(size > buff.size())
+		throwStateBufferSizeError();
+	auto bytesRead = FileUtils::readFromPath(path, buff);
+	if(bytesRead == -1)
+		throwFileReadError();
+	return bytesRead;
+}
+
+FS::PathString EmuSystem::writeScratchState(std::span<const uint8_t> buff) const
+{
+	auto path = scratchStatePath();
+	if(FileUtils::writeToPath(path, buff) != ssize_t(buff.size()))
+		throwFileWriteError();
+	return path;
+}
+
 void EmuSystem::throwMissingContentDirError()
 {
 	throw std::runtime_error("This content must be opened with a folder, \"Browse For File\" isn't supported");
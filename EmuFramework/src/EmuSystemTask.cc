@@ -30,6 +30,7 @@ void EmuSystemTask::start()
 {
 	if(taskThread.joinable())
 		return;
+	frameDelay.reset();
 	taskThread = makeThreadSync(
 		[this](auto &sem)
 		{
@@ -48,6 +49,7 @@ void EmuSystemTask::start()
 					{
 						[&](RunFrameCommand &run)
 						{
+							updateCommandLatency(SteadyClock::now() - msg.sendTime);
 							runCmd.video = run.video;
 							runCmd.audio = run.audio;
 							// accumulate the total frames from all commands in queue
@@ -56,16 +58,26 @@ void EmuSystemTask::start()
 							else
 								fastForwardFrames += run.frames;
 							runCmd.skipForward = run.skipForward;
+							runCmd.deadline = run.deadline;
+							runCmd.frameTime = run.frameTime;
 							return true;
 						},
 						[&](PauseCommand &)
 						{
 							//logMsg("got pause command");
+							applyQueuedInput();
 							runCmd.frames = fastForwardFrames = 0;
 							assumeExpr(msg.semPtr);
 							msg.semPtr->release();
 							return true;
 						},
+						[&](ApplyInputCommand &)
+						{
+							applyQueuedInput();
+							assumeExpr(msg.semPtr);
+							msg.semPtr->release();
+							return true;
+						},
 						[&](ExitCommand &)
 						{
 							started = false;
@@ -81,8 +93,20 @@ void EmuSystemTask::start()
 					return true;
 				assumeExpr(runCmd.frames > 0);
 				//logMsg("running %d frame(s)", runCmd.frames);
+				// only delay when not catching up on multiple frames
+				bool useFrameDelay = runCmd.frames == 1 && runCmd.video && hasTime(runCmd.deadline);
+				if(useFrameDelay)
+					waitForFrameStart(runCmd.deadline, runCmd.frameTime);
+				auto startTime = SteadyClock::now();
+				applyQueuedInput();
 				app.runFrames({this}, runCmd.video, runCmd.audio,
 					runCmd.frames, runCmd.skipForward);
+				frameIndex_ += runCmd.frames;
+				if(useFrameDelay)
+				{
+					auto endTime = SteadyClock::now();
+					frameDelay.addFrame(endTime - startTime, endTime, runCmd.deadline);
+				}
 				return true;
 			});
 			sem.release();
@@ -108,15 +132,72 @@ void EmuSystemTask::stop()
 	commandPort.send({.command = ExitCommand{}});
 	taskThread.join();
 	threadId_ = 0;
+	applyQueuedInput();
 	app.flushMainThreadMessages();
 }
 
-void EmuSystemTask::runFrame(EmuVideo *video, EmuAudio *audio, int8_t frames, bool skipForward, bool fastForward)
+void EmuSystemTask::runFrame(EmuVideo *video, EmuAudio *audio, int8_t frames, bool skipForward, bool fastForward,
+	SteadyClockTimePoint deadline, SteadyClockTime frameTime)
 {
 	assumeExpr(frames > 0);
 	if(!taskThread.joinable()) [[unlikely]]
 		return;
-	commandPort.send({.command = RunFrameCommand{video, audio, frames, skipForward, fastForward}});
+	commandPort.send({.command = RunFrameCommand{video, audio, deadline, frameTime, frames, skipForward, fastForward}});
+}
+
+void EmuSystemTask::waitForFrameStart(SteadyClockTimePoint deadline, SteadyClockTime frameTime)
+{
+	auto startTime = frameDelay.startTime(deadline, frameTime);
+	if(!hasTime(startTime) || startTime <= SteadyClock::now())
+		return;
+	std::this_thread::sleep_until(startTime);
+}
+
+void EmuSystemTask::sendInputAction(InputAction action)
+{
+	if(!taskThread.joinable())
+	{
+		applyInput(action);
+		return;
+	}
+	// queued input is applied by the emulation thread at the next frame boundary
+	if(inputQueue.push(action))
+		return;
+	// the thread only drains the queue between frames, so have it drain now in case it's paused
+	logWarn("input queue full, waiting for emulation thread");
+	commandPort.send({.command = ApplyInputCommand{}}, true);
+	[[maybe_unused]] bool pushed = inputQueue.push(action);
+	assert(pushed);
+}
+
+void EmuSystemTask::updateCommandLatency(SteadyClockTime latency)
+{
+	// smoothed mean deviation between successive latencies, as used for RTP interarrival jitter
+	auto lastLatency = commandLatency_.load(std::memory_order_relaxed);
+	auto jitter = commandJitter_.load(std::memory_order_relaxed);
+	auto diff = latency > lastLatency ? latency - lastLatency : lastLatency - latency;
+	commandJitter_.store(jitter + (diff - jitter) / 16, std::memory_order_relaxed);
+	commandLatency_.store(latency, std::memory_order_relaxed);
+}
+
+void EmuSystemTask::applyQueuedInput()
+{
+	inputQueue.drain([&](const InputAction &a) { applyInput(a); });
+}
+
+void EmuSystemTask::applyInput(InputAction action)
+{
+	if(recordInput)
+		inputLog.emplace_back(frameIndex_, action);
+	app.system().handleInputAction(&app, action);
+}
+
+void EmuSystemTask::setInputRecording(bool on)
+{
+	assert(!taskThread.joinable());
+	recordInput = on;
+	inputLog.clear();
+	frameIndex_ = 0;
 }
 
 void EmuSystemTask::sendVideoFormatChangedReply(EmuVideo &video)
@@ -132,12 +213,4 @@ void EmuSystemTask::sendFrameFinishedReply(EmuVideo &video)
 	video.dispatchFrameFinished();
 }
 
-void EmuSystemTask::sendScreenshotReply(bool success)
-{
-	app.runOnMainThread([&app = app, success](ApplicationContext ctx)
-	{
-		app.printScreenshotResult(success);
-	});
-}
-
 }
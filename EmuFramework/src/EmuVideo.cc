@@ -53,6 +53,15 @@ bool EmuVideo::hasRendererTask() const
 	return rTask;
 }
 
+// Without a renderer task, frames are drawn into a CPU buffer and discarded,
+// used for headless benchmarking
+void EmuVideo::setNullSink(EmuSystem &sys, IG::PixelFormat fmt)
+{
+	assert(!rTask);
+	renderFmt = fmt;
+	sys.onVideoRenderFormatChange(*this, fmt);
+}
+
 static bool isValidRenderFormat(IG::PixelFormat fmt)
 {
 	return fmt == IG::PIXEL_FMT_RGBA8888 ||
@@ -62,6 +71,14 @@ static bool isValidRenderFormat(IG::PixelFormat fmt)
 
 bool EmuVideo::setFormat(IG::PixmapDesc desc, EmuSystemTaskContext taskCtx)
 {
+	if(!rTask) [[unlikely]]
+	{
+		if(desc == nullSinkDesc)
+			return false;
+		nullSinkDesc = desc;
+		nullSinkBuff.resize(desc.bytes());
+		return true;
+	}
 	if(formatIsEqual(desc))
 	{
 		return false; // no change to size/format
@@ -100,6 +117,8 @@ void EmuVideo::syncImageAccess()
 
 EmuVideoImage EmuVideo::startFrame(EmuSystemTaskContext taskCtx)
 {
+	if(!rTask) [[unlikely]]
+		return {taskCtx, *this, {nullptr, {nullSinkDesc, nullSinkBuff.data()}, {}, 0, false}};
 	auto lockedTex = vidImg.lock();
 	syncImageAccess();
 	return {taskCtx, *this, lockedTex};
@@ -162,9 +181,11 @@ void EmuVideo::postFrameFinished(EmuSystemTaskContext taskCtx)
 
 void EmuVideo::finishFrame(EmuSystemTaskContext taskCtx, Gfx::LockedTextureBuffer texBuff)
 {
-	if(screenshotNextFrame) [[unlikely]]
+	if(!rTask) [[unlikely]]
+		return;
+	if(needsScreenshot()) [[unlikely]]
 	{
-		doScreenshot(taskCtx, texBuff.pixmap());
+		doScreenshot(texBuff.pixmap());
 	}
 	app().record(FrameTimeStatEvent::aboutToSubmitFrame);
 	vidImg.unlock(texBuff);
@@ -173,9 +194,11 @@ void EmuVideo::finishFrame(EmuSystemTaskContext taskCtx, Gfx::LockedTextureBuffe
 
 void EmuVideo::finishFrame(EmuSystemTaskContext taskCtx, IG::PixmapView pix)
 {
-	if(screenshotNextFrame) [[unlikely]]
+	if(!rTask) [[unlikely]]
+		return;
+	if(needsScreenshot()) [[unlikely]]
 	{
-		doScreenshot(taskCtx, pix);
+		doScreenshot(pix);
 	}
 	app().record(FrameTimeStatEvent::aboutToSubmitFrame);
 	syncImageAccess();
@@ -203,17 +226,37 @@ void EmuVideo::takeGameScreenshot()
 	screenshotNextFrame = true;
 }
 
-void EmuVideo::doScreenshot(EmuSystemTaskContext taskCtx, IG::PixmapView pix)
+bool EmuVideo::toggleScreenshotBurst()
 {
-	screenshotNextFrame = false;
-	auto success = app().writeScreenshot(pix, app().makeNextScreenshotFilename());
-	if(taskCtx)
+	auto burst = !screenshotBurst.load(std::memory_order_relaxed);
+	screenshotBurst.store(burst, std::memory_order_relaxed);
+	return burst;
+}
+
+bool EmuVideo::needsScreenshot() const
+{
+	return screenshotNextFrame || screenshotBurst.load(std::memory_order_relaxed) || app().screenshotWriter().inBurst();
+}
+
+void EmuVideo::doScreenshot(IG::PixmapView pix)
+{
+	auto &writer = app().screenshotWriter();
+	auto burst = screenshotBurst.load(std::memory_order_relaxed);
+	if(burst != writer.inBurst())
 	{
-		taskCtx.task().sendScreenshotReply(success);
+		if(burst)
+			writer.beginBurst();
+		else
+			writer.endBurst();
 	}
-	else
+	if(writer.inBurst())
+	{
+		writer.capture(pix);
+	}
+	else if(screenshotNextFrame)
 	{
-		app().printScreenshotResult(success);
+		screenshotNextFrame = false;
+		writer.capture(pix, app().makeNextScreenshotFilename());
 	}
 }
 
@@ -0,0 +1,65 @@
+/*  This file is part of EmuFramework.
+
+	Imagine is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Imagine is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with EmuFramework.  If not, see <http://www.gnu.org/licenses/> */
+
+#define LOGTAG "FrameDelay"
+#include <emuframework/FrameDelay.hh>
+#include <imagine/logger/logger.h>
+#include <algorithm>
+
+namespace EmuEx
+{
+
+constexpr SteadyClockTime maxMargin{Milliseconds{50}};
+
+SteadyClockTimePoint FrameDelay::startTime(SteadyClockTimePoint deadline, SteadyClockTime frameTime) const
+{
+	// measure a few frames before delaying any
+	if(frames < historySize / 4)
+		return {};
+	auto budget = maxEmulationTime + margin_;
+	if(budget >= frameTime)
+		return {};
+	return deadline - budget;
+}
+
+void FrameDelay::addFrame(SteadyClockTime emulationTime, SteadyClockTimePoint endTime, SteadyClockTimePoint deadline)
+{
+	emulationTimes[nextIdx] = emulationTime;
+	nextIdx = (nextIdx + 1) % historySize;
+	frames = std::min(frames + 1, historySize);
+	maxEmulationTime = *std::max_element(emulationTimes.begin(), emulationTimes.begin() + frames);
+	if(endTime + minMargin > deadline)
+	{
+		// back off quickly so a heavy scene doesn't miss several frames in a row
+		margin_ = std::min(margin_ * 2, maxMargin);
+		logMsg("frame overran deadline by %lldus, margin now %lldus",
+			(long long)duration_cast<Microseconds>(endTime + minMargin - deadline).count(),
+			(long long)duration_cast<Microseconds>(margin_).count());
+	}
+	else
+	{
+		// then slowly recover the latency
+		margin_ -= (margin_ - minMargin) / 64;
+	}
+}
+
+void FrameDelay::reset()
+{
+	maxEmulationTime = {};
+	margin_ = initialMargin;
+	nextIdx = frames = 0;
+}
+
+}
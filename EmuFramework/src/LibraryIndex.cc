@@ -0,0 +1,833 @@
+/*  This file is part of EmuFramework.
+
+	Imagine is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Imagine is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with EmuFramework.  If not, see <http://www.gnu.org/licenses/> */
+
+#define LOGTAG "LibraryIndex"
+#include <emuframework/LibraryIndex.hh>
+#include <emuframework/Option.hh>
+#include "EmuOptions.hh"
+#include <imagine/base/ApplicationContext.hh>
+#include <imagine/io/IO.hh>
+#include <imagine/io/FileIO.hh>
+#include <imagine/io/MapIO.hh>
+#include <imagine/fs/FS.hh>
+#include <imagine/fs/ArchiveFS.hh>
+#include <imagine/fs/ArchiveIndex.hh>
+#include <imagine/thread/Thread.hh>
+#include <imagine/util/algorithm.h>
+#include <imagine/util/ranges.hh>
+#include <imagine/util/string.h>
+#include <imagine/util/string/uri.hh>
+#include <imagine/logger/logger.h>
+#include <algorithm>
+#include <numeric>
+#include <unordered_set>
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <sys/eventfd.h>
+#include <poll.h>
+#include <unistd.h>
+#endif
+
+namespace EmuEx
+{
+
+// Index file layout: magic, version, directory count, then each directory's path, modification time,
+// depth, subdirectory paths, and entries. Strings are stored with a 16-bit length prefix and an entry's
+// path is omitted when it's just the directory path joined with its name.
+
+constexpr uint32_t indexMagic = 0x5842494C; // "LIBX"
+constexpr uint32_t indexVersion = 1;
+
+enum IndexEntryFlags : uint8_t
+{
+	HAS_DIGEST = 1 << 0,
+	PATH_IN_DIR = 1 << 1,
+};
+
+// nice value for the worker thread so scans and hashing don't compete with emulation
+constexpr int workerThreadPriority = 10;
+// time to wait for more change notifications before rescanning
+constexpr int changeSettleMSecs = 1000;
+
+struct FileStatus
+{
+	uint64_t size{};
+	int64_t lastWriteTime{};
+	FS::file_type type{FS::file_type::not_found};
+};
+
+static int64_t toSeconds(auto t)
+{
+	return std::chrono::duration_cast<std::chrono::seconds>(t.time_since_epoch()).count();
+}
+
+static FileStatus fileStatus(ApplicationContext ctx, CStringView path)
+{
+	if(isUri(path))
+	{
+		// document providers only report a modification time without opening the file
+		if(!ctx.fileUriExists(path))
+			return {};
+		return {0, toSeconds(ctx.fileUriLastWriteTime(path)), FS::file_type::unknown};
+	}
+	auto status = FS::status(path);
+	return {status.size(), toSeconds(status.lastWriteTime()), status.type()};
+}
+
+static bool writeString(FileIO &io, std::string_view str)
+{
+	return io.put(uint16_t(str.size())) == 2 && io.write(str.data(), str.size()) == ssize_t(str.size());
+}
+
+static bool readValue(MapIO &io, auto &val)
+{
+	auto result = io.getExpected<std::remove_reference_t<decltype(val)>>();
+	if(!result)
+		return false;
+	val = *result;
+	return true;
+}
+
+static bool readString(MapIO &io, std::string &str)
+{
+	auto len = io.getExpected<uint16_t>();
+	if(!len)
+		return false;
+	return io.readSized(str, *len) == ssize_t(*len);
+}
+
+// every counted item takes at least a byte, so a count past the end of the file means it's corrupt
+static bool readCount(MapIO &io, uint32_t &count)
+{
+	return readValue(io, count) && count <= io.size() - io.tell();
+}
+
+LibraryIndex::LibraryIndex(ApplicationContext ctx):
+	ctx{ctx} {}
+
+LibraryIndex::~LibraryIndex()
+{
+	stop();
+}
+
+void LibraryIndex::setCachePath(CStringView path)
+{
+	cachePath = path;
+}
+
+void LibraryIndex::setNameFilter(NameFilterFunc filter)
+{
+	nameFilter = filter;
+}
+
+void LibraryIndex::setOnUpdate(DelegateFunc<void()> del)
+{
+	onUpdate = del;
+}
+
+std::vector<std::string> LibraryIndex::directories() const
+{
+	std::scoped_lock lock{mutex};
+	return directories_;
+}
+
+bool LibraryIndex::addDirectory(std::string_view path)
+{
+	{
+		std::scoped_lock lock{mutex};
+		if(path.empty() || contains(directories_, path))
+			return false;
+		directories_.emplace_back(path);
+	}
+	if(isRunning())
+		rescan();
+	else
+		start();
+	return true;
+}
+
+bool LibraryIndex::removeDirectory(std::string_view path)
+{
+	{
+		std::scoped_lock lock{mutex};
+		if(!std::erase(directories_, path))
+			return false;
+	}
+	rescan();
+	return true;
+}
+
+void LibraryIndex::start()
+{
+	if(isRunning())
+		return;
+	{
+		std::scoped_lock lock{mutex};
+		if(directories_.empty())
+			return;
+	}
+	assert(nameFilter);
+	if(!onUpdateEvent.isAttached())
+	{
+		onUpdateEvent.attach([this]()
+		{
+			if(onUpdate)
+				onUpdate();
+		});
+	}
+	#ifdef __linux__
+	notifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+	if(notifyFd == -1)
+		logErr("can't create inotify instance, library changes won't be detected until the next rescan");
+	wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+	#endif
+	stopRequested = false;
+	thread = std::thread{[this](){ run(); }};
+}
+
+void LibraryIndex::rescan()
+{
+	if(!isRunning())
+		return;
+	rescanRequested = true;
+	wake();
+}
+
+void LibraryIndex::stop()
+{
+	if(!isRunning())
+		return;
+	stopRequested = true;
+	wake();
+	thread.join();
+	onUpdateEvent.cancel();
+	for(auto &[path, dir] : dirs)
+		dir.watch = -1;
+	#ifdef __linux__
+	watchPaths.clear();
+	notifyFd.reset();
+	wakeFd.reset();
+	#endif
+}
+
+void LibraryIndex::wake()
+{
+	#ifdef __linux__
+	eventfd_write(wakeFd, 1);
+	#else
+	std::scoped_lock lock{mutex};
+	wakeCondition.notify_one();
+	#endif
+}
+
+std::shared_ptr<const LibrarySnapshot> LibraryIndex::snapshot() const
+{
+	std::scoped_lock lock{mutex};
+	return snapshot_;
+}
+
+bool LibraryIndex::hasChangeNotifications() const
+{
+	#ifdef __linux__
+	if(notifyFd == -1)
+		return false;
+	std::scoped_lock lock{mutex};
+	return std::ranges::none_of(directories_, [](auto &path){ return isUri(path); });
+	#else
+	return false;
+	#endif
+}
+
+void LibraryIndex::run()
+{
+	setThisThreadPriority(workerThreadPriority);
+	if(dirs.empty() && readIndex())
+		publish();
+	bool fullScan = true;
+	while(!stopping())
+	{
+		scanning = true;
+		rescanRequested = false;
+		auto roots = directories();
+		bool changed{};
+		if(fullScan)
+		{
+			for(const auto &root : roots)
+			{
+				changed |= scanDirectory(root, 0, true);
+			}
+		}
+		else
+		{
+			// directories without a watch can't report their own changes
+			for(const auto &[path, dir] : dirs)
+			{
+				if(dir.watch == -1)
+					changedDirs.emplace_back(path);
+			}
+			std::ranges::sort(changedDirs);
+			auto [uniqueEnd, end] = std::ranges::unique(changedDirs);
+			changedDirs.erase(uniqueEnd, end);
+			for(const auto &path : changedDirs)
+			{
+				if(auto it = dirs.find(path); it != dirs.end())
+					changed |= scanDirectory(path, it->second.depth, false);
+			}
+		}
+		changedDirs.clear();
+		if(stopping())
+			break;
+		changed |= pruneDirectories(roots);
+		if(changed)
+			publish();
+		if(addDigests())
+		{
+			changed = true;
+			publish();
+		}
+		if(changed)
+			writeIndex();
+		scanning = false;
+		if(stopping())
+			break;
+		fullScan = waitForChanges();
+	}
+	scanning = false;
+}
+
+bool LibraryIndex::scanDirectory(const std::string &path, int depth, bool recurseKnownDirs)
+{
+	auto status = fileStatus(ctx, path);
+	auto it = dirs.find(path);
+	if(status.type != FS::file_type::directory && status.type != FS::file_type::unknown)
+	{
+		if(it == dirs.end())
+			return false;
+		unwatchDirectory(it->first, it->second);
+		dirs.erase(it);
+		return true;
+	}
+	bool changed{};
+	// a zero time means it's unknown so the directory is always re-listed
+	if(it != dirs.end() && status.lastWriteTime && it->second.lastWriteTime == status.lastWriteTime)
+	{
+		// listing is unchanged, only check for files modified in place
+		auto &dir = it->second;
+		watchDirectory(path, dir);
+		bool filesChanged{};
+		std::vector<LibraryEntry> entries;
+		entries.reserve(dir.entries.size());
+		for(const auto &e : dir.entries)
+		{
+			if(stopping())
+				return changed;
+			filesChanged |= updateFile(e.path, e.name, entries, &dir);
+		}
+		if(filesChanged)
+		{
+			std::ranges::sort(entries, {}, &LibraryEntry::path);
+			dir.entries = std::move(entries);
+			changed = true;
+		}
+		auto subdirs = dir.subdirs;
+		for(const auto &subdir : subdirs)
+		{
+			if(recurseKnownDirs || needsScan(subdir))
+				changed |= scanDirectory(subdir, depth + 1, recurseKnownDirs);
+		}
+		return changed;
+	}
+	Directory newDir{.lastWriteTime = status.lastWriteTime, .depth = uint8_t(depth)};
+	const Directory *prevDir = it != dirs.end() ? &it->second : nullptr;
+	struct ListState
+	{
+		Directory &dir;
+		const Directory *prevDir;
+	} list{newDir, prevDir};
+	try
+	{
+		ctx.forEachInDirectoryUri(path,
+			[this, &list](auto &entry)
+			{
+				if(stopping()) [[unlikely]]
+					return false;
+				if(entry.name().starts_with('.'))
+					return true;
+				if(entry.type() == FS::file_type::directory)
+				{
+					if(list.dir.depth < maxDepth)
+						list.dir.subdirs.emplace_back(entry.path());
+					return true;
+				}
+				updateFile(std::string{entry.path()}, entry.name(), list.dir.entries, list.prevDir);
+				return true;
+			});
+	}
+	catch(std::exception &err)
+	{
+		logErr("error listing %s:%s", path.c_str(), err.what());
+		return false;
+	}
+	if(stopping())
+		return false;
+	std::ranges::sort(newDir.entries, {}, &LibraryEntry::path);
+	if(prevDir)
+	{
+		newDir.watch = std::exchange(it->second.watch, -1);
+		it->second = std::move(newDir);
+	}
+	else
+	{
+		it = dirs.emplace(path, std::move(newDir)).first;
+	}
+	auto &dir = it->second;
+	watchDirectory(path, dir);
+	logMsg("listed %s with %zu entries", path.c_str(), dir.entries.size());
+	auto subdirs = dir.subdirs;
+	for(const auto &subdir : subdirs)
+	{
+		if(recurseKnownDirs || needsScan(subdir))
+			scanDirectory(subdir, depth + 1, recurseKnownDirs);
+	}
+	return true;
+}
+
+bool LibraryIndex::needsScan(const std::string &path) const
+{
+	auto it = dirs.find(path);
+	return it == dirs.end() || it->second.watch == -1;
+}
+
+bool LibraryIndex::updateFile(const std::string &path, std::string_view name, std::vector<LibraryEntry> &entries,
+	const Directory *prevDir)
+{
+	bool isArchive = FS::hasArchiveExtension(name);
+	if(!isArchive && !nameFilter(name))
+		return false;
+	const LibraryEntry *prevEntry{};
+	if(prevDir)
+	{
+		auto prev = std::ranges::equal_range(prevDir->entries, path, {}, &LibraryEntry::path);
+		if(prev.size())
+			prevEntry = &prev.front();
+	}
+	auto status = fileStatus(ctx, path);
+	if(status.type == FS::file_type::not_found || status.type == FS::file_type::directory)
+		return prevEntry;
+	// an archive's entry has the size of its content file, so only its time can be compared
+	if(prevEntry && prevEntry->lastWriteTime == status.lastWriteTime
+		&& (isArchive || isUri(path) || prevEntry->size == status.size))
+	{
+		entries.emplace_back(*prevEntry);
+		return false;
+	}
+	if(isArchive)
+	{
+		// loading an archive uses its first file that passes the filter, so that's the file indexed
+		if(auto index = FS::archiveIndex(path, false))
+		{
+			auto contentEntry = index->findFirst(nameFilter);
+			if(!contentEntry)
+				return prevEntry;
+			entries.emplace_back(LibraryEntry{path, std::string{name}, contentEntry->name, contentEntry->size,
+				status.lastWriteTime, {.crc32 = contentEntry->crc32}});
+		}
+		else
+		{
+			// archives without an index, like those behind URIs, are listed as is and not hashed
+			entries.emplace_back(LibraryEntry{path, std::string{name}, {}, status.size, status.lastWriteTime});
+		}
+	}
+	else
+	{
+		entries.emplace_back(LibraryEntry{path, std::string{name}, {}, status.size, status.lastWriteTime});
+	}
+	return true;
+}
+
+bool LibraryIndex::addDigests()
+{
+	size_t added{};
+	for(auto &[dirPath, dir] : dirs)
+	{
+		for(auto &e : dir.entries)
+		{
+			if(e.hasDigest || e.size > maxDigestSize || (!e.isArchive() && FS::hasArchiveExtension(e.name)))
+				continue;
+			if(stopping() || rescanRequested.load(std::memory_order_relaxed))
+				return added;
+			try
+			{
+				if(e.isArchive())
+				{
+					// bypass the memory caches so hashing doesn't evict what loaded content is using
+					auto index = FS::archiveIndex(e.path, false);
+					auto contentEntry = index ? index->find(e.archiveEntry) : nullptr;
+					if(!contentEntry)
+						continue;
+					auto io = index->open(*contentEntry, false);
+					e.digest = contentDigest(io, contentEntry->crc32);
+				}
+				else
+				{
+					// URIs are listed without a size, so it's only known once the file is opened
+					auto digest = contentDigest(ctx, e.path, maxDigestSize);
+					if(!digest)
+						continue;
+					e.digest = *digest;
+				}
+				e.hasDigest = true;
+				added++;
+			}
+			catch(std::exception &err)
+			{
+				logErr("error reading %s:%s", e.path.c_str(), err.what());
+			}
+		}
+	}
+	if(added)
+		logMsg("added %zu digests", added);
+	return added;
+}
+
+void LibraryIndex::publish()
+{
+	auto snap = std::make_shared<LibrarySnapshot>();
+	size_t entryCount{};
+	for(const auto &[path, dir] : dirs)
+	{
+		entryCount += dir.entries.size();
+	}
+	snap->entries.reserve(entryCount);
+	for(const auto &[path, dir] : dirs)
+	{
+		snap->entries.insert(snap->entries.end(), dir.entries.begin(), dir.entries.end());
+	}
+	std::ranges::sort(snap->entries, [](const LibraryEntry &e1, const LibraryEntry &e2)
+	{
+		if(e1.name == e2.name)
+			return e1.path < e2.path;
+		return caselessLexCompare(e1.name, e2.name);
+	});
+	snap->recentIdxs.resize(snap->entries.size());
+	std::iota(snap->recentIdxs.begin(), snap->recentIdxs.end(), 0);
+	std::ranges::stable_sort(snap->recentIdxs, std::greater{},
+		[&](uint32_t idx){ return snap->entries[idx].lastWriteTime; });
+	logMsg("publishing %zu entries", entryCount);
+	{
+		std::scoped_lock lock{mutex};
+		snapshot_ = std::move(snap);
+	}
+	onUpdateEvent.notify();
+}
+
+bool LibraryIndex::pruneDirectories(const std::vector<std::string> &roots)
+{
+	std::unordered_set<std::string_view> reachable;
+	std::vector<std::string_view> pending{roots.begin(), roots.end()};
+	while(pending.size())
+	{
+		auto path = pending.back();
+		pending.pop_back();
+		auto it = dirs.find(std::string{path});
+		if(it == dirs.end() || !reachable.insert(it->first).second)
+			continue;
+		pending.insert(pending.end(), it->second.subdirs.begin(), it->second.subdirs.end());
+	}
+	if(reachable.size() == dirs.size())
+		return false;
+	for(auto it = dirs.begin(); it != dirs.end();)
+	{
+		if(reachable.contains(it->first))
+		{
+			++it;
+			continue;
+		}
+		unwatchDirectory(it->first, it->second);
+		it = dirs.erase(it);
+	}
+	return true;
+}
+
+#ifdef __linux__
+
+void LibraryIndex::watchDirectory(const std::string &path, Directory &dir)
+{
+	if(notifyFd == -1 || dir.watch != -1 || isUri(path))
+		return;
+	dir.watch = inotify_add_watch(notifyFd, path.c_str(),
+		IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_CLOSE_WRITE | IN_DELETE_SELF | IN_ONLYDIR);
+	if(dir.watch == -1)
+	{
+		logWarn("error watching %s:%s", path.c_str(), strerror(errno));
+		return;
+	}
+	watchPaths.insert_or_assign(dir.watch, path);
+}
+
+void LibraryIndex::unwatchDirectory(const std::string &path, Directory &dir)
+{
+	if(dir.watch == -1)
+		return;
+	// a renamed directory keeps its watch descriptor, which may now belong to the new path
+	if(auto it = watchPaths.find(dir.watch); it != watchPaths.end() && it->second == path)
+	{
+		inotify_rm_watch(notifyFd, dir.watch);
+		watchPaths.erase(it);
+	}
+	dir.watch = -1;
+}
+
+bool LibraryIndex::waitForChanges()
+{
+	std::array<pollfd, 2> fds{{{wakeFd, POLLIN, 0}, {notifyFd, POLLIN, 0}}};
+	nfds_t fdCount = notifyFd != -1 ? 2 : 1;
+	int timeout = -1;
+	while(true)
+	{
+		if(poll(fds.data(), fdCount, timeout) == -1)
+		{
+			if(errno == EINTR)
+				continue;
+			logErr("error polling for changes:%s", strerror(errno));
+			return true;
+		}
+		if(fds[0].revents)
+		{
+			eventfd_t val;
+			eventfd_read(wakeFd, &val);
+			if(stopping() || rescanRequested)
+				return true;
+		}
+		if(fdCount == 2 && fds[1].revents)
+		{
+			alignas(inotify_event) char buff[4096];
+			ssize_t len;
+			while((len = read(notifyFd, buff, sizeof(buff))) > 0)
+			{
+				for(auto ptr = buff; ptr < buff + len;)
+				{
+					auto &ev = *reinterpret_cast<const inotify_event*>(ptr);
+					ptr += sizeof(inotify_event) + ev.len;
+					if(ev.mask & IN_Q_OVERFLOW)
+						return true;
+					if(auto it = watchPaths.find(ev.wd); it != watchPaths.end())
+					{
+						// deleting a directory changes its parent, which gets re-listed instead
+						if(!(ev.mask & (IN_DELETE_SELF | IN_IGNORED)))
+							changedDirs.emplace_back(it->second);
+						if(ev.mask & IN_IGNORED)
+						{
+							if(auto dirIt = dirs.find(it->second); dirIt != dirs.end())
+								dirIt->second.watch = -1;
+							watchPaths.erase(it);
+						}
+					}
+				}
+			}
+			// rescan once notifications have stopped for a moment to batch up large copies
+			timeout = changeSettleMSecs;
+			continue;
+		}
+		if(!fds[0].revents && !fds[1].revents)
+		{
+			if(changedDirs.size())
+			{
+				logMsg("rescanning %zu changed directories", changedDirs.size());
+				return false;
+			}
+			timeout = -1;
+		}
+	}
+}
+
+#else
+
+void LibraryIndex::watchDirectory(const std::string &, Directory &) {}
+
+void LibraryIndex::unwatchDirectory(const std::string &, Directory &) {}
+
+bool LibraryIndex::waitForChanges()
+{
+	std::unique_lock lock{mutex};
+	wakeCondition.wait(lock, [&](){ return stopping() || rescanRequested; });
+	return true;
+}
+
+#endif
+
+bool LibraryIndex::readIndex()
+{
+	if(cachePath.empty())
+		return false;
+	MapIO io{FileUtils::bufferFromPath(cachePath, OpenFlagsMask::Test)};
+	if(!io)
+		return false;
+	if(io.get<uint32_t>() != indexMagic || io.get<uint32_t>() != indexVersion)
+	{
+		logMsg("ignoring library index with old format");
+		return false;
+	}
+	uint32_t dirCount{};
+	if(!readCount(io, dirCount))
+	{
+		logErr("library index is corrupt");
+		return false;
+	}
+	dirs.reserve(dirCount);
+	std::string dirPath;
+	auto readEntry = [&](LibraryEntry &e)
+	{
+		auto flags = io.get<uint8_t>();
+		if(!(flags & PATH_IN_DIR) && !readString(io, e.path))
+			return false;
+		if(!readString(io, e.name) || !readString(io, e.archiveEntry)
+			|| !readValue(io, e.size) || !readValue(io, e.lastWriteTime))
+			return false;
+		if(flags & PATH_IN_DIR)
+			e.path = FS::pathString(dirPath, e.name);
+		if(flags & HAS_DIGEST)
+		{
+			if(!readValue(io, e.digest))
+				return false;
+			e.hasDigest = true;
+		}
+		return true;
+	};
+	auto readDirectory = [&]()
+	{
+		Directory dir;
+		uint32_t subdirCount{}, entryCount{};
+		if(!readString(io, dirPath) || !readValue(io, dir.lastWriteTime) || !readValue(io, dir.depth)
+			|| !readCount(io, subdirCount))
+			return false;
+		dir.subdirs.resize(subdirCount);
+		if(!std::ranges::all_of(dir.subdirs, [&](auto &s){ return readString(io, s); }) || !readCount(io, entryCount))
+			return false;
+		dir.entries.resize(entryCount);
+		if(!std::ranges::all_of(dir.entries, readEntry))
+			return false;
+		dirs.insert_or_assign(dirPath, std::move(dir));
+		return true;
+	};
+	for([[maybe_unused]] auto i : iotaCount(dirCount))
+	{
+		if(!readDirectory())
+		{
+			logErr("library index is corrupt");
+			dirs.clear();
+			return false;
+		}
+	}
+	logMsg("loaded %u directories from library index", dirCount);
+	return true;
+}
+
+void LibraryIndex::writeIndex() const
+{
+	if(cachePath.empty())
+		return;
+	auto tempPath = FS::pathString(FS::dirname(cachePath), ".libraryIndex.tmp");
+	{
+		FileIO io{tempPath, OpenFlagsMask::New | OpenFlagsMask::Test};
+		if(!io)
+		{
+			logErr("error creating %s", tempPath.c_str());
+			return;
+		}
+		bool writeOK = true;
+		auto put = [&](const auto &val){ writeOK &= io.put(val) == ssize_t(sizeof(val)); };
+		auto putString = [&](std::string_view str){ writeOK &= writeString(io, str); };
+		put(indexMagic);
+		put(indexVersion);
+		put(uint32_t(dirs.size()));
+		for(const auto &[path, dir] : dirs)
+		{
+			putString(path);
+			put(dir.lastWriteTime);
+			put(dir.depth);
+			put(uint32_t(dir.subdirs.size()));
+			for(const auto &s : dir.subdirs)
+			{
+				putString(s);
+			}
+			put(uint32_t(dir.entries.size()));
+			for(const auto &e : dir.entries)
+			{
+				bool pathInDir = !isUri(e.path) && e.path == std::string_view{FS::pathString(path, e.name)};
+				put(uint8_t((e.hasDigest ? HAS_DIGEST : 0) | (pathInDir ? PATH_IN_DIR : 0)));
+				if(!pathInDir)
+					putString(e.path);
+				putString(e.name);
+				putString(e.archiveEntry);
+				put(e.size);
+				put(e.lastWriteTime);
+				if(e.hasDigest)
+					put(e.digest);
+			}
+		}
+		if(!writeOK)
+		{
+			logErr("error writing %s", tempPath.c_str());
+			io = {};
+			FS::remove(tempPath);
+			return;
+		}
+	}
+	if(!FS::rename(tempPath, cachePath))
+		logErr("error renaming %s", tempPath.c_str());
+}
+
+bool LibraryIndex::readConfig(MapIO &io, unsigned key, size_t size)
+{
+	if(key != CFGKEY_LIBRARY_PATHS)
+		return false;
+	std::scoped_lock lock{mutex};
+	directories_.clear();
+	std::string path;
+	while(size >= 2)
+	{
+		auto len = io.get<uint16_t>();
+		size -= 2;
+		if(len > size || io.readSized(path, len) != len)
+		{
+			logErr("error reading library paths");
+			break;
+		}
+		size -= len;
+		if(path.size() && !contains(directories_, path))
+			directories_.emplace_back(path);
+	}
+	return true;
+}
+
+void LibraryIndex::writeConfig(FileIO &io) const
+{
+	std::scoped_lock lock{mutex};
+	if(directories_.empty())
+		return;
+	size_t strSizes = 0;
+	for(const auto &path : directories_)
+	{
+		strSizes += 2 + path.size();
+	}
+	writeOptionValueHeader(io, CFGKEY_LIBRARY_PATHS, strSizes);
+	for(const auto &path : directories_)
+	{
+		writeString(io, path);
+	}
+}
+
+}
@@ -0,0 +1,288 @@
+/*  This file is part of EmuFramework.
+
+	Imagine is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Imagine is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with EmuFramework.  If not, see <http://www.gnu.org/licenses/> */
+
+#define LOGTAG "RewindManager"
+#include <emuframework/RewindManager.hh>
+#include <emuframework/EmuSystem.hh>
+#include <emuframework/Option.hh>
+#include "EmuOptions.hh"
+#include <imagine/io/MapIO.hh>
+#include <imagine/io/FileIO.hh>
+#include <imagine/util/math/int.hh>
+#include <imagine/util/ranges.hh>
+#include <imagine/logger/logger.h>
+#include <cstring>
+
+namespace EmuEx
+{
+
+constexpr size_t MiB = 1024 * 1024;
+
+// Delta encoding is a series of blocks, each one a header of unchanged and changed word counts
+// followed by the changed words XOR'd with the previous snapshot
+
+struct DeltaBlockHeader
+{
+	uint32_t unchangedWords;
+	uint32_t changedWords;
+};
+
+static size_t maxDeltaSize(size_t words)
+{
+	// worst case alternates unchanged and changed words
+	return words * sizeof(uint64_t) + (words / 2 + 1) * sizeof(DeltaBlockHeader);
+}
+
+size_t RewindManager::encodeDelta(std::span<const Word> curr, std::span<const Word> prev, uint8_t *out)
+{
+	assumeExpr(curr.size() == prev.size());
+	auto outStart = out;
+	size_t i = 0;
+	const auto words = curr.size();
+	while(i < words)
+	{
+		auto unchangedStart = i;
+		while(i < words && curr[i] == prev[i])
+			i++;
+		if(i == words)
+			break;
+		auto changedStart = i;
+		while(i < words && curr[i] != prev[i])
+			i++;
+		DeltaBlockHeader header{uint32_t(changedStart - unchangedStart), uint32_t(i - changedStart)};
+		memcpy(out, &header, sizeof(header));
+		out += sizeof(header);
+		for(auto w = changedStart; w < i; w++)
+		{
+			Word delta = curr[w] ^ prev[w];
+			memcpy(out, &delta, sizeof(delta));
+			out += sizeof(delta);
+		}
+	}
+	return out - outStart;
+}
+
+void RewindManager::applyDelta(std::span<Word> state, const uint8_t *delta, size_t deltaSize)
+{
+	auto deltaEnd = delta + deltaSize;
+	size_t i = 0;
+	while(delta < deltaEnd)
+	{
+		DeltaBlockHeader header;
+		memcpy(&header, delta, sizeof(header));
+		delta += sizeof(header);
+		i += header.unchangedWords;
+		assumeExpr(i + header.changedWords <= state.size());
+		for(auto w : iotaCount(header.changedWords))
+		{
+			Word d;
+			memcpy(&d, delta, sizeof(d));
+			delta += sizeof(d);
+			state[i + w] ^= d;
+		}
+		i += header.changedWords;
+	}
+}
+
+void RewindManager::resizeStateBuffers(size_t stateSize)
+{
+	auto words = divRoundUp(stateSize, sizeof(Word));
+	if(words <= prevState.size())
+		return;
+	// extra space is zero-filled so the XOR deltas stay valid when the state size changes
+	prevState.resize(words);
+	currState.resize(words);
+	deltaBuff.resize(maxDeltaSize(words));
+}
+
+size_t RewindManager::saveStateToBuffer(EmuSystem &sys)
+{
+	if(!stateSizeHint)
+	{
+		stateSizeHint = sys.stateSize();
+		resizeStateBuffers(stateSizeHint);
+	}
+	std::span<uint8_t> stateBytes{reinterpret_cast<uint8_t*>(currState.data()), currState.size() * sizeof(Word)};
+	size_t size;
+	try
+	{
+		size = sys.saveState(stateBytes);
+	}
+	catch(...)
+	{
+		// state may have grown since the last size query
+		stateSizeHint = sys.stateSize();
+		resizeStateBuffers(stateSizeHint);
+		stateBytes = {reinterpret_cast<uint8_t*>(currState.data()), currState.size() * sizeof(Word)};
+		size = sys.saveState(stateBytes);
+	}
+	std::fill(stateBytes.begin() + size, stateBytes.end(), 0);
+	return size;
+}
+
+uint8_t *RewindManager::allocEntry(size_t size)
+{
+	if(size > ring.size())
+		return nullptr;
+	if(writeOffset + size > ring.size())
+	{
+		// drop entries from the previous pass that are past the write position, then wrap around
+		while(entries.size() && entries.front().offset >= writeOffset)
+		{
+			stats_.usedBytes -= entries.front().size;
+			entries.pop_front();
+		}
+		writeOffset = 0;
+	}
+	while(entries.size() && entries.front().offset >= writeOffset
+		&& entries.front().offset < writeOffset + size)
+	{
+		stats_.usedBytes -= entries.front().size;
+		entries.pop_front();
+	}
+	entries.emplace_back(writeOffset, uint32_t(size), 0);
+	stats_.usedBytes += size;
+	auto dest = &ring[writeOffset];
+	writeOffset += size;
+	return dest;
+}
+
+void RewindManager::capture(EmuSystem &sys)
+{
+	if(ring.empty())
+		ring.resize(maxMemoryMiB * MiB);
+	auto startTime = SteadyClock::now();
+	try
+	{
+		auto size = saveStateToBuffer(sys);
+		auto deltaSize = encodeDelta(currState, prevState, deltaBuff.data());
+		auto dest = allocEntry(deltaSize);
+		if(!dest)
+		{
+			logErr("%zu byte snapshot doesn't fit in rewind buffer", deltaSize);
+			return;
+		}
+		memcpy(dest, deltaBuff.data(), deltaSize);
+		entries.back().stateSize = size;
+		std::swap(prevState, currState);
+		stats_.lastSnapshotBytes = deltaSize;
+		stats_.stateBytes = size;
+	}
+	catch(std::exception &err)
+	{
+		logErr("error capturing snapshot:%s", err.what());
+		return;
+	}
+	stats_.snapshots = entries.size();
+	stats_.lastCaptureTime = SteadyClock::now() - startTime;
+}
+
+void RewindManager::onFramesRun(EmuSystem &sys, int frames)
+{
+	if(!isEnabled())
+		return;
+	inRewind = false;
+	framesSinceSnapshot += frames;
+	if(framesSinceSnapshot < snapshotInterval_)
+		return;
+	framesSinceSnapshot = 0;
+	capture(sys);
+}
+
+bool RewindManager::rewindFrame(EmuSystem &sys)
+{
+	if(entries.empty())
+		return false;
+	if(!inRewind)
+	{
+		inRewind = true;
+		logMsg("rewinding %zu snapshot(s) using %zu bytes, last snapshot:%zu/%zu bytes capture:%.3fms restore:%.3fms",
+			stats_.snapshots, stats_.usedBytes, stats_.lastSnapshotBytes, stats_.stateBytes,
+			std::chrono::duration<double, std::milli>(stats_.lastCaptureTime).count(),
+			std::chrono::duration<double, std::milli>(stats_.lastRestoreTime).count());
+	}
+	auto startTime = SteadyClock::now();
+	auto &e = entries.back();
+	try
+	{
+		sys.loadState({reinterpret_cast<const uint8_t*>(prevState.data()), e.stateSize});
+	}
+	catch(std::exception &err)
+	{
+		logErr("error restoring snapshot:%s", err.what());
+	}
+	// keep the oldest snapshot so holding rewind stays on it
+	if(entries.size() > 1)
+	{
+		applyDelta(prevState, &ring[e.offset], e.size);
+		writeOffset = e.offset;
+		stats_.usedBytes -= e.size;
+		entries.pop_back();
+		stats_.snapshots = entries.size();
+	}
+	framesSinceSnapshot = 0;
+	stats_.lastRestoreTime = SteadyClock::now() - startTime;
+	return true;
+}
+
+void RewindManager::reset()
+{
+	ring = std::vector<uint8_t>{};
+	prevState = std::vector<Word>{};
+	currState = std::vector<Word>{};
+	deltaBuff = std::vector<uint8_t>{};
+	entries.clear();
+	writeOffset = 0;
+	stateSizeHint = 0;
+	framesSinceSnapshot = 0;
+	inRewind = false;
+	stats_ = {};
+}
+
+void RewindManager::setRewinding(bool on)
+{
+	rewinding.store(on && isEnabled(), std::memory_order_relaxed);
+}
+
+void RewindManager::setMaxMemory(uint16_t mib)
+{
+	if(mib == maxMemoryMiB)
+		return;
+	maxMemoryMiB = mib;
+	reset();
+}
+
+void RewindManager::setSnapshotInterval(uint8_t frames)
+{
+	snapshotInterval_ = std::max(frames, uint8_t(1));
+}
+
+bool RewindManager::readConfig(MapIO &io, unsigned key, size_t size)
+{
+	switch(key)
+	{
+		default: return false;
+		case CFGKEY_REWIND_MAX_MEMORY: return readOptionValue(io, size, maxMemoryMiB, [](auto m){return m <= 1024;});
+		case CFGKEY_REWIND_SNAPSHOT_INTERVAL: return readOptionValue(io, size, snapshotInterval_, [](auto i){return i >= 1;});
+	}
+}
+
+void RewindManager::writeConfig(FileIO &io) const
+{
+	writeOptionValueIfNotDefault(io, CFGKEY_REWIND_MAX_MEMORY, maxMemoryMiB, defaultMaxMemoryMiB);
+	writeOptionValueIfNotDefault(io, CFGKEY_REWIND_SNAPSHOT_INTERVAL, snapshotInterval_, defaultSnapshotInterval);
+}
+
+}
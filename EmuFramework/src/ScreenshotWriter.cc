@@ -0,0 +1,153 @@
+/*  This file is part of EmuFramework.
+
+	Imagine is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Imagine is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with EmuFramework.  If not, see <http://www.gnu.org/licenses/> */
+
+#define LOGTAG "ScreenshotWriter"
+#include <emuframework/ScreenshotWriter.hh>
+#include <emuframework/EmuApp.hh>
+#include <imagine/util/ranges.hh>
+#include <imagine/logger/logger.h>
+#include <format>
+
+namespace EmuEx
+{
+
+ScreenshotWriter::~ScreenshotWriter()
+{
+	if(!thread.joinable())
+		return;
+	quit.store(true, std::memory_order_relaxed);
+	workSem.release();
+	thread.join();
+}
+
+void ScreenshotWriter::start()
+{
+	for(auto i : iotaCount(poolSize))
+	{
+		freeJobs.push(i);
+	}
+	thread = std::thread{[this](){ run(); }};
+}
+
+bool ScreenshotWriter::capture(PixmapView pix, const FS::PathString &path)
+{
+	if(!thread.joinable())
+		start();
+	auto idx = freeJobs.pop();
+	if(!idx)
+	{
+		if(inBurst_)
+		{
+			burstDropped.fetch_add(1, std::memory_order_relaxed);
+		}
+		else
+		{
+			logErr("no free buffer for screenshot");
+			postResult(false);
+		}
+		return false;
+	}
+	auto &job = jobs[*idx];
+	if(job.pix.desc() != pix.desc())
+		job.pix = MemPixmap{pix.desc()};
+	job.pix.view().write(pix);
+	job.path = path;
+	job.burstId = inBurst_ ? burstId : 0;
+	job.burstFrame = burstFrames_;
+	if(inBurst_)
+		burstFrames_++;
+	queuedJobs.push(*idx);
+	workSem.release();
+	return true;
+}
+
+void ScreenshotWriter::beginBurst()
+{
+	inBurst_ = true;
+	if(!++burstId) // skip 0, it marks non-burst jobs
+		burstId = 1;
+	burstFrames_ = 0;
+	burstWritten.store(0, std::memory_order_relaxed);
+	burstFailed.store(0, std::memory_order_relaxed);
+	burstDropped.store(0, std::memory_order_relaxed);
+}
+
+void ScreenshotWriter::endBurst()
+{
+	if(!inBurst_)
+		return;
+	inBurst_ = false;
+	// the writer thread posts the summary after any queued frames
+	burstEnded.store(true, std::memory_order_release);
+	workSem.release();
+}
+
+void ScreenshotWriter::run()
+{
+	while(true)
+	{
+		workSem.acquire();
+		// check for the end of a burst before draining so its last frames are counted
+		auto burstFinished = burstEnded.exchange(false, std::memory_order_acquire);
+		while(auto idx = queuedJobs.pop())
+		{
+			auto &job = jobs[*idx];
+			auto success = app.writeScreenshot(job.pix.view(), job.burstId ? burstPath(job) : job.path);
+			if(job.burstId)
+				(success ? burstWritten : burstFailed).fetch_add(1, std::memory_order_relaxed);
+			else
+				postResult(success);
+			freeJobs.push(*idx);
+		}
+		if(burstFinished)
+		{
+			BurstResult res{burstWritten.load(std::memory_order_relaxed), burstFailed.load(std::memory_order_relaxed),
+				burstDropped.load(std::memory_order_relaxed)};
+			logMsg("burst finished, wrote:%d failed:%d dropped:%d", res.written, res.failed, res.dropped);
+			app.appContext().runOnMainThread([res](ApplicationContext ctx)
+			{
+				EmuApp::get(ctx).postMessage(3, res.failed, std::format("Wrote {} screenshots ({} failed, {} dropped)",
+					res.written, res.failed, res.dropped));
+			});
+		}
+		if(quit.load(std::memory_order_relaxed))
+			return;
+	}
+}
+
+FS::PathString ScreenshotWriter::burstPath(const Job &job)
+{
+	if(job.burstId != burstBaseId)
+	{
+		// date & directory are resolved once per burst, frames only append their index
+		burstBaseId = job.burstId;
+		burstBasePath = app.makeNextScreenshotFilename();
+		if(burstBasePath.ends_with(".png"))
+			burstBasePath.resize(burstBasePath.size() - 4);
+	}
+	auto path = burstBasePath;
+	path.append(std::format("-{:04}.png", job.burstFrame));
+	return path;
+}
+
+void ScreenshotWriter::postResult(bool success)
+{
+	app.appContext().runOnMainThread([&app = app, success](ApplicationContext)
+	{
+		app.printScreenshotResult(success);
+	});
+}
+
+}
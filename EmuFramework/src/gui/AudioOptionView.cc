@@ -102,6 +102,30 @@ AudioOptionView::AudioOptionView(ViewAttachParams attach, bool customMenu):
 			app().audio().addSoundBuffersOnUnderrunSetting = item.flipBoolValue(*this);
 		}
 	},
+	resamplerItem
+	{
+		{"Fast",  &defaultFace(), MenuItem::Id(AudioResamplerQuality::fast)},
+		{"Cubic", &defaultFace(), MenuItem::Id(AudioResamplerQuality::cubic)},
+		{"Sinc",  &defaultFace(), MenuItem::Id(AudioResamplerQuality::sinc)},
+	},
+	resampler
+	{
+		"Fast/Slow Mode Resampler", &defaultFace(),
+		{
+			.defaultItemOnSelect = [this](TextMenuItem &item) { app().audio().setResamplerQuality(AudioResamplerQuality(item.id())); }
+		},
+		MenuItem::Id(app().audio().resamplerQuality()),
+		resamplerItem
+	},
+	dynamicRateControl
+	{
+		"Dynamic Rate Control", &defaultFace(),
+		app().audio().dynamicRateControlEnabled(),
+		[this](BoolMenuItem &item)
+		{
+			app().audio().setDynamicRateControl(item.flipBoolValue(*this));
+		}
+	},
 	audioRateItem
 	{
 		[&]
@@ -178,6 +202,7 @@ void AudioOptionView::loadStockItems()
 {
 	item.emplace_back(&snd);
 	item.emplace_back(&soundDuringFastSlowMode);
+	item.emplace_back(&resampler);
 	item.emplace_back(&soundVolume);
 	if(!EmuSystem::forcedSoundRate)
 	{
@@ -185,6 +210,7 @@ void AudioOptionView::loadStockItems()
 	}
 	item.emplace_back(&soundBuffers);
 	item.emplace_back(&addSoundBuffersOnUnderrun);
+	item.emplace_back(&dynamicRateControl);
 	if constexpr(IG::Audio::Manager::HAS_SOLO_MIX)
 	{
 		item.emplace_back(&audioSoloMix);
@@ -18,6 +18,7 @@
 #include <imagine/logger/logger.h>
 #include <cstdio>
 #include <format>
+#include <string_view>
 
 namespace EmuEx
 {
@@ -44,9 +45,32 @@ CPUAffinityView::CPUAffinityView(ViewAttachParams attach, int cpuCount):
 		MenuItem::Id(uint8_t(app().cpuAffinityMode)),
 		affinityModeItems
 	},
+	schedulingPolicyItems
+	{
+		{"Off",                                                     &defaultFace(), to_underlying(ThreadSchedulingPolicy::Normal)},
+		{"FIFO (Threads run until they block or yield)",            &defaultFace(), to_underlying(ThreadSchedulingPolicy::FIFO)},
+		{"Round Robin (Equal priority threads share time slices)",  &defaultFace(), to_underlying(ThreadSchedulingPolicy::RoundRobin)},
+	},
+	schedulingPolicy
+	{
+		"Real-time Scheduling", &defaultFace(),
+		{
+			.onSetDisplayString = [this](auto idx, Gfx::Text &t)
+			{
+				constexpr std::string_view names[]{"Off", "FIFO", "Round Robin"};
+				t.resetString(names[schedulingPolicyItems[idx].id()]);
+				return true;
+			},
+			.defaultItemOnSelect = [this](TextMenuItem &item) { app().threadSchedulingPolicy = ThreadSchedulingPolicy(item.id()); }
+		},
+		MenuItem::Id(doIfUsed(app().threadSchedulingPolicy, [](auto p){ return uint8_t(p); })),
+		schedulingPolicyItems
+	},
 	cpusHeading{"Manual CPU Affinity", &defaultBoldFace()}
 {
 	menuItems.emplace_back(&affinityMode);
+	if(used(app().threadSchedulingPolicy))
+		menuItems.emplace_back(&schedulingPolicy);
 	menuItems.emplace_back(&cpusHeading);
 	cpuAffinityItems.reserve(cpuCount);
 	for(int i : iotaCount(cpuCount))
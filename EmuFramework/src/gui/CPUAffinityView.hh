@@ -34,6 +34,8 @@ public:
 protected:
 	TextMenuItem affinityModeItems[3];
 	MultiChoiceMenuItem affinityMode;
+	TextMenuItem schedulingPolicyItems[3];
+	MultiChoiceMenuItem schedulingPolicy;
 	TextHeadingMenuItem cpusHeading;
 	std::vector<BoolMenuItem> cpuAffinityItems;
 	std::vector<MenuItem*> menuItems{};
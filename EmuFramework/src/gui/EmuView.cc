@@ -17,6 +17,8 @@
 #include <emuframework/EmuVideoLayer.hh>
 #include <emuframework/EmuSystem.hh>
 #include <emuframework/OutputTimingManager.hh>
+#include <emuframework/EmuAudio.hh>
+#include <emuframework/AdaptiveFrameSkip.hh>
 #include <imagine/input/Input.hh>
 #include <imagine/base/Screen.hh>
 #include <algorithm>
@@ -36,9 +38,6 @@ EmuView::EmuView(ViewAttachParams attach, EmuVideoLayer *layer, EmuSystem &sys):
 void EmuView::prepareDraw()
 {
 	doIfUsed(frameTimeStats, [&](auto &stats){ stats.text.makeGlyphs(renderer()); });
-	#ifdef CONFIG_EMUFRAMEWORK_AUDIO_STATS
-	audioStatsText.makeGlyphs(renderer());
-	#endif
 }
 
 void EmuView::draw(Gfx::RendererCommands &__restrict__ cmds)
@@ -48,18 +47,6 @@ void EmuView::draw(Gfx::RendererCommands &__restrict__ cmds)
 	{
 		layer->draw(cmds);
 	}
-	#ifdef CONFIG_EMUFRAMEWORK_AUDIO_STATS
-	if(audioStatsText.isVisible())
-	{
-		cmds.setCommonProgram(CommonProgram::NO_TEX);
-		cmds.setBlendMode(BLEND_MODE_ALPHA);
-		cmds.setColor(0., 0., 0., .7);
-		GeomRect::draw(cmds, audioStatsRect);
-		cmds.setCommonProgram(CommonProgram::TEX_ALPHA);
-		audioStatsText.draw(cmds, audioStatsRect.x + TableView::globalXIndent,
-			audioStatsRect.yCenter(), LC2DO, ColorName::WHITE);
-	}
-	#endif
 }
 
 void EmuView::drawframeTimeStatsText(Gfx::RendererCommands &__restrict__ cmds)
@@ -85,14 +72,6 @@ void EmuView::place()
 		layer->place(viewRect(), displayRect(), inputView, system());
 	}
 	placeFrameTimeStats();
-	#ifdef CONFIG_EMUFRAMEWORK_AUDIO_STATS
-	if(audioStatsText.compile(renderer()))
-	{
-		audioStatsRect = viewRect.bounds();
-		audioStatsRect.y2 = (audioStatsRect.y + audioStatsText.nominalHeight * audioStatsText.lines)
-			+ audioStatsText.nominalHeight / 2; // adjust to bottom
-	}
-	#endif
 }
 
 void EmuView::placeFrameTimeStats()
@@ -113,18 +92,22 @@ bool EmuView::inputEvent(const Input::Event &e)
 	return false;
 }
 
-void EmuView::updateFrameTimeStats(FrameTimeStats stats, SteadyClockTimePoint currentFrameTimestamp)
+void EmuView::updateFrameTimeStats(FrameTimeStats stats, AudioStats audioStats, FrameSkipStats skipStats, SteadyClockTimePoint currentFrameTimestamp)
 {
 	auto screenFrameTime = duration_cast<Milliseconds>(screen()->frameTime());
 	auto deadline = duration_cast<Milliseconds>(screen()->presentationDeadline());
 	auto timestampDiff = duration_cast<Milliseconds>(currentFrameTimestamp - stats.startOfFrame);
 	auto callbackOverhead = duration_cast<Milliseconds>(stats.startOfEmulation - stats.startOfFrame);
-	auto emulationTime = duration_cast<Milliseconds>(stats.aboutToSubmitFrame - stats.startOfEmulation);
+	bool usedRunAhead = stats.startOfRunAhead > stats.startOfEmulation;
+	auto emulationTime = duration_cast<Milliseconds>((usedRunAhead ? stats.startOfRunAhead : stats.aboutToSubmitFrame) - stats.startOfEmulation);
+	auto runAheadTime = usedRunAhead ? duration_cast<Milliseconds>(stats.endOfRunAhead - stats.startOfRunAhead) : Milliseconds{};
 	auto submitFrameTime = duration_cast<Milliseconds>(stats.aboutToPostDraw - stats.aboutToSubmitFrame);
 	auto postDrawTime = duration_cast<Milliseconds>(stats.startOfDraw - stats.aboutToPostDraw);
 	auto drawTime = duration_cast<Milliseconds>(stats.aboutToPresent - stats.startOfDraw);
 	auto presentTime = duration_cast<Milliseconds>(stats.endOfDraw - stats.aboutToPresent);
 	auto frameTime = duration_cast<Milliseconds>(stats.endOfDraw - stats.startOfFrame);
+	auto commandLatency = duration_cast<Microseconds>(stats.commandLatency);
+	auto commandJitter = duration_cast<Microseconds>(stats.commandJitter);
 	doIfUsed(frameTimeStats, [&](auto &statsUI)
 	{
 		statsUI.text.resetString(std::format("Frame Time Stats\n\n"
@@ -132,33 +115,28 @@ void EmuView::updateFrameTimeStats(FrameTimeStats stats, SteadyClockTimePoint cu
 			"Deadline: {}ms\n"
 			"Timestamp Diff: {}ms\n"
 			"Frame Callback: {}ms\n"
+			"Command Latency: {}us (jitter {}us)\n"
 			"Emulate: {}ms\n"
+			"Run-ahead: {}ms\n"
 			"Submit Frame: {}ms\n"
 			"Draw Callback: {}ms\n"
 			"Draw: {}ms\n"
 			"Present: {}ms\n"
 			"Total: {}ms\n"
-			"Missed Callbacks: {}",
-			screenFrameTime.count(), deadline.count(), timestampDiff.count(), callbackOverhead.count(), emulationTime.count(), submitFrameTime.count(),
-			postDrawTime.count(), drawTime.count(), presentTime.count(), frameTime.count(), stats.missedFrameCallbacks));
+			"Missed Callbacks: {}\n"
+			"Audio Latency: {}ms (buffer {}ms, device {}ms)\n"
+			"Audio Rate Correction: {:+.3f}%\n"
+			"Audio Underruns: {} Overruns: {}\n"
+			"Effective FPS: {:.1f} (skipped {:.1f}%)",
+			screenFrameTime.count(), deadline.count(), timestampDiff.count(), callbackOverhead.count(),
+			commandLatency.count(), commandJitter.count(), emulationTime.count(), runAheadTime.count(), submitFrameTime.count(),
+			postDrawTime.count(), drawTime.count(), presentTime.count(), frameTime.count(), stats.missedFrameCallbacks,
+			duration_cast<Milliseconds>(audioStats.bufferLatency + audioStats.deviceLatency).count(),
+			duration_cast<Milliseconds>(audioStats.bufferLatency).count(), duration_cast<Milliseconds>(audioStats.deviceLatency).count(),
+			(audioStats.rateCorrection - 1.f) * 100.f, audioStats.underruns, audioStats.overruns,
+			skipStats.effectiveFps, skipStats.skippedPercent));
 		placeFrameTimeStats();
 	});
 }
 
-void EmuView::updateAudioStats(int underruns, int overruns, int callbacks, double avgCallbackFrames, int frames)
-{
-	#ifdef CONFIG_EMUFRAMEWORK_AUDIO_STATS
-	audioStatsText.setString(std::format("Underruns:{}\nOverruns:{}\nCallbacks per second:{}\nFrames per callback:{:g}\nTotal frames:{}",
-		underruns, overruns, callbacks, avgCallbackFrames, frames), &View::defaultFace);
-	place();
-	#endif
-}
-
-void EmuView::clearAudioStats()
-{
-	#ifdef CONFIG_EMUFRAMEWORK_AUDIO_STATS
-	audioStatsText.setString(nullptr);
-	#endif
-}
-
 }
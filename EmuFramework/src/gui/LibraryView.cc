@@ -0,0 +1,167 @@
+/*  This file is part of EmuFramework.
+
+	Imagine is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Imagine is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with EmuFramework.  If not, see <http://www.gnu.org/licenses/> */
+
+#include "LibraryView.hh"
+#include <emuframework/EmuApp.hh>
+#include <emuframework/FilePicker.hh>
+#include <imagine/gui/AlertView.hh>
+#include <imagine/base/ApplicationContext.hh>
+#include <imagine/io/IO.hh>
+#include <imagine/util/format.hh>
+#include <imagine/util/ranges.hh>
+
+namespace EmuEx
+{
+
+LibraryView::LibraryView(ViewAttachParams attach, LibraryIndex &index):
+	TableView{"Library", attach, item},
+	index{index},
+	recentFirst
+	{
+		"Sort By", &defaultFace(),
+		false,
+		"Name", "Recently Modified",
+		[this](BoolMenuItem &item)
+		{
+			item.flipBoolValue(*this);
+			loadItems();
+			highlightCell(0);
+			place();
+		}
+	},
+	folders
+	{
+		"Folders", &defaultFace(),
+		[this](const Input::Event &e)
+		{
+			pushAndShow(makeView<LibraryFoldersView>(this->index), e);
+		}
+	},
+	contentHeading{"", &defaultBoldFace()}
+{
+	index.setOnUpdate([this]()
+	{
+		auto selectedCell = selected;
+		loadItems();
+		highlightCell(selectedCell);
+		place();
+		show();
+	});
+	loadItems();
+	// without change notifications, check the folders for changes since the last scan each time the library is opened
+	if(!index.hasChangeNotifications())
+		index.rescan();
+}
+
+LibraryView::~LibraryView()
+{
+	index.setOnUpdate({});
+}
+
+void LibraryView::loadItems()
+{
+	snapshot = index.snapshot();
+	item.clear();
+	content.clear();
+	item.emplace_back(&recentFirst);
+	item.emplace_back(&folders);
+	item.emplace_back(&contentHeading);
+	size_t entries = snapshot ? snapshot->entries.size() : 0;
+	if(!entries)
+	{
+		contentHeading.setName(index.isScanning() ? "Scanning..." : "No Content Found");
+		return;
+	}
+	contentHeading.setName(std::format("{} Items", entries));
+	content.reserve(entries);
+	item.reserve(item.size() + entries);
+	for(auto i : iotaCount(entries))
+	{
+		auto idx = recentFirst.boolValue() ? snapshot->recentIdxs[i] : i;
+		auto &entryItem = content.emplace_back(snapshot->entries[idx].name, &defaultFace(),
+			[this, idx](const Input::Event &e)
+			{
+				auto &entry = snapshot->entries[idx];
+				app().createSystemWithMedia({}, entry.path, entry.name, e, {}, attachParams(),
+					[this](const Input::Event &e)
+					{
+						app().launchSystem(e);
+					});
+			});
+		item.emplace_back(&entryItem);
+	}
+}
+
+LibraryFoldersView::LibraryFoldersView(ViewAttachParams attach, LibraryIndex &index):
+	TableView{"Library Folders", attach, item},
+	index{index},
+	addFolder
+	{
+		"Add Folder", &defaultFace(),
+		[this](const Input::Event &e)
+		{
+			auto fPicker = makeView<FilePicker>(FSPicker::Mode::DIR, EmuSystem::NameFilterFunc{}, e);
+			fPicker->setPath(app().contentSearchPath(), e);
+			fPicker->setOnSelectPath(
+				[this](FSPicker &picker, CStringView path, std::string_view displayName, const Input::Event &e)
+				{
+					if(!this->index.addDirectory(path))
+					{
+						app().postErrorMessage("Folder is already in the library");
+						return;
+					}
+					loadItems();
+					place();
+					picker.dismiss();
+				});
+			pushAndShowModal(std::move(fPicker), e);
+		}
+	},
+	foldersHeading{"Select To Remove", &defaultBoldFace()}
+{
+	loadItems();
+}
+
+void LibraryFoldersView::loadItems()
+{
+	item.clear();
+	folder.clear();
+	item.emplace_back(&addFolder);
+	paths = index.directories();
+	if(paths.empty())
+		return;
+	item.emplace_back(&foldersHeading);
+	folder.reserve(paths.size());
+	for(auto i : iotaCount(paths.size()))
+	{
+		auto &folderItem = folder.emplace_back(appContext().fileUriDisplayName(paths[i]), &defaultFace(),
+			[this, i](const Input::Event &e)
+			{
+				pushAndShowModal(makeView<YesNoAlertView>("Remove this folder from the library?",
+					YesNoAlertView::Delegates
+					{
+						.onYes = [this, i]
+						{
+							index.removeDirectory(paths[i]);
+							loadItems();
+							place();
+						}
+					}), e);
+			});
+		item.emplace_back(&folderItem);
+	}
+}
+
+}
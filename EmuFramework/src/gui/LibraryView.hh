@@ -0,0 +1,63 @@
+#pragma once
+
+/*  This file is part of EmuFramework.
+
+	Imagine is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Imagine is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with EmuFramework.  If not, see <http://www.gnu.org/licenses/> */
+
+#include <emuframework/EmuAppHelper.hh>
+#include <emuframework/LibraryIndex.hh>
+#include <imagine/gui/TableView.hh>
+#include <imagine/gui/MenuItem.hh>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace EmuEx
+{
+
+class LibraryView : public TableView, public EmuAppHelper<LibraryView>
+{
+public:
+	LibraryView(ViewAttachParams attach, LibraryIndex &index);
+	~LibraryView() final;
+
+private:
+	LibraryIndex &index;
+	std::shared_ptr<const LibrarySnapshot> snapshot;
+	BoolMenuItem recentFirst;
+	TextMenuItem folders;
+	TextHeadingMenuItem contentHeading;
+	std::vector<TextMenuItem> content;
+	std::vector<MenuItem*> item;
+
+	void loadItems();
+};
+
+class LibraryFoldersView : public TableView, public EmuAppHelper<LibraryFoldersView>
+{
+public:
+	LibraryFoldersView(ViewAttachParams attach, LibraryIndex &index);
+
+private:
+	LibraryIndex &index;
+	TextMenuItem addFolder;
+	TextHeadingMenuItem foldersHeading;
+	std::vector<TextMenuItem> folder;
+	std::vector<MenuItem*> item;
+	std::vector<std::string> paths;
+
+	void loadItems();
+};
+
+}
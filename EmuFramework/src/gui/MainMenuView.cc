@@ -23,6 +23,7 @@
 #include <emuframework/TouchConfigView.hh>
 #include <emuframework/BundledGamesView.hh>
 #include "RecentGameView.hh"
+#include "LibraryView.hh"
 #include "../EmuOptions.hh"
 #include <imagine/gui/AlertView.hh>
 #include <imagine/base/ApplicationContext.hh>
@@ -92,6 +93,14 @@ MainMenuView::MainMenuView(ViewAttachParams attach, bool customMenu):
 			}
 		}
 	},
+	library
+	{
+		"Library", &defaultFace(),
+		[this](const Input::Event &e)
+		{
+			pushAndShow(makeView<LibraryView>(app().libraryIndex()), e);
+		}
+	},
 	bundledGames
 	{
 		"Bundled Content", &defaultFace(),
@@ -304,6 +313,7 @@ void MainMenuView::loadFileBrowserItems()
 {
 	item.emplace_back(&loadGame);
 	item.emplace_back(&recentGames);
+	item.emplace_back(&library);
 	if(EmuSystem::hasBundledGames && app().showsBundledGames())
 	{
 		item.emplace_back(&bundledGames);
@@ -163,6 +163,78 @@ SystemOptionView::SystemOptionView(ViewAttachParams attach, bool customMenu):
 		(MenuItem::Id)app().altSpeed(AltSpeedMode::slow),
 		slowModeSpeedItem
 	},
+	rewindMemoryItem
+	{
+		{"Off",   &defaultFace(), 0},
+		{"16MB",  &defaultFace(), 16},
+		{"32MB",  &defaultFace(), 32},
+		{"64MB",  &defaultFace(), 64},
+		{"128MB", &defaultFace(), 128},
+	},
+	rewindMemory
+	{
+		"Rewind Buffer", &defaultFace(),
+		{
+			.defaultItemOnSelect = [this](TextMenuItem &item) { app().rewindManager().setMaxMemory(item.id()); }
+		},
+		(MenuItem::Id)app().rewindManager().maxMemory(),
+		rewindMemoryItem
+	},
+	rewindIntervalItem
+	{
+		{"Every Frame", &defaultFace(), 1},
+		{"2 Frames",    &defaultFace(), 2},
+		{"4 Frames",    &defaultFace(), 4},
+		{"8 Frames",    &defaultFace(), 8},
+	},
+	rewindInterval
+	{
+		"Rewind Snapshot Interval", &defaultFace(),
+		{
+			.defaultItemOnSelect = [this](TextMenuItem &item) { app().rewindManager().setSnapshotInterval(item.id()); }
+		},
+		(MenuItem::Id)app().rewindManager().snapshotInterval(),
+		rewindIntervalItem
+	},
+	rewindStats
+	{
+		"Rewind Buffer Usage", &defaultFace(),
+		[this]
+		{
+			// emulation is paused while this menu is open so the stats aren't being updated
+			auto &rewind = app().rewindManager();
+			if(!rewind.isEnabled())
+			{
+				app().postMessage("Rewind is off");
+				return;
+			}
+			auto &stats = rewind.stats();
+			auto toMs = [](SteadyClockTime t) { return std::chrono::duration<double, std::milli>(t).count(); };
+			app().postMessage(6, false, std::format("{} snapshots using {:.1f}/{}MB\n"
+				"Last snapshot: {}KB delta of {}KB state\n"
+				"Capture: {:.2f}ms Restore: {:.2f}ms",
+				stats.snapshots, stats.usedBytes / (1024. * 1024.), rewind.maxMemory(),
+				divRoundUp(stats.lastSnapshotBytes, 1024uz), divRoundUp(stats.stateBytes, 1024uz),
+				toMs(stats.lastCaptureTime), toMs(stats.lastRestoreTime)));
+		}
+	},
+	runAheadItem
+	{
+		{"Off", &defaultFace(), 0},
+		{"1",   &defaultFace(), 1},
+		{"2",   &defaultFace(), 2},
+		{"3",   &defaultFace(), 3},
+		{"4",   &defaultFace(), 4},
+	},
+	runAhead
+	{
+		"Run-ahead Frames", &defaultFace(),
+		{
+			.defaultItemOnSelect = [this](TextMenuItem &item) { app().runAheadFrames = item.id(); }
+		},
+		(MenuItem::Id)app().runAheadFrames,
+		runAheadItem
+	},
 	performanceMode
 	{
 		"Performance Mode", &defaultFace(),
@@ -205,6 +277,10 @@ void SystemOptionView::loadStockItems()
 	item.emplace_back(&confirmOverwriteState);
 	item.emplace_back(&fastModeSpeed);
 	item.emplace_back(&slowModeSpeed);
+	item.emplace_back(&rewindMemory);
+	item.emplace_back(&rewindInterval);
+	item.emplace_back(&rewindStats);
+	item.emplace_back(&runAhead);
 	if(used(performanceMode) && appContext().hasSustainedPerformanceMode())
 		item.emplace_back(&performanceMode);
 	if(used(noopThread))
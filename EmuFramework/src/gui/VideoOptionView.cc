@@ -802,6 +802,18 @@ VideoOptionView::VideoOptionView(ViewAttachParams attach, bool customMenu):
 		app().usePresentationTime,
 		[this](BoolMenuItem &item) { app().usePresentationTime = item.flipBoolValue(*this); }
 	},
+	frameDelay
+	{
+		"Auto Frame Delay", &defaultFace(),
+		app().useFrameDelay,
+		[this](BoolMenuItem &item) { app().useFrameDelay = item.flipBoolValue(*this); }
+	},
+	adaptiveFrameSkip
+	{
+		"Adaptive Frame Skip", &defaultFace(),
+		app().useAdaptiveFrameSkip,
+		[this](BoolMenuItem &item) { app().useAdaptiveFrameSkip = item.flipBoolValue(*this); }
+	},
 	blankFrameInsertion
 	{
 		"Allow Blank Frame Insertion", &defaultFace(),
@@ -943,6 +955,8 @@ void VideoOptionView::loadStockItems()
 		item.emplace_back(&presentMode);
 	if(used(presentationTime) && renderer().supportsPresentationTime())
 		item.emplace_back(&presentationTime);
+	item.emplace_back(&frameDelay);
+	item.emplace_back(&adaptiveFrameSkip);
 	item.emplace_back(&blankFrameInsertion);
 	if(used(screenFrameRate) && app().emuScreen().supportedFrameRates().size() > 1)
 		item.emplace_back(&screenFrameRate);
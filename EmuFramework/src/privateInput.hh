@@ -111,6 +111,8 @@ enum
 	guiKeyIdxExitApp,
 	guiKeyIdxSlowMotion,
 	guiKeyIdxToggleSlowMotion,
+	guiKeyIdxRewind,
+	guiKeyIdxToggleScreenshotBurst,
 };
 
 constexpr std::array<unsigned, 1> rightUIKeys{guiKeyIdxLastView};
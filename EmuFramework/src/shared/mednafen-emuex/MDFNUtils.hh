@@ -24,12 +24,17 @@
 #include <mednafen/hash/md5.h>
 #include <mednafen/git.h>
 #include <mednafen/MemoryStream.h>
+#include <mednafen/FileStream.h>
+#include <mednafen/state.h>
 #include <main/MainSystem.hh>
 #include <string_view>
 
 namespace EmuEx
 {
 
+// threads created through Mednafen::MThreading, like the CD read thread
+void addMDFNThreadIds(std::vector<ThreadId> &);
+
 inline Mednafen::MDFN_Surface toMDFNSurface(IG::MutablePixmapView pix)
 {
 	using namespace Mednafen;
@@ -97,11 +102,22 @@ inline BoolMenuItem saveFilenameTypeMenuItem(auto &view, auto &system)
 inline void loadContent(EmuSystem &sys, Mednafen::MDFNGI &mdfnGameInfo, IO &io, size_t maxContentSize)
 {
 	using namespace Mednafen;
-	auto stream = std::make_unique<MemoryStream>(maxContentSize, true);
-	auto size = io.read(stream->map(), stream->map_size());
-	if(size <= 0)
-		sys.throwFileReadError();
-	stream->setSize(size);
+	std::unique_ptr<Stream> stream;
+	if(auto data = io.map(); data.size() && data.size() <= maxContentSize)
+	{
+		// read straight from the file mapping, only archived content needs a copy
+		io.advise(0, data.size(), IOAdvice::WillNeed);
+		stream = std::make_unique<FileStream>(MapIO{IOBuffer{data, 0}}, FileStream::MODE_READ);
+	}
+	else
+	{
+		auto memStream = std::make_unique<MemoryStream>(maxContentSize, true);
+		auto size = io.read(memStream->map(), memStream->map_size());
+		if(size <= 0)
+			sys.throwFileReadError();
+		memStream->setSize(size);
+		stream = std::move(memStream);
+	}
 	MDFNFILE fp(&NVFS, std::move(stream));
 	GameFile gf{&NVFS, std::string{sys.contentDirectory()}, fp.stream(),
 		std::string{withoutDotExtension(sys.contentFileName())},
@@ -109,15 +125,41 @@ inline void loadContent(EmuSystem &sys, Mednafen::MDFNGI &mdfnGameInfo, IO &io,
 	mdfnGameInfo.Load(&gf);
 }
 
+inline size_t stateSizeMDFN()
+{
+	using namespace Mednafen;
+	MemoryStream s{};
+	MDFNSS_SaveSM(&s, true);
+	return s.size();
+}
+
+inline size_t saveStateMDFN(std::span<uint8_t> buff)
+{
+	using namespace Mednafen;
+	MemoryStream s{buff.size()};
+	MDFNSS_SaveSM(&s, true);
+	if(s.size() > buff.size())
+		EmuSystem::throwStateBufferSizeError();
+	memcpy(buff.data(), s.map(), s.size());
+	return s.size();
+}
+
+inline void loadStateMDFN(std::span<const uint8_t> buff)
+{
+	using namespace Mednafen;
+	MemoryStream s{buff.size(), -1};
+	memcpy(s.map(), buff.data(), buff.size());
+	MDFNSS_LoadSM(&s, true);
+}
+
 inline void runFrame(EmuSystem &sys, Mednafen::MDFNGI &mdfnGameInfo, EmuSystemTaskContext taskCtx,
 	EmuVideo *videoPtr, MutablePixmapView pixView, EmuAudio *audioPtr, size_t maxAudioFrames, size_t maxLineWidths = 0)
 {
 	using namespace Mednafen;
-	int16 audioBuff[maxAudioFrames * 2];
 	EmulateSpecStruct espec{};
 	if(audioPtr)
 	{
-		espec.SoundBuf = audioBuff;
+		espec.SoundBuf = static_cast<int16*>(audioPtr->beginWrite(maxAudioFrames));
 		espec.SoundBufMaxSize = maxAudioFrames;
 	}
 	espec.taskCtx = taskCtx;
@@ -132,8 +174,8 @@ inline void runFrame(EmuSystem &sys, Mednafen::MDFNGI &mdfnGameInfo, EmuSystemTa
 	mdfnGameInfo.Emulate(&espec);
 	if(audioPtr)
 	{
-		assert((unsigned)espec.SoundBufSize <= audioPtr->format().bytesToFrames(sizeof(audioBuff)));
-		audioPtr->writeFrames((uint8_t*)audioBuff, espec.SoundBufSize);
+		assert((unsigned)espec.SoundBufSize <= maxAudioFrames);
+		audioPtr->commitWrite(espec.SoundBufSize);
 	}
 }
 
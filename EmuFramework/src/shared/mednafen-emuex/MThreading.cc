@@ -15,10 +15,14 @@
 
 #include <mednafen/types.h>
 #include <mednafen/MThreading.h>
+#include <imagine/thread/Thread.hh>
 #include <imagine/util/utility.h>
+#include <algorithm>
+#include <atomic>
 #include <thread>
 #include <mutex>
 #include <condition_variable>
+#include <vector>
 
 namespace Mednafen::MThreading
 {
@@ -26,23 +30,47 @@ namespace Mednafen::MThreading
 struct Thread : public std::thread
 {
 	using thread::thread;
+	std::atomic<IG::ThreadId> id{};
+
+	IG::ThreadId waitForId()
+	{
+		id.wait({}, std::memory_order_acquire);
+		return id.load(std::memory_order_relaxed);
+	}
 };
 struct Mutex : public std::mutex {};
 struct Cond : public std::condition_variable {};
 
+static std::mutex threadListMutex;
+static std::vector<Thread*> threadList;
+
 Thread* Thread_Create(int (*fn)(void *), void *data, const char* debug_name)
 {
-	return new Thread{fn, data};
+	auto thread = new Thread{};
+	static_cast<std::thread&>(*thread) = std::thread{[thread, fn, data]()
+	{
+		thread->id.store(IG::thisThreadId(), std::memory_order_release);
+		thread->id.notify_all();
+		fn(data);
+	}};
+	std::scoped_lock lock{threadListMutex};
+	threadList.emplace_back(thread);
+	return thread;
 }
 
 void Thread_Wait(Thread* thread, int* status)
 {
+	{
+		std::scoped_lock lock{threadListMutex};
+		std::erase(threadList, thread);
+	}
 	thread->join();
 	delete thread;
 }
 
 uint64 Thread_SetAffinity(Thread* thread, const uint64 mask)
 {
+	IG::setThreadCPUAffinityMask(std::array{thread->waitForId()}, IG::CPUMask(mask));
 	return 0;
 }
 
@@ -101,3 +129,17 @@ bool Cond_Wait(Cond* cond, Mutex* mutex) noexcept
 }
 
 }
+
+namespace EmuEx
+{
+
+void addMDFNThreadIds(std::vector<IG::ThreadId> &ids)
+{
+	std::scoped_lock lock{Mednafen::MThreading::threadListMutex};
+	for(auto thread : Mednafen::MThreading::threadList)
+	{
+		ids.emplace_back(thread->waitForId());
+	}
+}
+
+}
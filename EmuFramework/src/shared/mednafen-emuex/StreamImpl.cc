@@ -67,11 +67,15 @@ catch(std::system_error &err)
 	throw MDFN_Error(ene.Errno(), _("Error opening file \"%s\": %s"), path.c_str(), ene.StrError());
 }
 
+FileStream::FileStream(IG::IO io, const uint32 mode):
+	io{std::move(io)},
+	attribs{modeToAttribs(mode).second} {}
+
 FileStream::~FileStream() {}
 
 uint64 FileStream::attributes(void)
 {
- return ATTRIBUTE_SEEKABLE | attribs;
+ return ATTRIBUTE_SEEKABLE | (io.map().size() ? ATTRIBUTE_INMEM_FAST : 0) | attribs;
 }
 
 uint8 *FileStream::map(void) noexcept
@@ -149,7 +153,7 @@ uint64 FileStream::size(void)
 
 void FileStream::close(void)
 {
-	io = {};
+	io = IG::IO{};
 }
 
 void FileStream::advise(off_t offset, size_t bytes, IG::IOAdvice advice)
@@ -61,6 +61,7 @@ class FileStream : public Stream
  };
 
  FileStream(const std::string& path, const uint32 mode, const int do_lock = false, const uint32 buffer_size = 4096);
+ FileStream(IG::IO io, const uint32 mode); // wraps an already opened IO, like a view of a mapped file
  virtual ~FileStream() override;
 
  virtual uint64 attributes(void) override;
@@ -96,7 +97,7 @@ class FileStream : public Stream
  uint64 write_ub(const void* data, uint64 count);
  void write_buffered_data(void);
 
- IG::FileIO io;
+ IG::IO io;
  uint8 attribs;
 };
 
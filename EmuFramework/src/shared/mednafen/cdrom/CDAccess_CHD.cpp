@@ -23,6 +23,7 @@
 #include <mednafen/general.h>
 
 #include <stdio.h>
+#include <algorithm>
 
 #include "CDAccess_CHD.h"
 
@@ -59,6 +60,16 @@ static const int32_t DI_Size_Table[8] =
 
 extern FILE *fopenHelper(const char* filename, const char* mode);
 
+static unsigned CHDCacheHunks = 32;
+static unsigned CHDReadAheadHunks = 4;
+
+void CDAccess_CHD::SetHunkCacheSize(unsigned cacheHunks, unsigned readAheadHunks)
+{
+  CHDCacheHunks = std::max(cacheHunks, 1u);
+  // keep read-ahead from evicting the hunks it just decompressed
+  CHDReadAheadHunks = std::min(readAheadHunks, CHDCacheHunks / 2);
+}
+
 CDAccess_CHD::CDAccess_CHD(const std::string &path, bool image_memcache) : NumTracks(0), total_sectors(0)
 {
   Load(path, image_memcache);
@@ -84,8 +95,13 @@ void CDAccess_CHD::Load(const std::string &path, bool image_memcache)
 
   /* allocate storage for sector reads */
   const chd_header *head = chd_get_header(chd);
-  hunkmem = (uint8_t *)malloc(head->hunkbytes);
-  oldhunk = -1;
+  hunkbytes = head->hunkbytes;
+  totalhunks = head->totalhunks;
+  hunkCache.resize(CHDCacheHunks);
+  for (auto &hunk : hunkCache)
+    hunk.data.reset(new uint8[hunkbytes]);
+  missHunkMem.reset(new uint8[hunkbytes]);
+  readAheadHunks = CHDReadAheadHunks;
 
   MDFN_printf("chd_load '%s' hunkbytes=%d\n", path.c_str(), head->hunkbytes);
 
@@ -210,87 +226,204 @@ void CDAccess_CHD::Load(const std::string &path, bool image_memcache)
       assert(Tracks[x].index[i] >= 0);
     }
   }
+
+  if (readAheadHunks)
+    readAheadThread = std::thread([this]() { ReadAheadThreadLoop(); });
 }
 
 CDAccess_CHD::~CDAccess_CHD()
 {
+  if (readAheadThread.joinable())
+  {
+    {
+      std::lock_guard<std::mutex> lock(cacheMutex);
+      quitReadAhead = true;
+    }
+    cacheCond.notify_all();
+    readAheadThread.join();
+  }
+
+  if (stats.hits || stats.misses)
+  {
+    MDFN_printf("chd hunk cache: %llu hits (%llu from read-ahead), %llu misses (%llu waiting on read-ahead), %llu read-ahead decodes\n",
+      (unsigned long long)stats.hits, (unsigned long long)stats.readAheadHits, (unsigned long long)stats.misses,
+      (unsigned long long)stats.readAheadWaits, (unsigned long long)stats.readAheadDecodes);
+  }
+
   if (chd != NULL)
     chd_close(chd);
-
-  if (hunkmem)
-    free(hunkmem);
 }
 
-bool CDAccess_CHD::Read_CHD_Hunk_RAW(uint8_t *buf, int32_t lba, CHDFILE_TRACK_INFO* track)
+CDAccess_CHD::HunkCacheStats CDAccess_CHD::GetHunkCacheStats()
 {
-  const chd_header *head = chd_get_header(chd);
-  int cad = lba - track->LBA + track->fileOffset;
-  int sph = head->hunkbytes / (2352 + 96);
-  int hunknum = cad / sph; //(cad * head->unitbytes) / head->hunkbytes;
-  int hunkofs = cad % sph; //(cad * head->unitbytes) % head->hunkbytes;
-  int err = CHDERR_NONE;
+  std::lock_guard<std::mutex> lock(cacheMutex);
+  return stats;
+}
 
-  /* each hunk holds ~8 sectors, optimize when reading contiguous sectors */
-  if (hunknum != oldhunk)
+// cacheMutex must be held by the caller in the following functions
+
+CDAccess_CHD::CachedHunk* CDAccess_CHD::FindCachedHunk(int32 hunknum)
+{
+  for (auto &hunk : hunkCache)
   {
-    err = chd_read(chd, hunknum, hunkmem);
-    if (err != CHDERR_NONE)
-    	MDFN_printf("chd_read_sector failed lba=%d error=%d\n", lba, err);
-    else
-      oldhunk = hunknum;
+    if (hunk.hunknum == hunknum)
+      return &hunk;
   }
+  return nullptr;
+}
 
-  memcpy(buf, hunkmem + hunkofs * (2352 + 96), 2352);
-
-  return err;
+void CDAccess_CHD::InsertHunk(int32 hunknum, std::unique_ptr<uint8[]> &data, bool fromReadAhead)
+{
+  if (FindCachedHunk(hunknum))
+    return;
+
+  // replace the least recently used hunk, swapping its buffer with the caller's
+  auto &hunk = *std::min_element(hunkCache.begin(), hunkCache.end(),
+    [](const CachedHunk &a, const CachedHunk &b) { return a.lastUse < b.lastUse; });
+  hunk.data.swap(data);
+  hunk.hunknum = hunknum;
+  hunk.lastUse = ++useCounter;
+  hunk.fromReadAhead = fromReadAhead;
 }
 
-bool CDAccess_CHD::Read_CHD_Hunk_M1(uint8_t *buf, int32_t lba, CHDFILE_TRACK_INFO* track)
+void CDAccess_CHD::QueueReadAhead(int32 hunknum)
 {
-  const chd_header *head = chd_get_header(chd);
-  int cad = lba - track->LBA + track->fileOffset;
-  int sph = head->hunkbytes / (2352 + 96);
-  int hunknum = cad / sph; //(cad * head->unitbytes) / head->hunkbytes;
-  int hunkofs = cad % sph; //(cad * head->unitbytes) % head->hunkbytes;
-  int err = CHDERR_NONE;
+  if (!readAheadHunks || hunknum == lastHunk)
+    return;
+
+  // a non-sequential read invalidates any pending read-ahead
+  if (hunknum != lastHunk + 1)
+    readAheadQueue.clear();
+  lastHunk = hunknum;
 
-  /* each hunk holds ~8 sectors, optimize when reading contiguous sectors */
-  if (hunknum != oldhunk)
+  while (!readAheadQueue.empty() && readAheadQueue.front() <= hunknum)
+    readAheadQueue.pop_front();
+
+  for (unsigned i = 1; i <= readAheadHunks; i++)
   {
-    err = chd_read(chd, hunknum, hunkmem);
-    if (err != CHDERR_NONE)
-    	MDFN_printf("chd_read_sector failed lba=%d error=%d\n", lba, err);
-    else
-      oldhunk = hunknum;
+    const int32 nextHunk = hunknum + i;
+
+    if (nextHunk >= (int32)totalhunks)
+      break;
+
+    if (nextHunk == readAheadHunk || FindCachedHunk(nextHunk) ||
+        std::find(readAheadQueue.begin(), readAheadQueue.end(), nextHunk) != readAheadQueue.end())
+      continue;
+
+    readAheadQueue.push_back(nextHunk);
   }
 
-  memcpy(buf + 16, hunkmem + hunkofs * (2352 + 96), 2048);
+  if (!readAheadQueue.empty())
+    cacheCond.notify_all();
+}
+
+void CDAccess_CHD::ReadAheadThreadLoop(void)
+{
+  std::unique_ptr<uint8[]> hunkmem(new uint8[hunkbytes]);
+  std::unique_lock<std::mutex> lock(cacheMutex);
 
-  return err;
+  while (1)
+  {
+    cacheCond.wait(lock, [&]() { return quitReadAhead || !readAheadQueue.empty(); });
+
+    if (quitReadAhead)
+      return;
+
+    const int32 hunknum = readAheadQueue.front();
+    readAheadQueue.pop_front();
+
+    if (FindCachedHunk(hunknum))
+      continue;
+
+    readAheadHunk = hunknum;
+    lock.unlock();
+    chd_error err;
+    {
+      std::lock_guard<std::mutex> chdLock(chdMutex);
+      err = chd_read(chd, hunknum, hunkmem.get());
+    }
+    lock.lock();
+    readAheadHunk = -1;
+
+    if (err == CHDERR_NONE)
+    {
+      InsertHunk(hunknum, hunkmem, true);
+      stats.readAheadDecodes++;
+    }
+
+    cacheCond.notify_all();
+  }
 }
 
-bool CDAccess_CHD::Read_CHD_Hunk_M2(uint8_t *buf, int32_t lba, CHDFILE_TRACK_INFO* track)
+// Only called from a single reader thread since missHunkMem isn't shared
+bool CDAccess_CHD::Read_CHD_Hunk_Data(uint8_t *buf, int32_t lba, CHDFILE_TRACK_INFO* track, size_t bytes)
 {
-  const chd_header *head = chd_get_header(chd);
   int cad = lba - track->LBA + track->fileOffset;
-  int sph = head->hunkbytes / (2352 + 96);
+  int sph = hunkbytes / (2352 + 96);
   int hunknum = cad / sph; //(cad * head->unitbytes) / head->hunkbytes;
   int hunkofs = cad % sph; //(cad * head->unitbytes) % head->hunkbytes;
-  int err = CHDERR_NONE;
+  const size_t offset = hunkofs * (2352 + 96);
 
-  /* each hunk holds ~8 sectors, optimize when reading contiguous sectors */
-  if (hunknum != oldhunk)
+  std::unique_lock<std::mutex> lock(cacheMutex);
+  CachedHunk *hunk = FindCachedHunk(hunknum);
+
+  if (!hunk && hunknum == readAheadHunk)
   {
-    err = chd_read(chd, hunknum, hunkmem);
-    if (err != CHDERR_NONE)
-    	MDFN_printf("chd_read_sector failed lba=%d error=%d\n", lba, err);
-    else
-      oldhunk = hunknum;
+    stats.readAheadWaits++;
+    cacheCond.wait(lock, [&]() { return readAheadHunk != hunknum; });
+    hunk = FindCachedHunk(hunknum);
+  }
+
+  if (hunk)
+  {
+    stats.hits++;
+    if (hunk->fromReadAhead)
+    {
+      stats.readAheadHits++;
+      hunk->fromReadAhead = false;
+    }
+    hunk->lastUse = ++useCounter;
+    memcpy(buf, hunk->data.get() + offset, bytes);
+    QueueReadAhead(hunknum);
+    return true;
+  }
+
+  stats.misses++;
+  std::erase(readAheadQueue, hunknum);
+  lock.unlock();
+  chd_error err;
+  {
+    std::lock_guard<std::mutex> chdLock(chdMutex);
+    err = chd_read(chd, hunknum, missHunkMem.get());
   }
 
-  memcpy(buf + 16, hunkmem + hunkofs * (2352 + 96), 2336);
+  if (err != CHDERR_NONE)
+  {
+    MDFN_printf("chd_read_sector failed lba=%d error=%d\n", lba, err);
+    memset(buf, 0, bytes);
+    return false;
+  }
+
+  memcpy(buf, missHunkMem.get() + offset, bytes);
+  lock.lock();
+  InsertHunk(hunknum, missHunkMem, false);
+  QueueReadAhead(hunknum);
+  return true;
+}
 
-  return err;
+bool CDAccess_CHD::Read_CHD_Hunk_RAW(uint8_t *buf, int32_t lba, CHDFILE_TRACK_INFO* track)
+{
+  return Read_CHD_Hunk_Data(buf, lba, track, 2352);
+}
+
+bool CDAccess_CHD::Read_CHD_Hunk_M1(uint8_t *buf, int32_t lba, CHDFILE_TRACK_INFO* track)
+{
+  return Read_CHD_Hunk_Data(buf + 16, lba, track, 2048);
+}
+
+bool CDAccess_CHD::Read_CHD_Hunk_M2(uint8_t *buf, int32_t lba, CHDFILE_TRACK_INFO* track)
+{
+  return Read_CHD_Hunk_Data(buf + 16, lba, track, 2336);
 }
 
 int CDAccess_CHD::Read_Raw_Sector(uint8 *buf, int32 lba)
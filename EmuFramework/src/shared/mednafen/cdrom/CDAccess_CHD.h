@@ -25,6 +25,13 @@
 #include "CDAccess.h"
 #include <libchdr/chd.h>
 
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
 namespace Mednafen
 {
 
@@ -57,9 +64,22 @@ class CDAccess_CHD final : public CDAccess
 {
  public:
 
+ struct HunkCacheStats
+ {
+  uint64 hits = 0;
+  uint64 misses = 0;
+  uint64 readAheadHits = 0; // hits on hunks decompressed by the read-ahead thread
+  uint64 readAheadWaits = 0; // misses on a hunk the read-ahead thread was decompressing
+  uint64 readAheadDecodes = 0;
+ };
+
  CDAccess_CHD(const std::string& path, bool image_memcache);
  ~CDAccess_CHD() final;
 
+ // Applies to CHD images opened afterwards, readAheadHunks of 0 disables the read-ahead thread
+ static void SetHunkCacheSize(unsigned cacheHunks, unsigned readAheadHunks);
+ HunkCacheStats GetHunkCacheStats();
+
  int Read_Raw_Sector(uint8 *buf, int32 lba) final;
 
  bool Fast_Read_Raw_PW_TSRE(uint8* pwbuf, int32 lba) const noexcept final;
@@ -78,6 +98,19 @@ class CDAccess_CHD final : public CDAccess
   // MakeSubPQ will OR the simulated P and Q subchannel data into SubPWBuf.
   int32_t MakeSubPQ(int32_t lba, uint8_t *SubPWBuf) const;
 
+  struct CachedHunk
+  {
+   std::unique_ptr<uint8[]> data;
+   int32 hunknum = -1;
+   uint64 lastUse = 0;
+   bool fromReadAhead = false;
+  };
+
+  CachedHunk* FindCachedHunk(int32 hunknum);
+  void InsertHunk(int32 hunknum, std::unique_ptr<uint8[]> &data, bool fromReadAhead);
+  void QueueReadAhead(int32 hunknum);
+  void ReadAheadThreadLoop(void);
+  bool Read_CHD_Hunk_Data(uint8_t *buf, int32_t lba, CHDFILE_TRACK_INFO* track, size_t bytes);
   bool Read_CHD_Hunk_RAW(uint8_t *buf, int32_t lba, CHDFILE_TRACK_INFO* track);
   bool Read_CHD_Hunk_M1(uint8_t *buf, int32_t lba, CHDFILE_TRACK_INFO* track);
   bool Read_CHD_Hunk_M2(uint8_t *buf, int32_t lba, CHDFILE_TRACK_INFO* track);
@@ -96,11 +129,24 @@ class CDAccess_CHD final : public CDAccess
   //struct track tracks[DISC_MAX_TRACKS];
   int num_tracks;
 
-  chd_file *chd;
-  /* hunk data cache */
-  uint8_t *hunkmem;
-  /* last hunknum read */
-  int oldhunk;
+  chd_file *chd = nullptr;
+  uint32 hunkbytes = 0;
+  uint32 totalhunks = 0;
+
+  /* LRU cache of decompressed hunks, shared with the read-ahead thread */
+  std::vector<CachedHunk> hunkCache;
+  std::unique_ptr<uint8[]> missHunkMem;
+  uint64 useCounter = 0;
+  HunkCacheStats stats;
+  std::mutex cacheMutex;
+  std::condition_variable cacheCond;
+  std::mutex chdMutex; // serializes chd_read() calls
+  std::deque<int32> readAheadQueue;
+  int32 readAheadHunk = -1; // hunk currently being decompressed by the read-ahead thread
+  int32 lastHunk = -1;
+  unsigned readAheadHunks = 0;
+  bool quitReadAhead = false;
+  std::thread readAheadThread;
 };
 
 }
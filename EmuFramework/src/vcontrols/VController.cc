@@ -89,7 +89,8 @@ static void updateTexture(const EmuApp &app, VControllerElement &e)
 						case guiKeyIdxIncStateSlot: return app.asset(AssetID::rightSwitch); break;
 						case guiKeyIdxFastForward:
 						case guiKeyIdxToggleFastForward: return app.asset(AssetID::fast); break;
-						case guiKeyIdxGameScreenshot: return app.asset(AssetID::screenshot); break;
+						case guiKeyIdxGameScreenshot:
+						case guiKeyIdxToggleScreenshotBurst: return app.asset(AssetID::screenshot); break;
 						case guiKeyIdxLastView: return app.asset(AssetID::menu); break;
 						case guiKeyIdxTurboModifier: return app.asset(AssetID::speed); break;
 						case guiKeyIdxExitApp: return app.asset(AssetID::close); break;
@@ -137,7 +138,7 @@ void VController::inputAction(Input::Action action, unsigned vBtn)
 {
 	if(isInKeyboardMode())
 	{
-		system().handleInputAction(&app(), {kb.translateInput(vBtn), action});
+		app().sendInputAction({kb.translateInput(vBtn), action});
 	}
 	else
 	{
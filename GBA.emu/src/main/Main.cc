@@ -87,6 +87,25 @@ void GbaSystem::loadState(EmuApp &app, IG::CStringView path)
 		return throwFileReadError();
 }
 
+size_t GbaSystem::stateSize()
+{
+	return CPUWriteRawMemState(gGba, nullptr, 0);
+}
+
+size_t GbaSystem::saveState(std::span<uint8_t> buff)
+{
+	auto size = CPUWriteRawMemState(gGba, buff.data(), buff.size());
+	if(!size)
+		throwStateBufferSizeError();
+	return size;
+}
+
+void GbaSystem::loadState(std::span<const uint8_t> buff)
+{
+	if(!CPUReadRawMemState(gGba, buff.data(), buff.size()))
+		throwFileReadError();
+}
+
 void GbaSystem::loadBackupMemory(EmuApp &app)
 {
 	if(coreOptions.saveType == GBA_SAVE_NONE)
@@ -255,12 +274,12 @@ void systemDrawScreen(EmuEx::EmuSystemTaskContext taskCtx, EmuEx::EmuVideo &vide
 	assumeExpr(img.pixmap().size() == framePix.size());
 	if(img.pixmap().format() == IG::PIXEL_FMT_RGB565)
 	{
-		img.pixmap().writeTransformed([](uint16_t p){ return systemColorMap.map16[p]; }, framePix);
+		img.pixmap().writeIndexed(framePix, systemColorMap.map16);
 	}
 	else
 	{
 		assumeExpr(img.pixmap().format().bytesPerPixel() == 4);
-		img.pixmap().writeTransformed([](uint16_t p){ return systemColorMap.map32[p]; }, framePix);
+		img.pixmap().writeIndexed(framePix, systemColorMap.map32);
 	}
 	img.endFrame();
 }
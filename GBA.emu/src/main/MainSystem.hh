@@ -85,6 +85,9 @@ public:
 	std::string_view stateFilenameExt() const { return ".gqs"; }
 	void loadState(EmuApp &, CStringView uri);
 	void saveState(CStringView path);
+	size_t stateSize();
+	size_t saveState(std::span<uint8_t> buff);
+	void loadState(std::span<const uint8_t> buff);
 	bool readConfig(ConfigType, MapIO &, unsigned key, size_t readSize);
 	void writeConfig(ConfigType, FileIO &);
 	void reset(EmuApp &, ResetMode mode);
@@ -119,3 +122,5 @@ void CPULoop(GBASys &, EmuEx::EmuSystemTaskContext, EmuEx::EmuVideo *, EmuEx::Em
 void CPUCleanUp();
 bool CPUReadState(IG::ApplicationContext, GBASys &gba, const char *);
 bool CPUWriteState(IG::ApplicationContext, GBASys &gba, const char *);
+size_t CPUWriteRawMemState(GBASys &gba, uint8_t *memory, size_t available);
+bool CPUReadRawMemState(GBASys &gba, const uint8_t *memory, size_t size);
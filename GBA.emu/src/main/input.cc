@@ -224,7 +224,10 @@ void GbaSystem::handleInputAction(EmuApp *app, InputAction a)
 			darknessLevel = std::clamp(darknessLevel + darknessChange, 0, 0xff);
 			if(app)
 			{
-				app->postMessage(1, false, std::format("Light sensor level: {}%", remap(darknessLevel, 0xff, 0, 0, 100)));
+				app->appContext().runOnMainThread([app, level = remap(darknessLevel, 0xff, 0, 0, 100)](ApplicationContext)
+				{
+					app->postMessage(1, false, std::format("Light sensor level: {}%", level));
+				});
 			}
 		}
 	}
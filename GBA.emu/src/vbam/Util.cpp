@@ -801,6 +801,65 @@ gzFile utilMemGzOpen(char *memory, int available, const char *mode)
         return memgzopen(memory, available, mode);
 }
 
+// Uncompressed in-memory stream, a null memory pointer only counts written bytes
+struct RawMemStream
+{
+        char *memory;
+        long available;
+        long pos;
+};
+
+static int ZEXPORT rawMemWrite(gzFile file, const voidp buffer, unsigned int len)
+{
+        auto &s = *(RawMemStream*)file;
+        // keep counting past the end so the caller can detect the required size
+        if (s.memory && s.pos + (long)len <= s.available)
+                memcpy(s.memory + s.pos, buffer, len);
+        s.pos += len;
+        return len;
+}
+
+static int ZEXPORT rawMemRead(gzFile file, voidp buffer, unsigned int len)
+{
+        auto &s = *(RawMemStream*)file;
+        if (!s.memory || s.pos + (long)len > s.available)
+                return 0;
+        memcpy(buffer, s.memory + s.pos, len);
+        s.pos += len;
+        return len;
+}
+
+static int ZEXPORT rawMemClose(gzFile file)
+{
+        delete (RawMemStream*)file;
+        return Z_OK;
+}
+
+static z_off_t ZEXPORT rawMemSeek(gzFile file, z_off_t offset, int whence)
+{
+        auto &s = *(RawMemStream*)file;
+        long newPos = whence == SEEK_SET ? offset : s.pos + offset;
+        if (newPos < 0 || (s.memory && newPos > s.available))
+                return -1;
+        s.pos = newPos;
+        return newPos;
+}
+
+gzFile utilMemOpen(char *memory, int available, const char *)
+{
+        utilGzWriteFunc = rawMemWrite;
+        utilGzReadFunc = rawMemRead;
+        utilGzCloseFunc = rawMemClose;
+        utilGzSeekFunc = rawMemSeek;
+
+        return (gzFile)new RawMemStream{memory, available, 0};
+}
+
+long utilMemTell(gzFile file)
+{
+        return ((RawMemStream*)file)->pos;
+}
+
 int utilGzWrite(gzFile file, const voidp buffer, unsigned int len)
 {
         return utilGzWriteFunc(file, buffer, len);
@@ -57,6 +57,8 @@ void utilReadDataMem(const uint8_t *&data, variable_desc *);
 #else
 gzFile utilGzOpen(int fd, const char *mode);
 gzFile utilMemGzOpen(char *memory, int available, const char *mode);
+gzFile utilMemOpen(char *memory, int available, const char *mode);
+long utilMemTell(gzFile file);
 int utilGzWrite(gzFile file, const voidp buffer, unsigned int len);
 int utilGzRead(gzFile file, voidp buffer, unsigned int len);
 int utilGzClose(gzFile file);
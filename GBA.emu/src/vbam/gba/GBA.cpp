@@ -893,6 +893,34 @@ bool CPUWriteMemState(GBASys &gba, char *memory, int available, long& reserved)
   return res;
 }
 
+size_t CPUWriteRawMemState(GBASys &gba, uint8_t *memory, size_t available)
+{
+  gzFile gzFile = utilMemOpen((char*)memory, available, "w");
+
+  bool res = CPUWriteState(gba, gzFile);
+
+  long size = utilMemTell(gzFile);
+
+  utilGzClose(gzFile);
+
+  if (!res || (memory && size > (long)available))
+    return 0;
+  return size;
+}
+
+static bool CPUReadState(GBASys &gba, gzFile gzFile);
+
+bool CPUReadRawMemState(GBASys &gba, const uint8_t *memory, size_t size)
+{
+  gzFile gzFile = utilMemOpen((char*)memory, size, "r");
+
+  bool res = CPUReadState(gba, gzFile);
+
+  utilGzClose(gzFile);
+
+  return res;
+}
+
 static bool CPUReadState(GBASys &gba, gzFile gzFile)
 {
 	auto &cpu = gba.cpu;
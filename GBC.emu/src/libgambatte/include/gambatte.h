@@ -169,7 +169,12 @@ public:
 	  */
 	bool loadState(std::string const &filepath);
 
-	bool loadState(std::istream &file);
+	/**
+	  * Loads emulator state from a stream, skipping the save data flush
+	  * if 'saveSavedata' is false, for frequent in-memory state loads.
+	  * @return success
+	  */
+	bool loadState(std::istream &file, bool saveSavedata = true);
 
 	/**
 	  * Selects which state slot to save state to or load state from.
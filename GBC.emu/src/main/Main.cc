@@ -20,6 +20,8 @@
 #include <imagine/util/format.hh>
 #include <imagine/fs/FS.hh>
 #include <imagine/io/IOStream.hh>
+#include <imagine/io/MapIO.hh>
+#include <sstream>
 #include <resample/resampler.h>
 #include <resample/resamplerinfo.h>
 #include <libgambatte/src/mem/cartridge.h>
@@ -101,6 +103,29 @@ void GbcSystem::loadState(EmuApp &app, IG::CStringView path)
 		throwFileReadError();
 }
 
+size_t GbcSystem::stateSize()
+{
+	std::ostringstream stream;
+	if(!gbEmu.saveState(nullptr, 0, stream))
+		throwFileWriteError();
+	return stream.tellp();
+}
+
+size_t GbcSystem::saveState(std::span<uint8_t> buff)
+{
+	OStream<MapIO> stream{MapIO{IOBuffer{buff, 0}}};
+	if(!gbEmu.saveState(nullptr, 0, stream))
+		throwStateBufferSizeError();
+	return stream.tellp();
+}
+
+void GbcSystem::loadState(std::span<const uint8_t> buff)
+{
+	IStream<MapIO> stream{MapIO{IOBuffer{{const_cast<uint8_t*>(buff.data()), buff.size()}, 0}}};
+	if(!gbEmu.loadState(stream, false))
+		throwFileReadError();
+}
+
 void GbcSystem::loadBackupMemory(EmuApp &app)
 {
 	if(auto sram = gbEmu.srambank();
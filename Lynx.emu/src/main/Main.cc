@@ -72,6 +72,10 @@ void LynxSystem::loadState(EmuApp &, IG::CStringView path)
 		throwFileReadError();
 }
 
+size_t LynxSystem::stateSize() { return stateSizeMDFN(); }
+size_t LynxSystem::saveState(std::span<uint8_t> buff) { return saveStateMDFN(buff); }
+void LynxSystem::loadState(std::span<const uint8_t> buff) { loadStateMDFN(buff); }
+
 void LynxSystem::closeSystem()
 {
 	mdfnGameInfo.CloseGame();
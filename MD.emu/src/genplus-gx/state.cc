@@ -101,9 +101,6 @@ void state_load(const unsigned char *buffer)
 {
 	auto state = std::make_unique<unsigned char[]>(STATE_SIZE);
 
-  /* buffer size */
-  unsigned bufferptr = 0;
-
   /* uncompress savestate */
   uint32 inbytes32;
   memcpy(&inbytes32, buffer, 4);
@@ -119,6 +116,17 @@ void state_load(const unsigned char *buffer)
 		}
   }
 
+  state_load_raw(state.get(), outbytes);
+}
+
+void state_load_raw(const unsigned char *buffer, unsigned long outbytes)
+{
+  // context load functions only read from the buffer
+  auto state = const_cast<unsigned char*>(buffer);
+
+  /* buffer size */
+  unsigned bufferptr = 0;
+
   /* signature check (GENPLUS-GX x.x.x) */
   char version[17];
   load_param(version,16);
@@ -297,7 +305,23 @@ void state_load(const unsigned char *buffer)
 int state_save(unsigned char *buffer)
 {
 	auto state = std::make_unique<unsigned char[]>(STATE_SIZE);
+	int bufferptr = state_save_raw(state.get());
 
+  /* compress state file */
+  unsigned long inbytes   = bufferptr;
+  unsigned long outbytes  = STATE_SIZE;
+  logMsg("compressing %d bytes to buffer of %d size", (int)inbytes, (int)outbytes);
+  int ret = compress2 ((Bytef *)(buffer + 4), &outbytes, (Bytef *)state.get(), inbytes, 9);
+  logMsg("compress2 returned %d, reduced to %d bytes", ret, (int)outbytes);
+  uint32 outbytes32 = outbytes; // assumes no save states will ever be over 4GB
+  memcpy(buffer, &outbytes32, 4);
+
+  /* return total size */
+  return (outbytes32 + 4);
+}
+
+int state_save_raw(unsigned char *state)
+{
   /* buffer size */
   int bufferptr = 0;
 
@@ -392,15 +416,5 @@ int state_save(unsigned char *buffer)
 	}
 	#endif
 
-  /* compress state file */
-  unsigned long inbytes   = bufferptr;
-  unsigned long outbytes  = STATE_SIZE;
-  logMsg("compressing %d bytes to buffer of %d size", (int)inbytes, (int)outbytes);
-  int ret = compress2 ((Bytef *)(buffer + 4), &outbytes, (Bytef *)state.get(), inbytes, 9);
-  logMsg("compress2 returned %d, reduced to %d bytes", ret, (int)outbytes);
-  uint32 outbytes32 = outbytes; // assumes no save states will ever be over 4GB
-  memcpy(buffer, &outbytes32, 4);
-
-  /* return total size */
-  return (outbytes32 + 4);
+  return bufferptr;
 }
@@ -42,5 +42,8 @@
 /* Function prototypes */
 void state_load(const unsigned char *buffer);
 int state_save(unsigned char *buffer);
+/* Uncompressed variants, buffer must hold at least STATE_SIZE bytes when saving */
+void state_load_raw(const unsigned char *buffer, unsigned long size);
+int state_save_raw(unsigned char *buffer);
 
 #endif
@@ -99,12 +99,16 @@ void MdSystem::runFrame(EmuSystemTaskContext taskCtx, EmuVideo *video, EmuAudio
 	RAMCheatUpdate();
 	system_frame(taskCtx, video);
 
-	int16 audioBuff[snd.buffer_size * 2];
-	int frames = audio_update(audioBuff);
 	if(audio)
 	{
+		int frames = audio_update(static_cast<int16*>(audio->beginWrite(snd.buffer_size)));
 		//logMsg("%d frames", frames);
-		audio->writeFrames(audioBuff, frames);
+		audio->commitWrite(frames);
+	}
+	else
+	{
+		int16 audioBuff[snd.buffer_size * 2];
+		audio_update(audioBuff);
 	}
 	//logMsg("frame end");
 }
@@ -160,6 +164,20 @@ void MdSystem::loadState(EmuApp &app, IG::CStringView path)
 	state_load(FileUtils::bufferFromUri(app.appContext(), path).data());
 }
 
+size_t MdSystem::stateSize() { return STATE_SIZE; }
+
+size_t MdSystem::saveState(std::span<uint8_t> buff)
+{
+	if(buff.size() < STATE_SIZE)
+		throwStateBufferSizeError();
+	return state_save_raw(buff.data());
+}
+
+void MdSystem::loadState(std::span<const uint8_t> buff)
+{
+	state_load_raw(buff.data(), buff.size());
+}
+
 static bool sramHasContent(std::span<uint8> sram)
 {
 	for(auto v : sram)
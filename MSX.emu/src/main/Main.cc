@@ -474,6 +474,11 @@ void MsxSystem::saveBlueMSXState(const char *filename)
 		logErr("error creating zip:%s", filename);
 		EmuSystem::throwFileWriteError();
 	}
+	writeBlueMSXState(filename);
+}
+
+void MsxSystem::writeBlueMSXState(const char *filename)
+{
 	saveStateCreateForWrite(filename);
 	int rv = zipSaveFile(filename, "version", 0, saveStateVersion, sizeof(saveStateVersion));
 	if (!rv)
@@ -594,6 +599,31 @@ void MsxSystem::loadState(EmuApp &app, IG::CStringView path)
 	return loadBlueMSXState(app, path);
 }
 
+size_t MsxSystem::stateSize()
+{
+	size_t size;
+	zipStartWrite({}, size);
+	writeBlueMSXState(memoryZipName);
+	return size;
+}
+
+size_t MsxSystem::saveState(std::span<uint8_t> buff)
+{
+	size_t size;
+	zipStartWrite(buff, size);
+	writeBlueMSXState(memoryZipName);
+	if(size > buff.size())
+		throwStateBufferSizeError();
+	return size;
+}
+
+void MsxSystem::loadState(std::span<const uint8_t> buff)
+{
+	zipSetMemoryZip(buff);
+	auto unsetMemoryZip = IG::scopeGuard([](){ zipSetMemoryZip({}); });
+	loadBlueMSXState(EmuApp::get(appContext()), memoryZipName);
+}
+
 void MsxSystem::closeSystem()
 {
 	destroyMachine();
@@ -17,7 +17,12 @@ struct Mixer;
 extern IG::FS::FileString hdName[4];
 extern Machine *machine;
 
+// name used in place of a zip file path for state archives held in memory
+constexpr const char *memoryZipName = ":memory:";
+
 bool zipStartWrite(const char *fileName);
+void zipStartWrite(std::span<uint8_t> buff, size_t &size);
+void zipSetMemoryZip(std::span<const uint8_t>);
 void zipEndWrite();
 IG::PixmapView frameBufferPixmap();
 HdType boardGetHdType(int hdIndex);
@@ -83,6 +88,9 @@ public:
 	std::string_view stateFilenameExt() const { return ".sta"; }
 	void loadState(EmuApp &, CStringView uri);
 	void saveState(CStringView path);
+	size_t stateSize();
+	size_t saveState(std::span<uint8_t> buff);
+	void loadState(std::span<const uint8_t> buff);
 	bool readConfig(ConfigType, MapIO &, unsigned key, size_t readSize);
 	void writeConfig(ConfigType, FileIO &);
 	void reset(EmuApp &, ResetMode mode);
@@ -105,6 +113,7 @@ public:
 private:
 	void insertMedia(EmuApp &app);
 	void saveBlueMSXState(const char *filename);
+	void writeBlueMSXState(const char *filename);
 	void loadBlueMSXState(EmuApp &app, const char *filename);
 };
 
@@ -38,13 +38,11 @@ extern "C" {
 }
 
 #include <string.h>
-#include <imagine/util/ranges.hh>
+#include <emuframework/ContentHash.hh>
 #include <imagine/logger/logger.h>
-// throw_exception.hpp, Boost 1.50
-#define UUID_AA15E74A856F11E08B8D93F24824019B
-#define BOOST_THROW_EXCEPTION(x)
-#define BOOST_STATIC_ASSERT( ... ) static_assert(__VA_ARGS__, #__VA_ARGS__)
-#include "../uuid/sha1.hpp"
+#include <array>
+#include <iterator>
+#include <unordered_map>
 
 struct RomDBInfo
 {
@@ -57,6 +55,29 @@ static const RomDBInfo romDB[] =
 #include "EmbeddedRomDBData.h"
 };
 
+using RomDigest = std::array<unsigned, 5>;
+
+struct RomDigestHash
+{
+	// digests are already uniformly distributed
+	size_t operator()(const RomDigest &d) const { return d[0]; }
+};
+
+static const std::unordered_map<RomDigest, unsigned, RomDigestHash> &romDBMap()
+{
+	static const auto map = []()
+	{
+		std::unordered_map<RomDigest, unsigned, RomDigestHash> map;
+		map.reserve(std::size(romDB));
+		for(const auto &e : romDB)
+		{
+			map.try_emplace(std::to_array(e.digest), e.romType);
+		}
+		return map;
+	}();
+	return map;
+}
+
 struct MediaType {
     constexpr MediaType(RomType rt) : romType(rt) {}
 
@@ -549,27 +570,19 @@ extern "C" MediaType* mediaDbLookupRom(const void *buffer, int size)
     }*/
     static MediaType staticMediaType(ROM_UNKNOWN);
 
-    boost::uuids::detail::sha1 sha1;
-		sha1.process_bytes(buffer, size);
-		unsigned int digest[5];
-		sha1.get_digest(digest);
+    auto sha1 = EmuEx::cachedSha1Digest({(const uint8_t*)buffer, size_t(size)});
+		RomDigest digest;
+		for(size_t i = 0; i < digest.size(); i++)
+		{
+			digest[i] = sha1[i * 4] << 24 | sha1[i * 4 + 1] << 16 | sha1[i * 4 + 2] << 8 | sha1[i * 4 + 3];
+		}
 		logMsg("rom sha1 0x%X 0x%X 0x%X 0x%X 0x%X", digest[0], digest[1], digest[2], digest[3], digest[4]);
 
-		for(auto e : romDB)
+		if(auto it = romDBMap().find(digest); it != romDBMap().end())
 		{
-			int match = 0;
-			for(auto i : IG::iotaCount(5))
-			{
-					if(digest[i] != e.digest[i])
-						break;
-					else match++;
-			}
-			if(match == 5)
-			{
-				logMsg("found match with type %s", romTypeToString(e.romType));
-				staticMediaType = e.romType;
-				return &staticMediaType;
-			}
+			logMsg("found match with type %s", romTypeToString(it->second));
+			staticMediaType = it->second;
+			return &staticMediaType;
 		}
 
 		logMsg("rom not in DB");
@@ -288,7 +288,12 @@ void MsxSystem::handleInputAction(EmuApp *appPtr, InputAction a)
 	if(event1 == EC_KEYCOUNT)
 	{
 		if(appPtr && isPushed)
-			appPtr->toggleKeyboard();
+		{
+			appPtr->appContext().runOnMainThread([appPtr](ApplicationContext)
+			{
+				appPtr->toggleKeyboard();
+			});
+		}
 	}
 	else
 	{
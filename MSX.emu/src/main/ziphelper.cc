@@ -18,6 +18,7 @@
 #include <archive_entry.h>
 #include <imagine/fs/ArchiveFS.hh>
 #include <imagine/io/IO.hh>
+#include <imagine/io/MapIO.hh>
 #include <imagine/logger/logger.h>
 #include <imagine/util/string.h>
 #include <imagine/util/ScopeGuard.hh>
@@ -35,10 +36,24 @@ using namespace EmuEx;
 static struct archive *writeArch{};
 static FS::ArchiveIterator cachedZipIt{};
 static FS::PathString cachedZipName{};
+static std::span<const uint8_t> memoryZip{};
+
+struct MemoryZipWriter
+{
+	std::span<uint8_t> buff;
+	size_t *size;
+};
+static MemoryZipWriter memoryZipWriter{};
 
 void zipCacheReadOnlyZip(const char* zipName)
 {
-	if(zipName && strlen(zipName))
+	if(zipName && zipName == std::string_view{memoryZipName})
+	{
+		assert(memoryZip.data());
+		cachedZipIt = {IO{MapIO{IOBuffer{{const_cast<uint8_t*>(memoryZip.data()), memoryZip.size()}, 0}}}};
+		cachedZipName = zipName;
+	}
+	else if(zipName && strlen(zipName))
 	{
 		logMsg("setting cached read zip archive:%s", zipName);
 		cachedZipIt = {EmuEx::gAppContext().openFileUri(zipName)};
@@ -116,6 +131,34 @@ bool zipStartWrite(const char *fileName)
 	return true;
 }
 
+void zipStartWrite(std::span<uint8_t> buff, size_t &size)
+{
+	assert(!writeArch);
+	writeArch = archive_write_new();
+	archive_write_set_format_zip(writeArch);
+	// skip compression since these states are short-lived and written often
+	archive_write_set_format_option(writeArch, "zip", "compression", "store");
+	archive_write_set_bytes_per_block(writeArch, 0);
+	size = 0;
+	memoryZipWriter = {buff, &size};
+	archive_write_open(writeArch, &memoryZipWriter, nullptr,
+		[](struct archive *, void *data, const void *bytes, size_t length) -> la_ssize_t
+		{
+			// keep counting past the end of the buffer so the caller learns the required size
+			auto &writer = *static_cast<MemoryZipWriter*>(data);
+			auto offset = *writer.size;
+			if(offset + length <= writer.buff.size())
+				memcpy(writer.buff.data() + offset, bytes, length);
+			*writer.size += length;
+			return length;
+		}, nullptr);
+}
+
+void zipSetMemoryZip(std::span<const uint8_t> buff)
+{
+	memoryZip = buff;
+}
+
 int zipSaveFile(const char* zipName, const char* fileName, int append, const void* buffer, int size)
 {
 	assert(writeArch);
@@ -444,43 +444,53 @@ bool save_state(char *game,int slot) {
 
 #else
 
-static gzFile open_state(void *contextPtr, const char *st_name, int mode) {
-	char string[20];
-	char *m=(mode==STWRITE?"wb":"rb");
-	gzFile gzf;
-	int  flags;
-	Uint32 rate;
+static const char *stateSig = "GNGST3";
 
-	if ((gzf = gzopenHelper(contextPtr, st_name, m)) == NULL) {
-		logMsg("%s not found\n", st_name);
-		return NULL;
-    }
+/* when mkstate_data() gets a NULL gzFile, it reads or writes this buffer instead */
+static Uint8 *stateBuff;
+static size_t stateBuffSize, stateBuffPos;
 
-	static const char *stateSig = "GNGST3";
+static bool mkstate_header(gzFile gzf, int mode) {
+	char string[20];
+	int flags=m68k_flag | z80_flag | endian_flag;
 
 	if(mode==STREAD) {
-
+		int stateFlags = 0;
 		memset(string, 0, 20);
-		gzread(gzf, string, 6);
+		mkstate_data(gzf, string, 6, STREAD);
 
 		if (strcmp(string, stateSig)) {
-			logMsg("%s is not a valid gngeo st file", st_name);
-			gzclose(gzf);
-			return NULL;
+			logMsg("not a valid gngeo state");
+			return false;
 		}
 
-		gzread(gzf, &flags, sizeof (int));
+		mkstate_data(gzf, &stateFlags, sizeof (int), STREAD);
 
-		if (flags != (m68k_flag | z80_flag | endian_flag)) {
+		if (stateFlags != flags) {
 			logMsg("This save state comes from a different endian architecture.\n"
 					"This is not currently supported :(");
-			gzclose(gzf);
-			return NULL;
+			return false;
 		}
 	} else {
-		int flags=m68k_flag | z80_flag | endian_flag;
-		gzwrite(gzf, stateSig, 6);
-		gzwrite(gzf, &flags, sizeof(int));
+		mkstate_data(gzf, (void*)stateSig, 6, STWRITE);
+		mkstate_data(gzf, &flags, sizeof(int), STWRITE);
+	}
+	return true;
+}
+
+static gzFile open_state(void *contextPtr, const char *st_name, int mode) {
+	char *m=(mode==STWRITE?"wb":"rb");
+	gzFile gzf;
+
+	if ((gzf = gzopenHelper(contextPtr, st_name, m)) == NULL) {
+		logMsg("%s not found\n", st_name);
+		return NULL;
+    }
+
+	if (!mkstate_header(gzf, mode)) {
+		logMsg("error reading state header from %s", st_name);
+		gzclose(gzf);
+		return NULL;
 	}
 	return gzf;
 }
@@ -492,6 +502,19 @@ static gzFile open_state(void *contextPtr, const char *st_name, int mode) {
 }*/
 
 int mkstate_data(gzFile gzf,void *data,int size,int mode) {
+	if (!gzf) {
+		/* past the end of the buffer, writes only advance the position so the needed size is known */
+		if (stateBuffPos + size > stateBuffSize) {
+			stateBuffPos += size;
+			return 0;
+		}
+		if (mode==STREAD)
+			memcpy(data, stateBuff + stateBuffPos, size);
+		else
+			memcpy(stateBuff + stateBuffPos, data, size);
+		stateBuffPos += size;
+		return size;
+	}
 	if (mode==STREAD)
 		return gzread(gzf,data,size);
 	return gzwrite(gzf,data,size);
@@ -553,8 +576,7 @@ int save_stateWithName(void *contextPtr, const char *name) {
 	return true;
 }
 
-int load_stateWithName(void *contextPtr, const char *name) {
-	gzFile gzf;
+static void neogeo_load_mkstate(gzFile gzf) {
 	/* Save pointers */
 	Uint8 *ng_lo = memory.ng_lo;
 	Uint8 *fix_game_usage=memory.fix_game_usage;
@@ -562,9 +584,6 @@ int load_stateWithName(void *contextPtr, const char *name) {
 	int *bksw_offset=memory.bksw_offset;
 //	GAME_ROMS r;
 //	memcpy(&r,&memory.rom,sizeof(GAME_ROMS));
-	
-	if ((gzf = open_state(contextPtr, name, STREAD))==NULL)
-		return false;
 
 	//gzread(gzf,state_img_tmp->pixels,304*224*2);
 
@@ -599,10 +618,41 @@ int load_stateWithName(void *contextPtr, const char *name) {
 		current_fix = memory.rom.bios_sfix.p;
 		fix_usage = memory.fix_board_usage;
 	}
+}
+
+int load_stateWithName(void *contextPtr, const char *name) {
+	gzFile gzf;
+
+	if ((gzf = open_state(contextPtr, name, STREAD))==NULL)
+		return false;
+
+	neogeo_load_mkstate(gzf);
 
 	gzclose(gzf);
 	return true;
 }
+
+size_t save_stateToBuffer(void *buff, size_t size) {
+	stateBuff = buff;
+	stateBuffSize = size;
+	stateBuffPos = 0;
+	mkstate_header(NULL, STWRITE);
+	neogeo_mkstate(NULL, STWRITE);
+	stateBuff = NULL;
+	return stateBuffPos;
+}
+
+int load_stateFromBuffer(const void *buff, size_t size) {
+	stateBuff = (Uint8*)buff;
+	stateBuffSize = size;
+	stateBuffPos = 0;
+	int success = mkstate_header(NULL, STREAD);
+	if (success)
+		neogeo_load_mkstate(NULL);
+	stateBuff = NULL;
+	/* reads past the end of the buffer are skipped, so a truncated state fails here */
+	return success && stateBuffPos <= size;
+}
 #endif
 
 #if 0
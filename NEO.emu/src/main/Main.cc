@@ -161,6 +161,28 @@ void NeoSystem::loadState(EmuApp &app, IG::CStringView path)
 		return EmuSystem::throwFileReadError();
 }
 
+size_t NeoSystem::stateSize()
+{
+	if(!stateSize_)
+		stateSize_ = save_stateToBuffer(nullptr, 0);
+	return stateSize_;
+}
+
+size_t NeoSystem::saveState(std::span<uint8_t> buff)
+{
+	auto size = save_stateToBuffer(buff.data(), buff.size());
+	if(size > buff.size())
+		throwStateBufferSizeError();
+	return size;
+}
+
+void NeoSystem::loadState(std::span<const uint8_t> buff)
+{
+	// check the size up front since a short buffer would otherwise leave the state partially restored
+	if(buff.size() < stateSize() || !load_stateFromBuffer(buff.data(), buff.size()))
+		throwFileReadError();
+}
+
 static auto nvramPath(EmuApp &app)
 {
 	return app.contentSaveFilePath(".nv");
@@ -45,6 +45,7 @@ public:
 	uint16_t screenBuff[FBResX*256] __attribute__ ((aligned (8))){};
 	FS::PathString datafilePath{};
 	EmuSystem::OnLoadProgressDelegate onLoadProgress{};
+	size_t stateSize_{}; // fixed for all games, found by the first stateSize() call
 	Byte1Option optionListAllGames{CFGKEY_LIST_ALL_GAMES, 0};
 	Byte1Option optionBIOSType{CFGKEY_BIOS_TYPE, SYS_UNIBIOS, 0, systemEnumIsValid};
 	Byte1Option optionMVSCountry{CFGKEY_MVS_COUNTRY, CTY_USA, 0, countryEnumIsValid};
@@ -68,6 +69,9 @@ public:
 	std::string_view stateFilenameExt() const { return ".sta"; }
 	void loadState(EmuApp &, CStringView uri);
 	void saveState(CStringView path);
+	size_t stateSize();
+	size_t saveState(std::span<uint8_t> buff);
+	void loadState(std::span<const uint8_t> buff);
 	bool readConfig(ConfigType, MapIO &, unsigned key, size_t readSize);
 	void writeConfig(ConfigType, FileIO &);
 	void reset(EmuApp &, ResetMode mode);
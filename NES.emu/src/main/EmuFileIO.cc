@@ -29,8 +29,28 @@ EmuFileIO::EmuFileIO(IG::IO &srcIO):
 	}
 }
 
+EmuFileIO::EmuFileIO(IG::MapIO io_):
+	io{std::move(io_)}
+{
+	if(!io) [[unlikely]]
+	{
+		failbit = true;
+	}
+}
+
 int EmuFileIO::fgetc() { return IG::fgetc(io); }
 
+int EmuFileIO::fputc(int c)
+{
+	uint8_t byte = c;
+	if(io.write(&byte, 1) != 1)
+	{
+		failbit = true;
+		return EOF;
+	}
+	return c;
+}
+
 size_t EmuFileIO::_fread(const void *ptr, size_t bytes)
 {
 	ssize_t ret = io.read((void*)ptr, bytes);
@@ -39,6 +59,12 @@ size_t EmuFileIO::_fread(const void *ptr, size_t bytes)
 	return ret;
 }
 
+void EmuFileIO::fwrite(const void *ptr, size_t bytes)
+{
+	if(io.write(ptr, bytes) < (ssize_t)bytes)
+		failbit = true;
+}
+
 int EmuFileIO::fseek(long int offset, int origin)
 {
 	return IG::fseek(io, offset, origin);
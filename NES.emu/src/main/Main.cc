@@ -135,6 +135,31 @@ void NesSystem::loadState(EmuApp &app, IG::CStringView path)
 		EmuSystem::throwFileReadError();
 }
 
+size_t NesSystem::stateSize()
+{
+	EMUFILE_MEMORY stream;
+	if(!FCEUSS_SaveMS(&stream, 0))
+		EmuSystem::throwFileWriteError();
+	return stream.size();
+}
+
+size_t NesSystem::saveState(std::span<uint8_t> buff)
+{
+	EmuFileIO stream{MapIO{IOBuffer{buff, 0}}};
+	if(!FCEUSS_SaveMS(&stream, 0))
+		EmuSystem::throwFileWriteError();
+	if(stream.fail())
+		EmuSystem::throwStateBufferSizeError();
+	return stream.ftell();
+}
+
+void NesSystem::loadState(std::span<const uint8_t> buff)
+{
+	EmuFileIO stream{MapIO{IOBuffer{{const_cast<uint8_t*>(buff.data()), buff.size()}, 0}}};
+	if(!FCEUSS_LoadFP(&stream, SSLOADPARAM_NOBACKUP))
+		EmuSystem::throwFileReadError();
+}
+
 void NesSystem::loadBackupMemory(EmuApp &app)
 {
 	if(isFDS)
@@ -404,9 +429,8 @@ void emulateSound(EmuAudio *audio)
 	assert(frames <= maxAudioFrames);
 	if(audio)
 	{
-		int16 sound16[maxAudioFrames];
-		copy_n(sound, maxAudioFrames, sound16);
-		audio->writeFrames(sound16, frames);
+		copy_n(sound, frames, static_cast<int16*>(audio->beginWrite(frames)));
+		audio->commitWrite(frames);
 	}
 }
 
@@ -427,12 +451,12 @@ void NesSystem::renderVideo(EmuSystemTaskContext taskCtx, EmuVideo &video, uint8
 	assumeExpr(pix.size() == ppuPixRegion.size());
 	if(pix.format() == IG::PIXEL_RGB565)
 	{
-		pix.writeTransformed([&](uint8 p){ return nativeCol.col16[p]; }, ppuPixRegion);
+		pix.writeIndexed(ppuPixRegion, nativeCol.col16);
 	}
 	else
 	{
 		assumeExpr(pix.format().bytesPerPixel() == 4);
-		pix.writeTransformed([&](uint8 p){ return nativeCol.col32[p]; }, ppuPixRegion);
+		pix.writeIndexed(ppuPixRegion, nativeCol.col32);
 	}
 	img.endFrame();
 }
@@ -79,6 +79,10 @@ void NgpSystem::loadState(EmuApp &, IG::CStringView path)
 		throwFileReadError();
 }
 
+size_t NgpSystem::stateSize() { return stateSizeMDFN(); }
+size_t NgpSystem::saveState(std::span<uint8_t> buff) { return saveStateMDFN(buff); }
+void NgpSystem::loadState(std::span<const uint8_t> buff) { loadStateMDFN(buff); }
+
 static FS::PathString saveFilename(const EmuApp &app)
 {
 	return app.contentSaveFilePath(".ngf");
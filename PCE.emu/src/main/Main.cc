@@ -107,6 +107,11 @@ void PceSystem::closeSystem()
 	}
 }
 
+void PceSystem::addThreadGroupIds(std::vector<ThreadId> &ids) const
+{
+	addMDFNThreadIds(ids);
+}
+
 static void writeCDMD5(MDFNGI &mdfnGameInfo, CDInterface &cdInterface)
 {
 	CDUtility::TOC toc;
@@ -246,6 +251,10 @@ void PceSystem::loadState(EmuApp &, CStringView path)
 		throwFileReadError();
 }
 
+size_t PceSystem::stateSize() { return stateSizeMDFN(); }
+size_t PceSystem::saveState(std::span<uint8_t> buff) { return saveStateMDFN(buff); }
+void PceSystem::loadState(std::span<const uint8_t> buff) { loadStateMDFN(buff); }
+
 double PceSystem::videoAspectRatioScale() const
 {
 	double baseLines = 224.;
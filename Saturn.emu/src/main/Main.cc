@@ -17,6 +17,8 @@
 #include <emuframework/EmuSystemInlines.hh>
 #include <emuframework/EmuAppInlines.hh>
 #include <imagine/fs/FS.hh>
+#include <imagine/io/FileStream.hh>
+#include <imagine/io/MapIO.hh>
 #include <imagine/util/format.hh>
 #include <imagine/util/string.h>
 
@@ -267,6 +269,68 @@ void SaturnSystem::loadState(EmuApp &, IG::CStringView path)
 		throwFileReadError();
 }
 
+// Write-only stream target for YabSaveStateStream() that keeps tracking the size
+// past the end of the buffer so stateSize() can run it without any storage
+struct StateBufferIO
+{
+	std::span<uint8_t> buff;
+	size_t pos{};
+	size_t size{};
+
+	ssize_t read(void *, size_t) { return -1; }
+
+	ssize_t write(const void *data, size_t bytes)
+	{
+		if(pos < buff.size())
+			std::memcpy(buff.data() + pos, data, std::min(bytes, buff.size() - pos));
+		pos += bytes;
+		size = std::max(size, pos);
+		return bytes;
+	}
+
+	off_t seek(off_t offset, IOSeekMode mode)
+	{
+		off_t base = mode == IOSeekMode::Cur ? pos : mode == IOSeekMode::End ? size : 0;
+		if(base + offset < 0)
+			return -1;
+		pos = base + offset;
+		return pos;
+	}
+};
+
+static size_t saveStateToBuffer(std::span<uint8_t> buff)
+{
+	FileStream<StateBufferIO> stream{StateBufferIO{buff}, "wb"};
+	auto ret = YabSaveStateStream(stream.filePtr());
+	fflush(stream.filePtr());
+	if(ret != 0)
+		EmuSystem::throwFileWriteError();
+	return static_cast<StateBufferIO&>(stream).size;
+}
+
+size_t SaturnSystem::stateSize()
+{
+	if(!stateSize_)
+		stateSize_ = saveStateToBuffer({});
+	return stateSize_;
+}
+
+size_t SaturnSystem::saveState(std::span<uint8_t> buff)
+{
+	auto size = saveStateToBuffer(buff);
+	stateSize_ = std::max(stateSize_, size);
+	if(size > buff.size())
+		throwStateBufferSizeError();
+	return size;
+}
+
+void SaturnSystem::loadState(std::span<const uint8_t> buff)
+{
+	FileStream<MapIO> stream{MapIO{IOBuffer{{const_cast<uint8_t*>(buff.data()), buff.size()}, 0}}, "rb"};
+	if(YabLoadStateStream(stream.filePtr(), nullptr) != 0)
+		throwFileReadError();
+}
+
 void SaturnSystem::onFlushBackupMemory(EmuApp &, BackupMemoryDirtyFlags)
 {
 	if(hasContent())
@@ -280,6 +344,7 @@ static bool yabauseIsInit = 0;
 
 void SaturnSystem::closeSystem()
 {
+	stateSize_ = 0;
 	if(yabauseIsInit)
 	{
 		YabauseDeInit();
@@ -336,15 +401,14 @@ void EmuApp::onCustomizeNavView(EmuApp::NavView &view)
 static void SNDImagineUpdateAudio(u32 *leftchanbuffer, u32 *rightchanbuffer, u32 frames)
 {
 	//logMsg("got %d audio frames to write", frames);
-	s16 sample[frames*2];
+	if(!EmuEx::emuAudio)
+		return;
+	auto sample = static_cast<s16*>(EmuEx::emuAudio->beginWrite(frames));
 	for(auto i : IG::iotaCount(frames))
 	{
 		mergeSamplesToStereo(leftchanbuffer[i], rightchanbuffer[i], &sample[i*2]);
 	}
-	if(EmuEx::emuAudio)
-	{
-		EmuEx::emuAudio->writeFrames(sample, frames);
-	}
+	EmuEx::emuAudio->commitWrite(frames);
 }
 
 CLINK void DisplayMessage(const char* str) {}
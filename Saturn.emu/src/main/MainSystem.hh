@@ -30,6 +30,8 @@ extern PerPad_struct *pad[2];
 class SaturnSystem final: public EmuSystem
 {
 public:
+	size_t stateSize_{}; // cached until the game is closed
+
 	SaturnSystem(ApplicationContext ctx):
 		EmuSystem{ctx}
 	{
@@ -43,6 +45,9 @@ public:
 	std::string_view stateFilenameExt() const { return ".yss"; }
 	void loadState(EmuApp &, CStringView uri);
 	void saveState(CStringView path);
+	size_t stateSize();
+	size_t saveState(std::span<uint8_t> buff);
+	void loadState(std::span<const uint8_t> buff);
 	bool readConfig(ConfigType, MapIO &, unsigned key, size_t readSize);
 	void writeConfig(ConfigType, FileIO &);
 	void reset(EmuApp &, ResetMode mode);
@@ -992,10 +992,9 @@ void FormatBackupRam(void *mem, u32 size)
 //    [sh2core.c] frc.div changed to frc.shift
 //    [sh2core.c] wdt probably needs to be written as well
 
-int YabSaveState(const char *filename)
+int YabSaveStateStream(FILE *fp)
 {
    u32 i;
-   FILE *fp;
    int offset;
    IOCheck_struct check;
    u8 *buf;
@@ -1009,14 +1008,6 @@ int YabSaveState(const char *filename)
    check.done = 0;
    check.size = 0;
 
-   //use a second set of savestates for movies
-   filename = MakeMovieStateName(filename);
-   if (!filename)
-      return -1;
-
-   if ((fp = fopen(filename, "wb")) == NULL)
-      return -1;
-
    // Write signature
    fprintf(fp, "YSS");
 
@@ -1106,19 +1097,39 @@ int YabSaveState(const char *filename)
    ywrite(&check, (void *)&i, sizeof(i), 1, fp);
    fseek(fp, 16, SEEK_SET);
    ywrite(&check, (void *)&movieposition, sizeof(movieposition), 1, fp);
+   fseek(fp, 0, SEEK_END);
+
+   return 0;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+int YabSaveState(const char *filename)
+{
+   FILE *fp;
+   int ret;
+
+   //use a second set of savestates for movies
+   filename = MakeMovieStateName(filename);
+   if (!filename)
+      return -1;
+
+   if ((fp = fopen(filename, "wb")) == NULL)
+      return -1;
 
+   ret = YabSaveStateStream(fp);
    fclose(fp);
 
-   OSDPushMessage(OSDMSG_STATUS, 150, "STATE SAVED");
+   if (ret == 0)
+      OSDPushMessage(OSDMSG_STATUS, 150, "STATE SAVED");
 
-   return 0;
+   return ret;
 }
 
 //////////////////////////////////////////////////////////////////////////////
 
-int YabLoadState(const char *filename)
+int YabLoadStateStream(FILE *fp, const char *filename)
 {
-   FILE *fp;
    char id[3];
    u8 endian;
    int headerversion, version, size, chunksize, headersize;
@@ -1133,13 +1144,6 @@ int YabLoadState(const char *filename)
    int temp;
    u32 temp32;
 
-   filename = MakeMovieStateName(filename);
-   if (!filename)
-      return -1;
-
-   if ((fp = fopen(filename, "rb")) == NULL)
-      return -1;
-
    headersize = 0xC;
 
    // Read signature
@@ -1147,7 +1151,6 @@ int YabLoadState(const char *filename)
 
    if (strncmp(id, "YSS", 3) != 0)
    {
-      fclose(fp);
       return -2;
    }
 
@@ -1170,7 +1173,6 @@ int YabLoadState(const char *filename)
       default:
          /* we're trying to open a save state using a future version
           * of the YSS format, that won't work, sorry :) */
-         fclose(fp);
          return -3;
          break;
    }
@@ -1183,7 +1185,6 @@ int YabLoadState(const char *filename)
    {
       // should setup reading so it's byte-swapped
       YabSetError(YAB_ERR_OTHER, (void *)"Load State byteswapping not supported");
-      fclose(fp);
       return -3;
    }
 
@@ -1192,7 +1193,6 @@ int YabLoadState(const char *filename)
 
    if (size != (ftell(fp) - headersize))
    {
-      fclose(fp);
       return -2;
    }
    fseek(fp, headersize, SEEK_SET);
@@ -1203,7 +1203,6 @@ int YabLoadState(const char *filename)
    
    if (StateCheckRetrieveHeader(fp, "CART", &version, &chunksize) != 0)
    {
-      fclose(fp);
       // Revert back to old state here
       ScspUnMuteAudio(SCSP_MUTE_SYSTEM);
       return -3;
@@ -1212,7 +1211,6 @@ int YabLoadState(const char *filename)
 
    if (StateCheckRetrieveHeader(fp, "CS2 ", &version, &chunksize) != 0)
    {
-      fclose(fp);
       // Revert back to old state here
       ScspUnMuteAudio(SCSP_MUTE_SYSTEM);
       return -3;
@@ -1221,7 +1219,6 @@ int YabLoadState(const char *filename)
 
    if (StateCheckRetrieveHeader(fp, "MSH2", &version, &chunksize) != 0)
    {
-      fclose(fp);
       // Revert back to old state here
       ScspUnMuteAudio(SCSP_MUTE_SYSTEM);
       return -3;
@@ -1230,7 +1227,6 @@ int YabLoadState(const char *filename)
 
    if (StateCheckRetrieveHeader(fp, "SSH2", &version, &chunksize) != 0)
    {
-      fclose(fp);
       // Revert back to old state here
       ScspUnMuteAudio(SCSP_MUTE_SYSTEM);
       return -3;
@@ -1239,7 +1235,6 @@ int YabLoadState(const char *filename)
 
    if (StateCheckRetrieveHeader(fp, "SCSP", &version, &chunksize) != 0)
    {
-      fclose(fp);
       // Revert back to old state here
       ScspUnMuteAudio(SCSP_MUTE_SYSTEM);
       return -3;
@@ -1248,7 +1243,6 @@ int YabLoadState(const char *filename)
 
    if (StateCheckRetrieveHeader(fp, "SCU ", &version, &chunksize) != 0)
    {
-      fclose(fp);
       // Revert back to old state here
       ScspUnMuteAudio(SCSP_MUTE_SYSTEM);
       return -3;
@@ -1257,7 +1251,6 @@ int YabLoadState(const char *filename)
 
    if (StateCheckRetrieveHeader(fp, "SMPC", &version, &chunksize) != 0)
    {
-      fclose(fp);
       // Revert back to old state here
       ScspUnMuteAudio(SCSP_MUTE_SYSTEM);
       return -3;
@@ -1266,7 +1259,6 @@ int YabLoadState(const char *filename)
 
    if (StateCheckRetrieveHeader(fp, "VDP1", &version, &chunksize) != 0)
    {
-      fclose(fp);
       // Revert back to old state here
       ScspUnMuteAudio(SCSP_MUTE_SYSTEM);
       return -3;
@@ -1275,7 +1267,6 @@ int YabLoadState(const char *filename)
 
    if (StateCheckRetrieveHeader(fp, "VDP2", &version, &chunksize) != 0)
    {
-      fclose(fp);
       // Revert back to old state here
       ScspUnMuteAudio(SCSP_MUTE_SYSTEM);
       return -3;
@@ -1284,7 +1275,6 @@ int YabLoadState(const char *filename)
 
    if (StateCheckRetrieveHeader(fp, "OTHR", &version, &chunksize) != 0)
    {
-      fclose(fp);
       // Revert back to old state here
       ScspUnMuteAudio(SCSP_MUTE_SYSTEM);
       return -3;
@@ -1341,17 +1331,36 @@ int YabLoadState(const char *filename)
    MovieReadState(fp, filename);
    }
    
-   fclose(fp);
-
    ScspUnMuteAudio(SCSP_MUTE_SYSTEM);
 
-   OSDPushMessage(OSDMSG_STATUS, 150, "STATE LOADED");
-
    return 0;
 }
 
 //////////////////////////////////////////////////////////////////////////////
 
+int YabLoadState(const char *filename)
+{
+   FILE *fp;
+   int ret;
+
+   filename = MakeMovieStateName(filename);
+   if (!filename)
+      return -1;
+
+   if ((fp = fopen(filename, "rb")) == NULL)
+      return -1;
+
+   ret = YabLoadStateStream(fp, filename);
+   fclose(fp);
+
+   if (ret == 0)
+      OSDPushMessage(OSDMSG_STATUS, 150, "STATE LOADED");
+
+   return ret;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
 int YabSaveStateSlot(const char *dirpath, u8 slot)
 {
    char filename[512];
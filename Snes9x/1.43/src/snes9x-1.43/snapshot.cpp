@@ -127,6 +127,55 @@ END_EXTERN_C
 
 bool8 S9xUnfreezeZSNES (const char *filename);
 
+// Memory buffer used in place of the STREAM by the S9xFreezeGameMem()
+// family of functions, a NULL buf only counts the bytes written
+struct SnapshotMemStream
+{
+    uint8 *buf;
+    uint32 size;
+    uint32 pos;
+};
+
+static SnapshotMemStream *memStream = NULL;
+
+static int SnapshotWrite (const void *p, int l, STREAM s)
+{
+    if (!memStream)
+		return WRITE_STREAM (p, l, s);
+    if (memStream->buf && memStream->pos + l <= memStream->size)
+		memcpy (memStream->buf + memStream->pos, p, l);
+    memStream->pos += l;
+    return l;
+}
+
+static int SnapshotRead (void *p, int l, STREAM s)
+{
+    if (!memStream)
+		return READ_STREAM (p, l, s);
+    if (memStream->pos + l > memStream->size)
+		l = memStream->size - memStream->pos;
+    memcpy (p, memStream->buf + memStream->pos, l);
+    memStream->pos += l;
+    return l;
+}
+
+static long SnapshotTell (STREAM s)
+{
+    if (!memStream)
+		return FIND_STREAM (s);
+    return memStream->pos;
+}
+
+static void SnapshotRevert (STREAM s, long pos)
+{
+    if (!memStream)
+    {
+		REVERT_STREAM (s, pos, 0);
+		return;
+    }
+    memStream->pos = pos;
+}
+
 typedef struct {
     int offset;
     int size;
@@ -569,6 +618,33 @@ bool8 S9xFreezeGame (const char *filename)
     return (FALSE);
 }
 
+uint32 S9xFreezeSize ()
+{
+    SnapshotMemStream mStream = {NULL, 0, 0};
+    memStream = &mStream;
+    S9xFreezeToStream (NULL);
+    memStream = NULL;
+    return mStream.pos;
+}
+
+uint32 S9xFreezeGameMem (uint8 *buf, uint32 bufSize)
+{
+    SnapshotMemStream mStream = {buf, bufSize, 0};
+    memStream = &mStream;
+    S9xFreezeToStream (NULL);
+    memStream = NULL;
+    return mStream.pos <= bufSize ? mStream.pos : 0;
+}
+
+int S9xUnfreezeGameMem (const uint8 *buf, uint32 bufSize)
+{
+    SnapshotMemStream mStream = {(uint8 *)buf, bufSize, 0};
+    memStream = &mStream;
+    int result = S9xUnfreezeFromStream (NULL);
+    memStream = NULL;
+    return result;
+}
+
 bool8 S9xLoadSnapshot (const char *filename)
 {
     return (S9xUnfreezeGame (filename));
@@ -647,10 +723,10 @@ void S9xFreezeToStream (STREAM stream)
 		SoundData.channels [i].previous16 [1] = (int16) SoundData.channels [i].previous [1];
     }
     sprintf (buffer, "%s:%04d\n", SNAPSHOT_MAGIC, SNAPSHOT_VERSION);
-    WRITE_STREAM (buffer, strlen (buffer), stream);
+    SnapshotWrite (buffer, strlen (buffer), stream);
     sprintf (buffer, "NAM:%06d:%s%c", (int)Memory.ROMFilename.size() + 1,
 		Memory.ROMFilename.c_str(), 0);
-    WRITE_STREAM (buffer, strlen (buffer) + 1, stream);
+    SnapshotWrite (buffer, strlen (buffer) + 1, stream);
     FreezeStruct (stream, "CPU", &CPU, SnapCPU, COUNT (SnapCPU));
     FreezeStruct (stream, "REG", &Registers, SnapRegisters, COUNT (SnapRegisters));
     FreezeStruct (stream, "PPU", &PPU, SnapPPU, COUNT (SnapPPU));
@@ -720,7 +796,7 @@ int S9xUnfreezeFromStream (STREAM stream)
 	
     int version;
     int len = strlen (SNAPSHOT_MAGIC) + 1 + 4 + 1;
-    if (READ_STREAM (buffer, len, stream) != len)
+    if (SnapshotRead (buffer, len, stream) != len)
 		return (WRONG_FORMAT);
     if (strncmp (buffer, SNAPSHOT_MAGIC, strlen (SNAPSHOT_MAGIC)) != 0)
 		return (WRONG_FORMAT);
@@ -1062,8 +1138,8 @@ static void FreezeBlock (STREAM stream, const char *name, uint8 *block, int size
 {
     char buffer [512];
     sprintf (buffer, "%s:%06d:", name, size);
-    WRITE_STREAM (buffer, strlen (buffer), stream);
-    WRITE_STREAM (block, size, stream);
+    SnapshotWrite (buffer, strlen (buffer), stream);
+    SnapshotWrite (block, size, stream);
     
 }
 
@@ -1167,11 +1243,11 @@ static int UnfreezeBlock (STREAM stream, const char *name, uint8 *block, int siz
     int len = 0;
     int rem = 0;
     int rew_len;
-    if (READ_STREAM (buffer, 11, stream) != 11 ||
+    if (SnapshotRead (buffer, 11, stream) != 11 ||
 		strncmp (buffer, name, 3) != 0 || buffer [3] != ':' ||
 		(len = atoi (&buffer [4])) == 0)
     {
-		REVERT_STREAM(stream, FIND_STREAM(stream)-11, 0);
+		SnapshotRevert (stream, SnapshotTell (stream)-11);
 		return (WRONG_FORMAT);
     }
 
@@ -1180,15 +1256,15 @@ static int UnfreezeBlock (STREAM stream, const char *name, uint8 *block, int siz
 		rem = len - size;
 		len = size;
     }
-    if ((rew_len=READ_STREAM (block, len, stream)) != len)
+    if ((rew_len=SnapshotRead (block, len, stream)) != len)
 	{
-		REVERT_STREAM(stream, FIND_STREAM(stream)-11-rew_len, 0);
+		SnapshotRevert (stream, SnapshotTell (stream)-11-rew_len);
 		return (WRONG_FORMAT);
 	}
     if (rem)
     {
 		char *junk = new char [rem];
-		READ_STREAM (junk, rem, stream);
+		SnapshotRead (junk, rem, stream);
 		delete [] junk;
     }
 	
@@ -110,6 +110,9 @@ bool8 S9xLoadSnapshot (const char *filename);
 bool8 S9xSPCDump (const char *filename);
 void S9xFreezeToStream (STREAM);
 int S9xUnfreezeFromStream (STREAM);
+uint32 S9xFreezeSize (void);
+uint32 S9xFreezeGameMem (uint8 *,uint32); // returns bytes written, 0 if the buffer is too small
+int S9xUnfreezeGameMem (const uint8 *,uint32);
 END_EXTERN_C
 
 #endif
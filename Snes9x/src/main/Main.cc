@@ -121,6 +121,26 @@ void Snes9xSystem::loadState(EmuApp &, IG::CStringView path)
 		return throwFileReadError();
 }
 
+size_t Snes9xSystem::stateSize() { return S9xFreezeSize(); }
+
+size_t Snes9xSystem::saveState(std::span<uint8_t> buff)
+{
+	auto size = S9xFreezeGameMem(buff.data(), buff.size());
+	if(!size)
+		throwStateBufferSizeError();
+	return size;
+}
+
+void Snes9xSystem::loadState(std::span<const uint8_t> buff)
+{
+	if(S9xUnfreezeGameMem(buff.data(), buff.size()) == SUCCESS)
+	{
+		IPPU.RenderThisFrame = TRUE;
+	}
+	else
+		throwFileReadError();
+}
+
 void Snes9xSystem::loadBackupMemory(EmuApp &app)
 {
 	if(!Memory.SRAMSize)
@@ -1025,12 +1025,29 @@ uint32 S9xFreezeSize()
     return stream.size();
 }
 
-bool8 S9xFreezeGameMem (uint8 *buf, uint32 bufSize)
+// memStream that records if any write was truncated
+class checkedMemStream : public memStream
 {
-    memStream mStream(buf, bufSize);
+	public:
+		using memStream::memStream;
+
+		size_t write (void *buf, size_t len) override
+		{
+			size_t bytes = memStream::write(buf, len);
+			if (bytes != len)
+				overflow = true;
+			return bytes;
+		}
+
+		bool overflow = false;
+};
+
+uint32 S9xFreezeGameMem (uint8 *buf, uint32 bufSize)
+{
+    checkedMemStream mStream(buf, bufSize);
 	S9xFreezeToStream(&mStream);
 
-	return (TRUE);
+	return mStream.overflow ? 0 : mStream.pos();
 }
 
 bool8 S9xFreezeGame (const char *filename)
@@ -26,7 +26,7 @@
 void S9xResetSaveTimer (bool8);
 bool8 S9xFreezeGame (const char *);
 uint32 S9xFreezeSize (void);
-bool8 S9xFreezeGameMem (uint8 *,uint32);
+uint32 S9xFreezeGameMem (uint8 *,uint32); // returns bytes written, 0 if the buffer is too small
 bool8 S9xUnfreezeGame (const char *);
 int S9xUnfreezeGameMem (const uint8 *,uint32);
 void S9xFreezeToStream (STREAM);
@@ -76,6 +76,10 @@ void WsSystem::loadState(EmuApp &, IG::CStringView path)
 		throwFileReadError();
 }
 
+size_t WsSystem::stateSize() { return stateSizeMDFN(); }
+size_t WsSystem::saveState(std::span<uint8_t> buff) { return saveStateMDFN(buff); }
+void WsSystem::loadState(std::span<const uint8_t> buff) { loadStateMDFN(buff); }
+
 void WsSystem::loadBackupMemory(EmuApp &app)
 {
 	if(!eeprom_size && !sram_size)
@@ -27,7 +27,10 @@ public:
 	static constexpr bool HAS_SOLO_MIX = false;
 	static constexpr bool SOLO_MIX_DEFAULT = false;
 
-	constexpr BasicManager(ApplicationContext) {};
+	BasicManager(ApplicationContext ctx): ctx{ctx} {}
+
+protected:
+	ApplicationContext ctx;
 };
 
 using ManagerImpl = BasicManager;
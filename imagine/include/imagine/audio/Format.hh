@@ -73,7 +73,11 @@ struct Format
 		return framesToBytes(timeToFrames(time));
 	}
 
+	// srcFormat must have the same channel count, or be mono when this format is stereo
 	void *copyFrames(void *dest, const void *src, size_t frames, Format srcFormat, float volume = 1.f) const;
 };
 
+// name of the SIMD sample conversion code selected for this CPU
+const char *sampleConvertImplName();
+
 }
@@ -26,6 +26,7 @@
 
 #include <imagine/audio/Format.hh>
 #include <imagine/audio/defs.hh>
+#include <imagine/fs/FSDefs.hh>
 #include <vector>
 #include <optional>
 
@@ -62,6 +63,8 @@ public:
 	std::vector<ApiDesc> audioAPIs() const;
 	Api makeValidAPI(Api api = Api::DEFAULT) const;
 	OutputStreamConfig makeNativeOutputStreamConfig() const;
+	// file written by the WAV_FILE API, inside the app's storage directory
+	FS::PathString wavFilePath() const;
 };
 
 }
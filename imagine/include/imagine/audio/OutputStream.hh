@@ -29,6 +29,9 @@
 	#ifdef CONFIG_AUDIO_ALSA
 	#include <imagine/audio/alsa/ALSAOutputStream.hh>
 	#endif
+	#ifdef CONFIG_AUDIO_TIMED
+	#include <imagine/audio/timed/TimedOutputStream.hh>
+	#endif
 #endif
 
 #include <imagine/audio/defs.hh>
@@ -79,6 +82,9 @@ using OutputStreamVariant = std::variant<CAOutputStream, NullOutputStream>;
 	#ifdef CONFIG_AUDIO_ALSA
 	ALSAOutputStream,
 	#endif
+	#ifdef CONFIG_AUDIO_TIMED
+	TimedOutputStream,
+	#endif
 	NullOutputStream>;
 #endif
 
@@ -97,6 +103,8 @@ public:
 	void flush();
 	bool isOpen();
 	bool isPlaying();
+	// time until newly written samples are heard, if reported by the backend
+	Microseconds latency() const;
 	void reset();
 	explicit constexpr operator bool() const { return !std::holds_alternative<NullOutputStream>(*this); }
 };
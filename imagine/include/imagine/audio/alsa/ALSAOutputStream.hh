@@ -42,6 +42,7 @@ public:
 	void flush();
 	bool isOpen();
 	bool isPlaying();
+	Microseconds latency() const;
 	explicit operator bool() const;
 
 private:
@@ -52,6 +53,7 @@ private:
 	snd_pcm_uframes_t bufferSize, periodSize;
 	bool useMmap;
 	std::atomic_bool quitFlag{};
+	std::atomic_long delayFrames{};
 
 	int setupPcm(Format format, snd_pcm_access_t access, Microseconds wantedLatency);
 };
@@ -38,6 +38,8 @@ enum class Api: uint8_t
 	COREAUDIO,
 	OPENSL_ES,
 	AAUDIO,
+	NULL_SINK, // discards samples at the stream's rate
+	WAV_FILE, // writes samples to a file at the stream's rate
 };
 
 struct ApiDesc
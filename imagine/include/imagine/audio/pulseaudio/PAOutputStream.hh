@@ -17,6 +17,7 @@
 
 #include <imagine/audio/defs.hh>
 #include <imagine/audio/Format.hh>
+#include <atomic>
 
 struct pa_context;
 struct pa_stream;
@@ -47,6 +48,7 @@ public:
 	void flush();
 	bool isOpen();
 	bool isPlaying();
+	Microseconds latency() const { return Microseconds{latencyUSecs.load(std::memory_order_relaxed)}; }
 	explicit operator bool() const;
 
 private:
@@ -60,6 +62,7 @@ private:
 	#endif
 	OnSamplesNeededDelegate onSamplesNeeded{};
 	Format pcmFormat;
+	std::atomic_int32_t latencyUSecs{};
 	bool isCorked = true;
 
 	void lockMainLoop();
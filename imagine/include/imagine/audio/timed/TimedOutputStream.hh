@@ -0,0 +1,69 @@
+#pragma once
+
+/*  This file is part of Imagine.
+
+	Imagine is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Imagine is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Imagine.  If not, see <http://www.gnu.org/licenses/> */
+
+#include <imagine/audio/defs.hh>
+#include <imagine/audio/Format.hh>
+#include <imagine/io/FileIO.hh>
+#include <imagine/fs/FSDefs.hh>
+#include <atomic>
+#include <thread>
+
+namespace IG
+{
+class ErrorCode;
+}
+
+namespace IG::Audio
+{
+
+// Output stream with no device, samples are requested on a thread paced by the steady clock
+// at the stream's rate and either discarded or written to a WAV file
+class TimedOutputStream
+{
+public:
+	TimedOutputStream() = default;
+	// if wavPath isn't empty, output is written there
+	TimedOutputStream(CStringView wavPath);
+	~TimedOutputStream();
+	TimedOutputStream &operator=(TimedOutputStream &&) = delete;
+	ErrorCode open(OutputStreamConfig config);
+	void play();
+	void pause();
+	void close();
+	void flush();
+	bool isOpen();
+	bool isPlaying();
+	Microseconds latency() const;
+	explicit operator bool() const;
+
+private:
+	OnSamplesNeededDelegate onSamplesNeeded{};
+	std::thread thread;
+	FS::PathString wavPath;
+	FileIO wavFile;
+	Format pcmFormat;
+	size_t periodFrames{};
+	size_t wavDataBytes{};
+	std::atomic_bool playing{};
+	std::atomic_bool quitFlag{};
+	int lateWakeups{}; // times the thread woke up more than a period late and skipped ahead
+
+	void run();
+	void writeWavHeader();
+};
+
+}
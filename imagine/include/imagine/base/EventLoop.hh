@@ -19,6 +19,8 @@
 
 #if defined __ANDROID__
 #include <imagine/base/eventloop/ALooperEventLoop.hh>
+#elif defined __linux__ && defined CONFIG_BASE_EPOLL
+#include <imagine/base/eventloop/EpollEventLoop.hh>
 #elif defined __linux__
 #include <imagine/base/eventloop/GlibEventLoop.hh>
 #define CONFIG_BASE_GLIB
@@ -64,6 +66,8 @@ public:
 	bool attach(EventLoop loop, PollEventDelegate callback, uint32_t events = POLLEV_IN);
 	#if defined CONFIG_BASE_GLIB
 	bool attach(EventLoop, GSource *, uint32_t events = POLLEV_IN);
+	#elif defined CONFIG_BASE_EPOLL
+	bool attach(EventLoop, PollEventDelegate callback, PollPrepareDelegate prepare, uint32_t events = POLLEV_IN);
 	#endif
 	void detach();
 	void setEvents(uint32_t events);
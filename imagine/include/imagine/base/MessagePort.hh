@@ -17,11 +17,15 @@
 
 #include <imagine/config/defs.hh>
 #include <imagine/base/Pipe.hh>
+#include <imagine/base/CustomEvent.hh>
 #include <imagine/thread/Semaphore.hh>
+#include <imagine/thread/SPSCQueue.hh>
 #include <imagine/util/concepts.hh>
 #include <imagine/util/utility.h>
+#include <atomic>
 #include <cstring>
 #include <span>
+#include <thread>
 
 namespace IG
 {
@@ -210,6 +214,155 @@ protected:
 	Pipe pipe{Pipe::NullInit{}};
 };
 
+// Message port for a single sending thread, messages are passed through a lock-free ring buffer
+// and the receiving event loop is only woken once per batch of messages
+template<class MsgType, size_t Capacity = 64>
+class SPSCMessagePort
+{
+public:
+	class Messages
+	{
+	public:
+		struct Sentinel {};
+
+		class Iterator
+		{
+		public:
+			constexpr Iterator(SPSCQueue<MsgType, Capacity> &queue): queue{&queue}
+			{
+				this->operator++();
+			}
+
+			Iterator operator++()
+			{
+				if(!queue) [[unlikely]]
+					return *this;
+				if(auto nextMsg = queue->pop(); nextMsg)
+					msg = *nextMsg;
+				else
+					queue = nullptr; // end of messages
+				return *this;
+			}
+
+			bool operator==(Sentinel) const
+			{
+				return !queue;
+			}
+
+			const MsgType &operator*() const
+			{
+				return msg;
+			}
+
+		private:
+			SPSCQueue<MsgType, Capacity> *queue{};
+			MsgType msg;
+		};
+
+		constexpr Messages(SPSCQueue<MsgType, Capacity> &queue): queue{queue} {}
+		auto begin() const { return Iterator{queue}; }
+		auto end() const { return Sentinel{}; }
+
+	protected:
+		SPSCQueue<MsgType, Capacity> &queue;
+	};
+
+	struct NullInit{};
+
+	SPSCMessagePort(const char *debugLabel = nullptr):
+		event{debugLabel} {}
+
+	explicit SPSCMessagePort(NullInit): event{CustomEvent::NullInit{}} {}
+
+	void attach(auto &&f)
+	{
+		attach(EventLoop::forThread(), IG_forward(f));
+	}
+
+	void attach(EventLoop loop, Callable<void, Messages> auto &&f)
+	{
+		attach(loop, [=](Messages msgs) { f(msgs); return true; });
+	}
+
+	void attach(EventLoop loop, Callable<bool, Messages> auto &&f)
+	{
+		// keep the callback in the port so the event delegate only needs to capture this
+		msgDelegate = IG_forward(f);
+		event.attach(loop,
+			PollEventDelegate
+			{
+				[this](int, int) -> bool
+				{
+					event.cancel();
+					// clear the flag before reading so any message sent after this point notifies again,
+					// the fence pairs with the one in send() so either the queue read below sees the
+					// new message or the sender sees the cleared flag
+					wakeupPending.store(false, std::memory_order_relaxed);
+					std::atomic_thread_fence(std::memory_order_seq_cst);
+					return msgDelegate(Messages{queue});
+				}
+			});
+	}
+
+	void detach()
+	{
+		event.detach();
+	}
+
+	bool send(MsgType msg)
+	{
+		while(!queue.push(msg)) [[unlikely]]
+		{
+			std::this_thread::yield();
+		}
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		if(!wakeupPending.exchange(true, std::memory_order_relaxed))
+			event.notify();
+		return true;
+	}
+
+	bool send(MsgType msg, bool awaitReply)
+	{
+		if(awaitReply)
+		{
+			std::binary_semaphore replySemaphore{0};
+			return send(msg, &replySemaphore);
+		}
+		else
+		{
+			return send(msg);
+		}
+	}
+
+	bool send(ReplySemaphoreSettableMessage auto msg, std::binary_semaphore *semPtr)
+	{
+		if(semPtr)
+		{
+			msg.setReplySemaphore(semPtr);
+			send(msg);
+			semPtr->acquire();
+			return true;
+		}
+		else
+		{
+			return send(msg);
+		}
+	}
+
+	void clear()
+	{
+		while(queue.pop()) {}
+	}
+
+	explicit operator bool() const { return (bool)event; }
+
+protected:
+	SPSCQueue<MsgType, Capacity> queue;
+	CustomEvent event;
+	DelegateFunc<bool(Messages)> msgDelegate;
+	std::atomic_bool wakeupPending{};
+};
+
 template<class MsgType>
 using MessagePort = PipeMessagePort<MsgType>;
 
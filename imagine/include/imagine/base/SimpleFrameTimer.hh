@@ -24,14 +24,29 @@ namespace IG
 
 class Screen;
 
+// Simulates vsync with a timer that wakes a small margin before each frame deadline and then
+// yields until the exact time. Deadlines are kept on a fixed grid from when the timer started
+// so late wakeups don't accumulate into drift, and fractional frame rates are kept exact.
 class SimpleFrameTimer final
 {
 public:
+	struct WakeupStats
+	{
+		Nanoseconds averageError{};
+		Nanoseconds maxError{};
+		int missedFrames{};
+	};
+
+	static constexpr Nanoseconds defaultWakeupMargin{Microseconds{500}};
+
 	constexpr SimpleFrameTimer() = default;
 	SimpleFrameTimer(Screen &screen, EventLoop loop = {});
 	void scheduleVSync();
 	void cancel();
 	void setFrameRate(FrameRate);
+	void setWakeupMargin(Nanoseconds);
+	// stats from the last complete window of about 10 seconds
+	WakeupStats wakeupStats() const { return lastStats; }
 
 	explicit operator bool() const
 	{
@@ -39,11 +54,29 @@ public:
 	}
 
 protected:
+	using PreciseNanoseconds = std::chrono::duration<double, std::nano>;
+
 	Timer timer{Timer::NullInit{}};
+	SteadyClockTimePoint gridStart{};
+	PreciseNanoseconds period{};
 	Nanoseconds interval{};
+	Nanoseconds wakeupMargin{defaultWakeupMargin};
+	int64_t timerStartSlot{};
+	int64_t lastSlot{-1};
+	Nanoseconds statsErrorSum{};
+	WakeupStats stats{};
+	WakeupStats lastStats{};
+	int statsFrames{};
 	EventLoop eventLoop{};
 	bool requested{};
 	bool keepTimer{};
+
+	void start();
+	void armTimer(int64_t slot);
+	Nanoseconds margin() const;
+	SteadyClockTimePoint slotTime(int64_t slot) const;
+	SteadyClockTimePoint waitForNextSlot();
+	void updateStats(Nanoseconds error, int64_t missedSlots);
 };
 
 }
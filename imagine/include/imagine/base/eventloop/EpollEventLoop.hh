@@ -0,0 +1,93 @@
+#pragma once
+
+/*  This file is part of Imagine.
+
+	Imagine is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Imagine is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Imagine.  If not, see <http://www.gnu.org/licenses/> */
+
+#include <imagine/base/eventLoopDefs.hh>
+#include <imagine/util/used.hh>
+#include <imagine/util/memory/UniqueFileDescriptor.hh>
+#include <sys/epoll.h>
+#include <array>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace IG
+{
+
+static const int POLLEV_IN = EPOLLIN, POLLEV_OUT = EPOLLOUT, POLLEV_ERR = EPOLLERR, POLLEV_HUP = EPOLLHUP;
+
+// Called before the event loop blocks, returning true dispatches the source without waiting for its fd,
+// needed by libraries like Xlib that buffer events in user space
+using PollPrepareDelegate = DelegateFunc<bool ()>;
+
+struct EpollContext;
+
+struct EpollFDEventSourceInfo
+{
+	PollEventDelegate callback{};
+	PollPrepareDelegate prepare{};
+	EpollContext *ctx{};
+	int fd{-1};
+};
+
+struct EpollContext
+{
+	static constexpr int maxEvents = 16;
+
+	UniqueFileDescriptor epollFd{};
+	UniqueFileDescriptor wakeFd{};
+	std::vector<EpollFDEventSourceInfo*> preparingSources{};
+	std::array<epoll_event, maxEvents> events{};
+	int pendingEvents{};
+	int nextEvent{};
+};
+
+class EpollFDEventSource
+{
+public:
+	constexpr EpollFDEventSource() = default;
+	EpollFDEventSource(MaybeUniqueFileDescriptor fd) : EpollFDEventSource{nullptr, std::move(fd)} {}
+	EpollFDEventSource(const char *debugLabel, MaybeUniqueFileDescriptor fd);
+	EpollFDEventSource(EpollFDEventSource &&o) noexcept;
+	EpollFDEventSource &operator=(EpollFDEventSource &&o) noexcept;
+	~EpollFDEventSource();
+
+protected:
+	IG_UseMemberIf(Config::DEBUG_BUILD, const char *, debugLabel){};
+	std::unique_ptr<EpollFDEventSourceInfo> info;
+	MaybeUniqueFileDescriptor fd_;
+
+	const char *label() const;
+	void deinit();
+};
+
+using FDEventSourceImpl = EpollFDEventSource;
+
+class EpollEventLoop
+{
+public:
+	constexpr EpollEventLoop() = default;
+	constexpr EpollEventLoop(EpollContext *ctx): ctx{ctx} {}
+	int nativeObject() const { return ctx ? (int)ctx->epollFd : -1; }
+	EpollContext *context() const { return ctx; }
+
+protected:
+	EpollContext *ctx{};
+};
+
+using EventLoopImpl = EpollEventLoop;
+
+}
@@ -61,6 +61,9 @@ public:
 		fdSrc.setCallback(makeDelegate(IG_forward(f)));
 	}
 
+	// eventfd on Linux, kqueue otherwise
+	int fd() const { return fdSrc.fd(); }
+
 protected:
 	IG_UseMemberIf(Config::DEBUG_BUILD, const char *, debugLabel){};
 	FDEventSource fdSrc{};
@@ -0,0 +1,47 @@
+#pragma once
+
+/*  This file is part of Imagine.
+
+	Imagine is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Imagine is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Imagine.  If not, see <http://www.gnu.org/licenses/> */
+
+#include <imagine/io/MapIO.hh>
+#include <imagine/util/DelegateFunc.hh>
+#include <cstdint>
+#include <span>
+#include <string_view>
+
+namespace IG::FS
+{
+
+struct ArchiveEntryCacheKey
+{
+	std::string_view archivePath;
+	std::string_view entryName;
+	int64_t archiveWriteTime{};
+	uint64_t archiveSize{};
+};
+
+// writes the entry's decompressed data into the given span, returning false on error
+using ArchiveEntryExtractDelegate = DelegateFunc<bool (std::span<uint8_t>)>;
+
+constexpr size_t archiveEntryCacheSize = 256 * 1024 * 1024;
+
+// Returns a read-only mapping of a decompressed archive entry kept in an anonymous memory file,
+// extracting it with the delegate if not already cached, or an empty MapIO if the entry can't be
+// cached so the caller can extract it directly. Least recently used entries are dropped when over
+// the size budget, any mappings of them stay valid until closed.
+MapIO cachedArchiveEntry(const ArchiveEntryCacheKey &, size_t size, ArchiveEntryExtractDelegate);
+void clearArchiveEntryCache();
+
+}
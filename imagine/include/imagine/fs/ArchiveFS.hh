@@ -68,7 +68,7 @@ static ArchiveIterator end(const ArchiveIterator &)
 	return {};
 }
 
-ArchiveIO fileFromArchive(CStringView archivePath, std::string_view filePath);
+IO fileFromArchive(CStringView archivePath, std::string_view filePath);
 ArchiveIO fileFromArchive(IO archiveIO, std::string_view filePath);
 bool hasArchiveExtension(std::string_view name);
 
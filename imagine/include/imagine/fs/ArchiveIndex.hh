@@ -0,0 +1,102 @@
+#pragma once
+
+/*  This file is part of Imagine.
+
+	Imagine is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Imagine is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Imagine.  If not, see <http://www.gnu.org/licenses/> */
+
+#include <imagine/config/defs.hh>
+#include <imagine/fs/FSDefs.hh>
+#include <imagine/util/string/CStringView.hh>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+
+namespace IG
+{
+class IO;
+class FileIO;
+}
+
+namespace IG::FS
+{
+
+struct ArchiveEntryCacheKey;
+
+struct ArchiveIndexEntry
+{
+	static constexpr uint16_t noDirectOffset = 0xFFFF;
+
+	std::string name;
+	uint64_t size{};
+	uint64_t compressedSize{};
+	uint64_t headerOffset{}; // offset of the zip local file header, only valid if compression != noDirectOffset
+	uint32_t crc32{};
+	uint16_t compression{noDirectOffset}; // zip compression method
+	file_type type{file_type::regular};
+
+	bool hasDirectOffset() const { return compression != noDirectOffset; }
+};
+
+// List of an archive's entries built once from the zip central directory (or a full libarchive
+// scan for other formats) so entries can be looked up by name and opened without walking the archive
+class ArchiveIndex
+{
+public:
+	ArchiveIndex() = default;
+	ArchiveIndex(CStringView path);
+	CStringView path() const { return path_; }
+	std::span<const ArchiveIndexEntry> entries() const { return entries_; }
+	const ArchiveIndexEntry *find(std::string_view name) const;
+	// useEntryCache = false bypasses the extracted entry cache, for one-off reads like hashing that
+	// shouldn't evict the entries of loaded content
+	IO open(const ArchiveIndexEntry &, bool useEntryCache = true) const;
+	IO open(std::string_view name) const;
+	bool matchesFile(const file_status &) const;
+	bool readCache(FileIO &, CStringView path, const file_status &);
+	void writeCache(FileIO &) const;
+	explicit operator bool() const { return !path_.empty(); }
+
+	const ArchiveIndexEntry *findFirst(auto &&pred) const
+	{
+		for(const auto &e : entries_)
+		{
+			if(e.type != file_type::directory && pred(std::string_view{e.name}))
+				return &e;
+		}
+		return {};
+	}
+
+private:
+	PathString path_;
+	std::vector<ArchiveIndexEntry> entries_;
+	std::vector<uint32_t> sortedIdxs; // entry indices sorted by name for lookups
+	int64_t lastWriteTime{};
+	uint64_t fileSize{};
+
+	void readZipCentralDirectory(IO &);
+	void readWithArchiveScan();
+	void sortNames();
+	ArchiveEntryCacheKey cacheKey(const ArchiveIndexEntry &) const;
+};
+
+// Returns the index of the archive at a file system path, loading it from the memory or disk cache
+// when the file's modification time and size match, or nullptr if it can't be indexed,
+// useMemoryCache = false doesn't add a newly loaded index to the memory cache
+std::shared_ptr<const ArchiveIndex> archiveIndex(CStringView path, bool useMemoryCache = true);
+void setArchiveIndexCacheDirectory(CStringView path);
+
+}
@@ -0,0 +1,135 @@
+#pragma once
+
+/*  This file is part of Imagine.
+
+	Imagine is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Imagine is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Imagine.  If not, see <http://www.gnu.org/licenses/> */
+
+#include <imagine/config/defs.hh>
+#include <imagine/base/CustomEvent.hh>
+#ifdef __linux__
+#include <imagine/io/asyncio/IOUringQueue.hh>
+#endif
+#include <imagine/io/asyncio/ThreadIOQueue.hh>
+#include <imagine/util/DelegateFunc.hh>
+#include <sys/types.h>
+#include <cerrno>
+#include <memory>
+#include <variant>
+#include <vector>
+
+namespace IG
+{
+
+class AsyncIO;
+class IOFuture;
+
+// receives the number of bytes transferred or a negative errno value
+using AsyncIOCompletionDelegate = DelegateFunc<void (ssize_t result)>;
+
+struct AsyncIORequest
+{
+	enum class Op : uint8_t { Read, Write };
+	enum class State : uint8_t { Free, Queued, Done };
+
+	AsyncIOCompletionDelegate onComplete{};
+	IOFuture *future{}; // future holding this request, if any
+	void *buff{};
+	size_t bytes{};
+	off_t offset{};
+	ssize_t result{};
+	int fd{-1};
+	Op op{};
+	State state{};
+};
+
+// Result of a request without a completion delegate, the destructor waits for the request
+// to finish since it may still be transferring to or from its buffer. If the AsyncIO is
+// destroyed first, it finishes the request and the future keeps only the result.
+class IOFuture
+{
+public:
+	constexpr IOFuture() = default;
+	IOFuture(AsyncIO &asyncIO, AsyncIORequest &req): asyncIO{&asyncIO}, req{&req} { req.future = this; }
+	IOFuture(IOFuture &&o) noexcept;
+	IOFuture &operator=(IOFuture &&o) noexcept;
+	~IOFuture();
+	// runs any finished completions and returns true if this request is done without blocking
+	bool poll();
+	// blocks until the request is done, submitting it first if needed,
+	// returns -EAGAIN if the future holds no request
+	ssize_t get();
+	explicit operator bool() const { return req; }
+
+protected:
+	AsyncIO *asyncIO{};
+	AsyncIORequest *req{};
+	ssize_t result{-EAGAIN}; // set when the AsyncIO is destroyed before this future
+
+	void release();
+	void orphan();
+	friend class AsyncIO;
+};
+
+// Batched asynchronous reads and writes at file offsets, using io_uring when the kernel
+// supports it (Linux only) and otherwise a worker thread. Requests are queued until submit() so a batch
+// needs a single system call. An instance must only be used from one thread.
+class AsyncIO
+{
+public:
+	static constexpr unsigned defaultQueueDepth = 32;
+
+	AsyncIO(unsigned queueDepth = defaultQueueDepth);
+	~AsyncIO();
+	AsyncIO &operator=(AsyncIO &&) = delete;
+	IOFuture queueRead(int fd, void *buff, size_t bytes, off_t offset);
+	IOFuture queueWrite(int fd, const void *buff, size_t bytes, off_t offset);
+	bool queueRead(int fd, void *buff, size_t bytes, off_t offset, AsyncIOCompletionDelegate);
+	bool queueWrite(int fd, const void *buff, size_t bytes, off_t offset, AsyncIOCompletionDelegate);
+	// queue and submit a single request
+	IOFuture readAtPos(int fd, void *buff, size_t bytes, off_t offset);
+	IOFuture writeAtPos(int fd, const void *buff, size_t bytes, off_t offset);
+	int submit();
+	// runs completion delegates of finished requests, if wait is true blocks until at least one
+	// finishes when any are pending, returns the number of requests completed
+	int processCompletions(bool wait = false);
+	// process completions from an event loop instead of polling
+	bool attach(EventLoop loop = {});
+	void detach();
+	size_t pendingRequests() const { return pendingRequests_; }
+	#ifdef __linux__
+	bool isUsingIOUring() const { return std::holds_alternative<IOUringQueue>(queue); }
+	#else
+	bool isUsingIOUring() const { return false; }
+	#endif
+
+protected:
+	#ifdef __linux__
+	std::variant<std::monostate, IOUringQueue, ThreadIOQueue> queue;
+	#else
+	std::variant<std::monostate, ThreadIOQueue> queue;
+	#endif
+	std::unique_ptr<AsyncIORequest[]> requests;
+	std::vector<AsyncIORequest*> freeRequests;
+	std::vector<AsyncIORequest*> completed;
+	CustomEvent completionEvent{"AsyncIO"};
+	unsigned requestCount;
+	size_t pendingRequests_{};
+
+	AsyncIORequest *queueRequest(AsyncIORequest::Op, int fd, void *buff, size_t bytes, off_t offset, AsyncIOCompletionDelegate);
+	AsyncIORequest &allocRequest();
+	void freeRequest(AsyncIORequest &);
+	friend class IOFuture;
+};
+
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+/*  This file is part of Imagine.
+
+	Imagine is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Imagine is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Imagine.  If not, see <http://www.gnu.org/licenses/> */
+
+#include <imagine/util/memory/UniqueFileDescriptor.hh>
+#include <linux/io_uring.h>
+#include <cstdint>
+#include <vector>
+
+namespace IG
+{
+
+struct AsyncIORequest;
+
+// Minimal io_uring submission/completion ring using the raw syscalls
+class IOUringQueue
+{
+public:
+	IOUringQueue(unsigned entries, int eventFd);
+	~IOUringQueue();
+	IOUringQueue &operator=(IOUringQueue &&) = delete;
+	void queue(AsyncIORequest &);
+	int submit();
+	bool hasUnsubmitted() const { return unsubmitted; }
+	void reap(bool wait, std::vector<AsyncIORequest*> &completed);
+	explicit operator bool() const { return ringFd != -1; }
+
+protected:
+	UniqueFileDescriptor ringFd{};
+	void *ringMem{};
+	size_t ringMemSize{};
+	io_uring_sqe *sqes{};
+	size_t sqesSize{};
+	uint32_t *sqTail{};
+	uint32_t *sqArray{};
+	uint32_t sqMask{};
+	uint32_t *cqHead{};
+	uint32_t *cqTail{};
+	io_uring_cqe *cqes{};
+	uint32_t cqMask{};
+	unsigned unsubmitted{};
+
+	void deinit();
+};
+
+}
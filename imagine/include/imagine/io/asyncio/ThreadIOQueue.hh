@@ -0,0 +1,57 @@
+#pragma once
+
+/*  This file is part of Imagine.
+
+	Imagine is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Imagine is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Imagine.  If not, see <http://www.gnu.org/licenses/> */
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace IG
+{
+
+struct AsyncIORequest;
+class CustomEvent;
+
+// Fallback that runs requests on a worker thread with pread()/pwrite()
+class ThreadIOQueue
+{
+public:
+	ThreadIOQueue(CustomEvent &completionEvent);
+	~ThreadIOQueue();
+	ThreadIOQueue &operator=(ThreadIOQueue &&) = delete;
+	void queue(AsyncIORequest &);
+	int submit();
+	bool hasUnsubmitted() const { return unsubmitted.size(); }
+	void reap(bool wait, std::vector<AsyncIORequest*> &completed);
+	explicit operator bool() const { return true; }
+
+protected:
+	std::thread thread;
+	std::mutex mutex;
+	std::condition_variable pendingCondition;
+	std::condition_variable completedCondition;
+	std::vector<AsyncIORequest*> unsubmitted;
+	std::deque<AsyncIORequest*> pending;
+	std::vector<AsyncIORequest*> finished;
+	CustomEvent *completionEventPtr{};
+	bool quit{};
+
+	void run();
+};
+
+}
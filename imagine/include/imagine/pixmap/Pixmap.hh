@@ -41,6 +41,18 @@ uint32_t transformRGB565ToBGRX8888(uint16_t p);
 uint32_t transformRGB888ToRGBX8888(RGBTripleArray p);
 uint32_t transformRGB888ToBGRX8888(RGBTripleArray p);
 
+// Line conversion functions using the fastest SIMD implementation supported by the CPU
+void convertLineRGB565ToRGBX8888(const uint16_t *src, uint32_t *dest, size_t pixels);
+void convertLineRGB565ToBGRX8888(const uint16_t *src, uint32_t *dest, size_t pixels);
+void convertLineRGBX8888ToRGB565(const uint32_t *src, uint16_t *dest, size_t pixels);
+void convertLineBGRX8888ToRGB565(const uint32_t *src, uint16_t *dest, size_t pixels);
+void convertLineRGBA8888ToBGRA8888(const uint32_t *src, uint32_t *dest, size_t pixels);
+void expandIndexedLine(const uint8_t *src, uint16_t *dest, size_t pixels, const uint16_t *palette);
+void expandIndexedLine(const uint8_t *src, uint32_t *dest, size_t pixels, const uint32_t *palette);
+void expandIndexedLine(const uint16_t *src, uint16_t *dest, size_t pixels, const uint16_t *palette);
+void expandIndexedLine(const uint16_t *src, uint32_t *dest, size_t pixels, const uint32_t *palette);
+const char *pixelConvertImplName();
+
 template <class Func>
 concept PixmapTransformFunc =
 		requires (Func &&f, unsigned data){ f(data); } ||
@@ -319,6 +331,44 @@ public:
 		writeTransformed2<Src, Dest>(func, pixmap);
 	}
 
+	// Write an 8 or 16-bit indexed pixmap using a palette of destination pixel values,
+	// the palette must have an entry for every possible index value
+	template <class Dest>
+	void writeIndexed(auto pixmap, const Dest *palette) requires(dataIsMutable)
+	{
+		assumeExpr(format().bytesPerPixel() == sizeof(Dest));
+		switch(pixmap.format().bytesPerPixel())
+		{
+			case 1: return writeLines<uint8_t, Dest>(pixmap,
+				[=](const uint8_t *src, Dest *dest, size_t pixels){ expandIndexedLine(src, dest, pixels, palette); });
+			case 2: return writeLines<uint16_t, Dest>(pixmap,
+				[=](const uint16_t *src, Dest *dest, size_t pixels){ expandIndexedLine(src, dest, pixels, palette); });
+		}
+		bug_unreachable("invalid index bytes per pixel:%d", pixmap.format().bytesPerPixel());
+	}
+
+	template <class Src, class Dest>
+	void writeLines(auto pixmap, auto &&lineFunc) requires(dataIsMutable)
+	{
+		auto srcData = (const Src*)pixmap.data();
+		auto destData = (Dest*)data_;
+		if(w() == pixmap.w() && !isPadded() && !pixmap.isPadded())
+		{
+			lineFunc(srcData, destData, size_t(pixmap.w() * pixmap.h()));
+		}
+		else
+		{
+			auto srcPitchPixels = pixmap.pitchPx();
+			auto destPitchPixels = pitchPx();
+			for(auto h : iotaCount(pixmap.h()))
+			{
+				lineFunc(srcData, destData, size_t(pixmap.w()));
+				srcData += srcPitchPixels;
+				destData += destPitchPixels;
+			}
+		}
+	}
+
 protected:
 	PixData *data_{};
 	int pitchPx_{};
@@ -384,12 +434,12 @@ protected:
 
 	static void convertRGB565ToRGBX8888(auto dest, auto src)
 	{
-		dest.writeTransformed(transformRGB565ToRGBX8888, src);
+		dest.template writeLines<uint16_t, uint32_t>(src, convertLineRGB565ToRGBX8888);
 	}
 
 	static void convertRGB565ToBGRX8888(auto dest, auto src)
 	{
-		dest.writeTransformed(transformRGB565ToBGRX8888, src);
+		dest.template writeLines<uint16_t, uint32_t>(src, convertLineRGB565ToBGRX8888);
 	}
 
 	static void convertRGBX8888ToRGB888(auto dest, auto src)
@@ -414,17 +464,17 @@ protected:
 
 	static void convertRGBX8888ToRGB565(auto dest, auto src)
 	{
-		dest.writeTransformed(transformRGBX8888ToRGB565, src);
+		dest.template writeLines<uint32_t, uint16_t>(src, convertLineRGBX8888ToRGB565);
 	}
 
 	static void convertRGBA8888ToBGRA8888(auto dest, auto src)
 	{
-		dest.writeTransformed(transformRGBA8888ToBGRA8888, src);
+		dest.template writeLines<uint32_t, uint32_t>(src, convertLineRGBA8888ToBGRA8888);
 	}
 
 	static void convertBGRX8888ToRGB565(auto dest, auto src)
 	{
-		dest.template writeTransformed(transformBGRX8888ToRGB565, src);
+		dest.template writeLines<uint32_t, uint16_t>(src, convertLineBGRX8888ToRGB565);
 	}
 };
 
@@ -0,0 +1,85 @@
+#pragma once
+
+/*  This file is part of Imagine.
+
+	Imagine is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Imagine is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Imagine.  If not, see <http://www.gnu.org/licenses/> */
+
+#include <imagine/util/math/int.hh>
+#include <array>
+#include <atomic>
+#include <optional>
+#include <cstddef>
+
+namespace IG
+{
+
+// Fixed capacity lock-free queue for exactly one producer thread and one consumer thread
+template<class T, size_t Capacity>
+class SPSCQueue
+{
+public:
+	static_assert(isPowerOf2(Capacity), "capacity must be a power of 2");
+
+	constexpr SPSCQueue() = default;
+
+	// called from the producer thread, returns false if the queue is full
+	bool push(const T &val)
+	{
+		auto writePos = writeIdx.load(std::memory_order_relaxed);
+		if(writePos - readIdx.load(std::memory_order_acquire) == Capacity)
+			return false;
+		buff[writePos & mask] = val;
+		writeIdx.store(writePos + 1, std::memory_order_release);
+		return true;
+	}
+
+	// called from the consumer thread
+	std::optional<T> pop()
+	{
+		auto readPos = readIdx.load(std::memory_order_relaxed);
+		if(readPos == writeIdx.load(std::memory_order_acquire))
+			return {};
+		T val = buff[readPos & mask];
+		readIdx.store(readPos + 1, std::memory_order_release);
+		return val;
+	}
+
+	// called from the consumer thread, passes each queued value to the function
+	size_t drain(auto &&func)
+	{
+		auto readPos = readIdx.load(std::memory_order_relaxed);
+		const auto writePos = writeIdx.load(std::memory_order_acquire);
+		for(auto i = readPos; i != writePos; i++)
+		{
+			func(buff[i & mask]);
+		}
+		readIdx.store(writePos, std::memory_order_release);
+		return writePos - readPos;
+	}
+
+	bool empty() const
+	{
+		return readIdx.load(std::memory_order_acquire) == writeIdx.load(std::memory_order_acquire);
+	}
+
+	static constexpr size_t capacity() { return Capacity; }
+
+private:
+	static constexpr size_t mask = Capacity - 1;
+	alignas(64) std::atomic_size_t writeIdx{};
+	alignas(64) std::atomic_size_t readIdx{};
+	std::array<T, Capacity> buff{};
+};
+
+}
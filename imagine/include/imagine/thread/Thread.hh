@@ -97,8 +97,18 @@ using ThreadId = uint64_t;
 using CPUMask = uint32_t;
 static constexpr int maxCPUs = 32;
 
+enum class ThreadSchedulingPolicy : uint8_t
+{
+	Normal,
+	FIFO,
+	RoundRobin,
+};
+
 void setThreadCPUAffinityMask(std::span<const ThreadId>, CPUMask mask);
 void setThreadPriority(ThreadId, int nice);
+// Returns false if a real-time policy isn't permitted, in which case the thread's nice level is
+// raised instead. Setting the normal policy also restores the default nice level.
+bool setThreadSchedulingPolicy(ThreadId, ThreadSchedulingPolicy, int realtimePriority);
 void setThisThreadPriority(int nice);
 int thisThreadPriority();
 ThreadId thisThreadId();
@@ -0,0 +1,9 @@
+include $(IMAGINE_PATH)/make/config.mk
+O_RELEASE := 1
+LTO_MODE ?= lto
+targetSuffix := -bench
+-include $(projectPath)/config.mk
+include $(IMAGINE_PATH)/make/linux-x86_64-gcc.mk
+# runs content from the command line without a window or audio device and prints timing results
+CPPFLAGS += -DCONFIG_EMUFRAMEWORK_HEADLESS_BENCHMARK
+include $(projectPath)/build.mk
@@ -16,6 +16,7 @@
 #include <imagine/audio/Manager.hh>
 #include <imagine/audio/defs.hh>
 #include <imagine/base/ApplicationContext.hh>
+#include <imagine/fs/FS.hh>
 #include <imagine/logger/logger.h>
 
 namespace IG::Audio
@@ -54,8 +55,17 @@ static constexpr ApiDesc apiDesc[]
 	#ifdef CONFIG_AUDIO_ALSA
 	{"ALSA", Api::ALSA},
 	#endif
+	#ifdef CONFIG_AUDIO_TIMED
+	{"Null", Api::NULL_SINK},
+	{"WAV File", Api::WAV_FILE},
+	#endif
 };
 
+FS::PathString Manager::wavFilePath() const
+{
+	return FS::pathString(ctx.storagePath(), "output.wav");
+}
+
 std::vector<ApiDesc> Manager::audioAPIs() const
 {
 	return {apiDesc, apiDesc + std::size(apiDesc)};
@@ -13,11 +13,23 @@
 	You should have received a copy of the GNU General Public License
 	along with Imagine.  If not, see <http://www.gnu.org/licenses/> */
 
+#define LOGTAG "AudioFormat"
 #include <imagine/audio/Format.hh>
 #include <imagine/util/utility.h>
 #include <imagine/util/algorithm.h>
 #include <imagine/util/math/math.hh>
+#include <imagine/logger/logger.h>
+#include <algorithm>
+#include <cstddef>
 #include <cmath>
+#include <cstdint>
+#if defined __x86_64__ || defined __i386__
+#define IG_SAMPLE_CONVERT_X86
+#include <immintrin.h>
+#elif defined __ARM_NEON
+#define IG_SAMPLE_CONVERT_NEON
+#include <arm_neon.h>
+#endif
 
 namespace IG::Audio
 {
@@ -33,81 +45,400 @@ static int16_t remapClampToInt16(float x)
 	return remapClamp(x, -1.f, 1.f, std::numeric_limits<int16_t>{});
 }
 
-static float *convertI16SamplesToFloat(float * __restrict__ dest, size_t samples, const int16_t * __restrict__ src, float volume)
+static void convertI16SamplesToFloatScalar(float * __restrict__ dest, const int16_t * __restrict__ src, size_t samples, float volume)
 {
-	return transformN(src, samples, dest, [=](int16_t s){ return (float(s) / 32768.f) * volume; });
+	transformN(src, samples, dest, [=](int16_t s){ return (float(s) / 32768.f) * volume; });
 }
 
-static int16_t *convertFloatSamplesToI16(int16_t * __restrict__ dest, size_t samples, const float * __restrict__ src, float volume)
+static void convertFloatSamplesToI16Scalar(int16_t * __restrict__ dest, const float * __restrict__ src, size_t samples, float volume)
 {
 	if(volume <= 1.f)
-		return transformN(src, samples, dest, [=](float s){ return remapToInt16(s * volume); });
+		transformN(src, samples, dest, [=](float s){ return remapToInt16(s * volume); });
 	else
-		return transformN(src, samples, dest, [=](float s){ return remapClampToInt16(s * volume); });
+		transformN(src, samples, dest, [=](float s){ return remapClampToInt16(s * volume); });
 }
 
-static int16_t *copyI16Samples(int16_t * __restrict__ dest, size_t samples, const int16_t * __restrict__ src, float volume)
+static void scaleI16SamplesScalar(int16_t * __restrict__ dest, const int16_t * __restrict__ src, size_t samples, float volume)
 {
-	if(volume == 1.f)
+	if(volume <= 1.f)
+		transformN(src, samples, dest, [=](int16_t s){ return remapToInt16((float(s) / 32768.f) * volume); });
+	else
+		transformN(src, samples, dest, [=](int16_t s){ return remapClampToInt16((float(s) / 32768.f) * volume); });
+}
+
+template <class T>
+static void expandMonoSamplesScalar(T * __restrict__ dest, const T * __restrict__ src, size_t frames)
+{
+	for(size_t i = 0; i < frames; i++)
 	{
-		return copy_n(src, samples, dest);
+		dest[i * 2] = dest[i * 2 + 1] = src[i];
 	}
-	else
+}
+
+// The vector versions match the scalar ones bit for bit:
+// - (float(s) / 32768.f) * volume equals float(s) * (volume / 32768.f) since scaling by a power of 2 is exact
+// - remap() to int16 is evaluated as -32768 + ((x + 1) * 65535) / 2 in the same order,
+//   with the division by 2 done as an exact multiply by 0.5
+// - truncation toward zero matches the implicit float -> int16 conversion
+// Float to int16 always clamps, which equals remapToInt16() for samples in range.
+
+#if defined IG_SAMPLE_CONVERT_X86
+
+[[gnu::target("sse2")]]
+static __m128i remapClampToInt32SSE2(__m128 x)
+{
+	x = _mm_mul_ps(_mm_add_ps(x, _mm_set1_ps(1.f)), _mm_set1_ps(65535.f));
+	x = _mm_add_ps(_mm_set1_ps(-32768.f), _mm_mul_ps(x, _mm_set1_ps(.5f)));
+	x = _mm_min_ps(_mm_max_ps(x, _mm_set1_ps(-32768.f)), _mm_set1_ps(32767.f));
+	return _mm_cvttps_epi32(x);
+}
+
+[[gnu::target("sse2")]]
+static __m128i floatToI16SSE2(__m128 lo, __m128 hi, __m128 scale)
+{
+	return _mm_packs_epi32(remapClampToInt32SSE2(_mm_mul_ps(lo, scale)), remapClampToInt32SSE2(_mm_mul_ps(hi, scale)));
+}
+
+[[gnu::target("sse2")]]
+static void convertI16SamplesToFloatSSE2(float * __restrict__ dest, const int16_t * __restrict__ src, size_t samples, float volume)
+{
+	const auto scale = _mm_set1_ps(volume / 32768.f);
+	size_t i = 0;
+	for(; i + 8 <= samples; i += 8)
 	{
-		if(volume <= 1.f)
-			return transformN(src, samples, dest, [=](int16_t s){ return remapToInt16((float(s) / 32768.f) * volume); });
-		else
-			return transformN(src, samples, dest, [=](int16_t s){ return remapClampToInt16((float(s) / 32768.f) * volume); });
+		auto v = _mm_loadu_si128((const __m128i*)(src + i));
+		auto lo = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16));
+		auto hi = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(v, v), 16));
+		_mm_storeu_ps(dest + i, _mm_mul_ps(lo, scale));
+		_mm_storeu_ps(dest + i + 4, _mm_mul_ps(hi, scale));
 	}
+	convertI16SamplesToFloatScalar(dest + i, src + i, samples - i, volume);
 }
 
-static float *copyFloatSamples(float * __restrict__ dest, size_t samples, const float * __restrict__ src, float volume)
+[[gnu::target("sse2")]]
+static void convertFloatSamplesToI16SSE2(int16_t * __restrict__ dest, const float * __restrict__ src, size_t samples, float volume)
 {
-	if(volume == 1.f)
+	const auto scale = _mm_set1_ps(volume);
+	size_t i = 0;
+	for(; i + 8 <= samples; i += 8)
 	{
-		return copy_n(src, samples, dest);
+		auto v = floatToI16SSE2(_mm_loadu_ps(src + i), _mm_loadu_ps(src + i + 4), scale);
+		_mm_storeu_si128((__m128i*)(dest + i), v);
 	}
-	else
+	convertFloatSamplesToI16Scalar(dest + i, src + i, samples - i, volume);
+}
+
+[[gnu::target("sse2")]]
+static void scaleI16SamplesSSE2(int16_t * __restrict__ dest, const int16_t * __restrict__ src, size_t samples, float volume)
+{
+	const auto scale = _mm_set1_ps(volume / 32768.f);
+	size_t i = 0;
+	for(; i + 8 <= samples; i += 8)
 	{
-		return transformN(src, samples, dest, [=](float s){ return s * volume; });
+		auto v = _mm_loadu_si128((const __m128i*)(src + i));
+		auto lo = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16));
+		auto hi = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(v, v), 16));
+		_mm_storeu_si128((__m128i*)(dest + i), floatToI16SSE2(lo, hi, scale));
 	}
+	scaleI16SamplesScalar(dest + i, src + i, samples - i, volume);
 }
 
-void *Format::copyFrames(void * __restrict__ dest, const void * __restrict__ src, size_t frames, Format srcFormat, float volume) const
+[[gnu::target("sse2")]]
+static void expandMonoI16SamplesSSE2(int16_t * __restrict__ dest, const int16_t * __restrict__ src, size_t frames)
 {
-	assumeExpr(channels == srcFormat.channels);
-	auto samples = frames * channels;
-	switch(sample.bytes())
+	size_t i = 0;
+	for(; i + 8 <= frames; i += 8)
+	{
+		auto v = _mm_loadu_si128((const __m128i*)(src + i));
+		_mm_storeu_si128((__m128i*)(dest + i * 2), _mm_unpacklo_epi16(v, v));
+		_mm_storeu_si128((__m128i*)(dest + i * 2 + 8), _mm_unpackhi_epi16(v, v));
+	}
+	expandMonoSamplesScalar(dest + i * 2, src + i, frames - i);
+}
+
+[[gnu::target("sse2")]]
+static void expandMonoFloatSamplesSSE2(float * __restrict__ dest, const float * __restrict__ src, size_t frames)
+{
+	size_t i = 0;
+	for(; i + 4 <= frames; i += 4)
+	{
+		auto v = _mm_loadu_ps(src + i);
+		_mm_storeu_ps(dest + i * 2, _mm_unpacklo_ps(v, v));
+		_mm_storeu_ps(dest + i * 2 + 4, _mm_unpackhi_ps(v, v));
+	}
+	expandMonoSamplesScalar(dest + i * 2, src + i, frames - i);
+}
+
+[[gnu::target("avx2")]]
+static __m256i remapClampToInt32AVX2(__m256 x)
+{
+	x = _mm256_mul_ps(_mm256_add_ps(x, _mm256_set1_ps(1.f)), _mm256_set1_ps(65535.f));
+	x = _mm256_add_ps(_mm256_set1_ps(-32768.f), _mm256_mul_ps(x, _mm256_set1_ps(.5f)));
+	x = _mm256_min_ps(_mm256_max_ps(x, _mm256_set1_ps(-32768.f)), _mm256_set1_ps(32767.f));
+	return _mm256_cvttps_epi32(x);
+}
+
+[[gnu::target("avx2")]]
+static __m256i floatToI16AVX2(__m256 lo, __m256 hi, __m256 scale)
+{
+	auto v = _mm256_packs_epi32(remapClampToInt32AVX2(_mm256_mul_ps(lo, scale)), remapClampToInt32AVX2(_mm256_mul_ps(hi, scale)));
+	// packs works within 128-bit lanes, restore the sample order
+	return _mm256_permute4x64_epi64(v, 0b11'01'10'00);
+}
+
+[[gnu::target("avx2")]]
+static void convertI16SamplesToFloatAVX2(float * __restrict__ dest, const int16_t * __restrict__ src, size_t samples, float volume)
+{
+	const auto scale = _mm256_set1_ps(volume / 32768.f);
+	size_t i = 0;
+	for(; i + 16 <= samples; i += 16)
+	{
+		auto lo = _mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i*)(src + i))));
+		auto hi = _mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i*)(src + i + 8))));
+		_mm256_storeu_ps(dest + i, _mm256_mul_ps(lo, scale));
+		_mm256_storeu_ps(dest + i + 8, _mm256_mul_ps(hi, scale));
+	}
+	convertI16SamplesToFloatScalar(dest + i, src + i, samples - i, volume);
+}
+
+[[gnu::target("avx2")]]
+static void convertFloatSamplesToI16AVX2(int16_t * __restrict__ dest, const float * __restrict__ src, size_t samples, float volume)
+{
+	const auto scale = _mm256_set1_ps(volume);
+	size_t i = 0;
+	for(; i + 16 <= samples; i += 16)
+	{
+		auto v = floatToI16AVX2(_mm256_loadu_ps(src + i), _mm256_loadu_ps(src + i + 8), scale);
+		_mm256_storeu_si256((__m256i*)(dest + i), v);
+	}
+	convertFloatSamplesToI16Scalar(dest + i, src + i, samples - i, volume);
+}
+
+[[gnu::target("avx2")]]
+static void scaleI16SamplesAVX2(int16_t * __restrict__ dest, const int16_t * __restrict__ src, size_t samples, float volume)
+{
+	const auto scale = _mm256_set1_ps(volume / 32768.f);
+	size_t i = 0;
+	for(; i + 16 <= samples; i += 16)
+	{
+		auto lo = _mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i*)(src + i))));
+		auto hi = _mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i*)(src + i + 8))));
+		_mm256_storeu_si256((__m256i*)(dest + i), floatToI16AVX2(lo, hi, scale));
+	}
+	scaleI16SamplesScalar(dest + i, src + i, samples - i, volume);
+}
+
+[[gnu::target("avx2")]]
+static void expandMonoI16SamplesAVX2(int16_t * __restrict__ dest, const int16_t * __restrict__ src, size_t frames)
+{
+	size_t i = 0;
+	for(; i + 16 <= frames; i += 16)
+	{
+		// move the 2nd quarter into the upper lane so the in-lane unpacks output samples in order
+		auto v = _mm256_permute4x64_epi64(_mm256_loadu_si256((const __m256i*)(src + i)), 0b11'01'10'00);
+		_mm256_storeu_si256((__m256i*)(dest + i * 2), _mm256_unpacklo_epi16(v, v));
+		_mm256_storeu_si256((__m256i*)(dest + i * 2 + 16), _mm256_unpackhi_epi16(v, v));
+	}
+	expandMonoSamplesScalar(dest + i * 2, src + i, frames - i);
+}
+
+[[gnu::target("avx2")]]
+static void expandMonoFloatSamplesAVX2(float * __restrict__ dest, const float * __restrict__ src, size_t frames)
+{
+	size_t i = 0;
+	for(; i + 8 <= frames; i += 8)
+	{
+		auto v = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(_mm256_loadu_ps(src + i)), 0b11'01'10'00));
+		_mm256_storeu_ps(dest + i * 2, _mm256_unpacklo_ps(v, v));
+		_mm256_storeu_ps(dest + i * 2 + 8, _mm256_unpackhi_ps(v, v));
+	}
+	expandMonoSamplesScalar(dest + i * 2, src + i, frames - i);
+}
+
+#elif defined IG_SAMPLE_CONVERT_NEON
+
+static int16x4_t remapClampToInt16NEON(float32x4_t x)
+{
+	x = vmulq_f32(vaddq_f32(x, vdupq_n_f32(1.f)), vdupq_n_f32(65535.f));
+	x = vaddq_f32(vdupq_n_f32(-32768.f), vmulq_f32(x, vdupq_n_f32(.5f)));
+	x = vminq_f32(vmaxq_f32(x, vdupq_n_f32(-32768.f)), vdupq_n_f32(32767.f));
+	return vqmovn_s32(vcvtq_s32_f32(x));
+}
+
+static void convertI16SamplesToFloatNEON(float * __restrict__ dest, const int16_t * __restrict__ src, size_t samples, float volume)
+{
+	const auto scale = vdupq_n_f32(volume / 32768.f);
+	size_t i = 0;
+	for(; i + 8 <= samples; i += 8)
+	{
+		auto v = vld1q_s16(src + i);
+		vst1q_f32(dest + i, vmulq_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(v))), scale));
+		vst1q_f32(dest + i + 4, vmulq_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(v))), scale));
+	}
+	convertI16SamplesToFloatScalar(dest + i, src + i, samples - i, volume);
+}
+
+static void convertFloatSamplesToI16NEON(int16_t * __restrict__ dest, const float * __restrict__ src, size_t samples, float volume)
+{
+	const auto scale = vdupq_n_f32(volume);
+	size_t i = 0;
+	for(; i + 8 <= samples; i += 8)
+	{
+		auto lo = remapClampToInt16NEON(vmulq_f32(vld1q_f32(src + i), scale));
+		auto hi = remapClampToInt16NEON(vmulq_f32(vld1q_f32(src + i + 4), scale));
+		vst1q_s16(dest + i, vcombine_s16(lo, hi));
+	}
+	convertFloatSamplesToI16Scalar(dest + i, src + i, samples - i, volume);
+}
+
+static void scaleI16SamplesNEON(int16_t * __restrict__ dest, const int16_t * __restrict__ src, size_t samples, float volume)
+{
+	const auto scale = vdupq_n_f32(volume / 32768.f);
+	size_t i = 0;
+	for(; i + 8 <= samples; i += 8)
+	{
+		auto v = vld1q_s16(src + i);
+		auto lo = remapClampToInt16NEON(vmulq_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(v))), scale));
+		auto hi = remapClampToInt16NEON(vmulq_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(v))), scale));
+		vst1q_s16(dest + i, vcombine_s16(lo, hi));
+	}
+	scaleI16SamplesScalar(dest + i, src + i, samples - i, volume);
+}
+
+static void expandMonoI16SamplesNEON(int16_t * __restrict__ dest, const int16_t * __restrict__ src, size_t frames)
+{
+	size_t i = 0;
+	for(; i + 8 <= frames; i += 8)
+	{
+		auto v = vld1q_s16(src + i);
+		vst2q_s16(dest + i * 2, (int16x8x2_t{{v, v}}));
+	}
+	expandMonoSamplesScalar(dest + i * 2, src + i, frames - i);
+}
+
+static void expandMonoFloatSamplesNEON(float * __restrict__ dest, const float * __restrict__ src, size_t frames)
+{
+	size_t i = 0;
+	for(; i + 4 <= frames; i += 4)
+	{
+		auto v = vld1q_f32(src + i);
+		vst2q_f32(dest + i * 2, (float32x4x2_t{{v, v}}));
+	}
+	expandMonoSamplesScalar(dest + i * 2, src + i, frames - i);
+}
+
+#endif
+
+struct SampleConvertFuncs
+{
+	const char *name;
+	void (*i16ToFloat)(float *, const int16_t *, size_t, float);
+	void (*floatToI16)(int16_t *, const float *, size_t, float);
+	void (*scaleI16)(int16_t *, const int16_t *, size_t, float);
+	void (*expandMonoI16)(int16_t *, const int16_t *, size_t);
+	void (*expandMonoFloat)(float *, const float *, size_t);
+};
+
+static SampleConvertFuncs selectSampleConvertFuncs()
+{
+	SampleConvertFuncs funcs
+	{
+		"scalar",
+		convertI16SamplesToFloatScalar,
+		convertFloatSamplesToI16Scalar,
+		scaleI16SamplesScalar,
+		expandMonoSamplesScalar<int16_t>,
+		expandMonoSamplesScalar<float>,
+	};
+	#if defined IG_SAMPLE_CONVERT_X86
+	__builtin_cpu_init();
+	if(__builtin_cpu_supports("avx2"))
+	{
+		funcs =
+		{
+			"AVX2",
+			convertI16SamplesToFloatAVX2,
+			convertFloatSamplesToI16AVX2,
+			scaleI16SamplesAVX2,
+			expandMonoI16SamplesAVX2,
+			expandMonoFloatSamplesAVX2,
+		};
+	}
+	else if(__builtin_cpu_supports("sse2"))
+	{
+		funcs =
+		{
+			"SSE2",
+			convertI16SamplesToFloatSSE2,
+			convertFloatSamplesToI16SSE2,
+			scaleI16SamplesSSE2,
+			expandMonoI16SamplesSSE2,
+			expandMonoFloatSamplesSSE2,
+		};
+	}
+	#elif defined IG_SAMPLE_CONVERT_NEON
+	funcs =
+	{
+		"NEON",
+		convertI16SamplesToFloatNEON,
+		convertFloatSamplesToI16NEON,
+		scaleI16SamplesNEON,
+		expandMonoI16SamplesNEON,
+		expandMonoFloatSamplesNEON,
+	};
+	#endif
+	logMsg("using %s sample conversion", funcs.name);
+	return funcs;
+}
+
+static const SampleConvertFuncs &sampleConvertFuncs()
+{
+	static const SampleConvertFuncs funcs = selectSampleConvertFuncs();
+	return funcs;
+}
+
+static void *copySamples(void * __restrict__ dest, SampleFormat destSample, const void * __restrict__ src, SampleFormat srcSample,
+	size_t samples, float volume)
+{
+	switch(destSample.bytes())
 	{
 		case 2:
 		{
-			if(srcFormat.sample.bytes() == 2)
+			auto destI16 = static_cast<int16_t*>(dest);
+			if(srcSample.bytes() == 2)
 			{
-				return copyI16Samples(static_cast<int16_t*>(dest), samples, static_cast<const int16_t*>(src), volume);
+				if(volume == 1.f)
+					return copy_n(static_cast<const int16_t*>(src), samples, destI16);
+				sampleConvertFuncs().scaleI16(destI16, static_cast<const int16_t*>(src), samples, volume);
 			}
-			else if(srcFormat.sample.isFloat())
+			else if(srcSample.isFloat())
 			{
-				return convertFloatSamplesToI16(static_cast<int16_t*>(dest), samples, static_cast<const float*>(src), volume);
+				sampleConvertFuncs().floatToI16(destI16, static_cast<const float*>(src), samples, volume);
 			}
 			else
 			{
 				bug_unreachable("unimplemented conversion");
 			}
+			return destI16 + samples;
 		}
 		case 4:
 		{
-			if(srcFormat.sample.isFloat())
+			auto destFloat = static_cast<float*>(dest);
+			if(srcSample.isFloat())
 			{
-				return copyFloatSamples(static_cast<float*>(dest), samples, static_cast<const float*>(src), volume);
+				if(volume == 1.f)
+					return copy_n(static_cast<const float*>(src), samples, destFloat);
+				return transformN(static_cast<const float*>(src), samples, destFloat, [=](float s){ return s * volume; });
 			}
-			else if(srcFormat.sample.bytes() == 2)
+			else if(srcSample.bytes() == 2)
 			{
-				return convertI16SamplesToFloat(static_cast<float*>(dest), samples, static_cast<const int16_t*>(src), volume);
+				sampleConvertFuncs().i16ToFloat(destFloat, static_cast<const int16_t*>(src), samples, volume);
 			}
 			else
 			{
 				bug_unreachable("unimplemented conversion");
 			}
+			return destFloat + samples;
 		}
 		default:
 		{
@@ -116,4 +447,37 @@ void *Format::copyFrames(void * __restrict__ dest, const void * __restrict__ src
 	}
 }
 
+static void *copyMonoFramesToStereo(void * __restrict__ dest, SampleFormat destSample, const void * __restrict__ src, SampleFormat srcSample,
+	size_t frames, float volume)
+{
+	// convert a block at a time into a buffer small enough to stay in L1, then duplicate each sample
+	constexpr size_t blockFrames = 256;
+	alignas(32) std::byte buff[blockFrames * sizeof(float)];
+	auto destBytes = static_cast<char*>(dest);
+	auto srcBytes = static_cast<const char*>(src);
+	while(frames)
+	{
+		auto blockSize = std::min(frames, blockFrames);
+		copySamples(buff, destSample, srcBytes, srcSample, blockSize, volume);
+		if(destSample.bytes() == 2)
+			sampleConvertFuncs().expandMonoI16(reinterpret_cast<int16_t*>(destBytes), reinterpret_cast<const int16_t*>(buff), blockSize);
+		else
+			sampleConvertFuncs().expandMonoFloat(reinterpret_cast<float*>(destBytes), reinterpret_cast<const float*>(buff), blockSize);
+		destBytes += blockSize * destSample.bytes() * 2;
+		srcBytes += blockSize * srcSample.bytes();
+		frames -= blockSize;
+	}
+	return destBytes;
+}
+
+void *Format::copyFrames(void * __restrict__ dest, const void * __restrict__ src, size_t frames, Format srcFormat, float volume) const
+{
+	assumeExpr(channels == srcFormat.channels || (channels == 2 && srcFormat.channels == 1));
+	if(channels != srcFormat.channels)
+		return copyMonoFramesToStereo(dest, sample, src, srcFormat.sample, frames, volume);
+	return copySamples(dest, sample, src, srcFormat.sample, frames * channels, volume);
+}
+
+const char *sampleConvertImplName() { return sampleConvertFuncs().name; }
+
 }
@@ -35,6 +35,10 @@ void OutputStream::setApi(const Manager &mgr, Api api)
 		#ifdef CONFIG_AUDIO_ALSA
 		case Api::ALSA: emplace<ALSAOutputStream>(); return;
 		#endif
+		#ifdef CONFIG_AUDIO_TIMED
+		case Api::NULL_SINK: emplace<TimedOutputStream>(); return;
+		case Api::WAV_FILE: emplace<TimedOutputStream>(mgr.wavFilePath()); return;
+		#endif
 		#ifdef __ANDROID__
 		case Api::OPENSL_ES: emplace<OpenSLESOutputStream>(mgr); return;
 		case Api::AAUDIO: emplace<AAudioOutputStream>(mgr); return;
@@ -54,6 +58,16 @@ void OutputStream::close() { visit([&](auto &v){ v.close(); }, *this); }
 void OutputStream::flush() { visit([&](auto &v){ v.flush(); }, *this); }
 bool OutputStream::isOpen() { return visit([&](auto &v){ return v.isOpen(); }, *this); }
 bool OutputStream::isPlaying() { return visit([&](auto &v){ return v.isPlaying(); }, *this); }
+Microseconds OutputStream::latency() const
+{
+	return visit([&](auto &v) -> Microseconds
+	{
+		if constexpr(requires {v.latency();})
+			return v.latency();
+		else
+			return {};
+	}, *this);
+}
 void OutputStream::reset() { emplace<NullOutputStream>(); }
 
 OutputStreamConfig Manager::makeNativeOutputStreamConfig() const
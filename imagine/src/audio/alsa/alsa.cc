@@ -24,6 +24,7 @@
 #include <cstdlib>
 #include <cstring>
 #include <memory>
+#include <algorithm>
 
 namespace IG::Audio
 {
@@ -173,6 +174,8 @@ IG::ErrorCode ALSAOutputStream::open(OutputStreamConfig config)
 					continue;
 				}
 				//logMsg("state:%d", snd_pcm_state(pcmHnd));
+				if(snd_pcm_sframes_t delay; snd_pcm_delay(pcmHnd, &delay) == 0)
+					delayFrames.store(std::max(delay, 0l), std::memory_order_relaxed);
 				if(useMmap)
 				{
 					snd_pcm_avail_update(pcmHnd);
@@ -272,6 +275,7 @@ void ALSAOutputStream::close()
 	snd_pcm_close(pcmHnd);
 	eventThread.join();
 	pcmHnd = nullptr;
+	delayFrames = 0;
 }
 
 void ALSAOutputStream::flush()
@@ -295,6 +299,14 @@ bool ALSAOutputStream::isPlaying()
 	return isOpen() && snd_pcm_state(pcmHnd) == SND_PCM_STATE_RUNNING;
 }
 
+Microseconds ALSAOutputStream::latency() const
+{
+	auto frames = delayFrames.load(std::memory_order_relaxed);
+	if(!frames)
+		return {};
+	return duration_cast<Microseconds>(pcmFormat.framesToTime(frames));
+}
+
 ALSAOutputStream::operator bool() const
 {
 	return true;
@@ -177,6 +177,11 @@ IG::ErrorCode PAOutputStream::open(OutputStreamConfig config)
 			{
 				logWarn("error writing %d bytes", (int)bytes);
 			}
+			// interpolated from the last timing update so this doesn't block
+			pa_usec_t latency;
+			int negative;
+			if(pa_stream_get_latency(stream, &latency, &negative) == 0)
+				thisPtr->latencyUSecs.store(negative ? 0 : latency, std::memory_order_relaxed);
 		}, this);
 	const auto wantedLatency = config.wantedLatencyHint.count() ? config.wantedLatencyHint : IG::Microseconds{10000};
 	pa_buffer_attr bufferAttr{};
@@ -185,7 +190,7 @@ IG::ErrorCode PAOutputStream::open(OutputStreamConfig config)
 	bufferAttr.prebuf = -1;
 	bufferAttr.minreq = -1;
 	if(pa_stream_connect_playback(stream, nullptr, &bufferAttr,
-		pa_stream_flags_t(PA_STREAM_ADJUST_LATENCY /*| PA_STREAM_AUTO_TIMING_UPDATE | PA_STREAM_INTERPOLATE_TIMING*/),
+		pa_stream_flags_t(PA_STREAM_ADJUST_LATENCY | PA_STREAM_AUTO_TIMING_UPDATE | PA_STREAM_INTERPOLATE_TIMING),
 		nullptr, nullptr) < 0)
 	{
 		logErr("error connecting playback stream");
@@ -253,6 +258,7 @@ void PAOutputStream::close()
 	iterateMainLoop();
 	isCorked = true;
 	stream = {};
+	latencyUSecs = 0;
 }
 
 void PAOutputStream::flush()
@@ -2,6 +2,7 @@ ifeq ($(ENV), linux)
  ifneq ($(SUBENV), pandora)
   include $(imagineSrcDir)/audio/pulseaudio/build.mk
   include $(imagineSrcDir)/audio/alsa/build.mk
+  include $(imagineSrcDir)/audio/timed/build.mk
  else
   include $(imagineSrcDir)/audio/alsa/build.mk
  endif
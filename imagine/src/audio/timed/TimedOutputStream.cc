@@ -0,0 +1,200 @@
+/*  This file is part of Imagine.
+
+	Imagine is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Imagine is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Imagine.  If not, see <http://www.gnu.org/licenses/> */
+
+#define LOGTAG "TimedAudio"
+#include <imagine/audio/timed/TimedOutputStream.hh>
+#include <imagine/audio/OutputStream.hh>
+#include <imagine/logger/logger.h>
+#include <imagine/util/ranges.hh>
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <memory>
+#include <system_error>
+
+namespace IG::Audio
+{
+
+constexpr size_t wavHeaderSize = 44;
+
+TimedOutputStream::TimedOutputStream(CStringView wavPath):
+	wavPath{wavPath} {}
+
+TimedOutputStream::~TimedOutputStream()
+{
+	close();
+}
+
+IG::ErrorCode TimedOutputStream::open(OutputStreamConfig config)
+{
+	if(isOpen())
+	{
+		logMsg("already open");
+		return {};
+	}
+	pcmFormat = config.format;
+	onSamplesNeeded = config.onSamplesNeeded;
+	auto wantedLatency = config.wantedLatencyHint.count() ? config.wantedLatencyHint : Microseconds{10000};
+	periodFrames = std::max(size_t(pcmFormat.timeToFrames(wantedLatency)), size_t(1));
+	if(wavPath.size())
+	{
+		try
+		{
+			wavFile = {wavPath, OpenFlagsMask::New};
+		}
+		catch(std::system_error &err)
+		{
+			logErr("error opening WAV file %s:%s", wavPath.data(), err.what());
+			return {err.code().value()};
+		}
+		wavDataBytes = 0;
+		writeWavHeader();
+	}
+	logMsg("opened stream: %iHz, %i channels, %zu frame period%s%s", pcmFormat.rate, pcmFormat.channels, periodFrames,
+		wavFile ? ", writing to " : "", wavFile ? wavPath.data() : "");
+	quitFlag = false;
+	lateWakeups = 0;
+	thread = std::thread{[this](){ run(); }};
+	if(config.startPlaying)
+		play();
+	return {};
+}
+
+void TimedOutputStream::run()
+{
+	auto buff = std::make_unique<char[]>(pcmFormat.framesToBytes(periodFrames));
+	while(true)
+	{
+		playing.wait(false, std::memory_order_acquire);
+		if(quitFlag.load(std::memory_order_relaxed))
+			return;
+		// schedule from the total frames consumed since starting so the period rounding doesn't accumulate drift
+		auto startTime = SteadyClock::now();
+		size_t framesConsumed = 0;
+		while(playing.load(std::memory_order_relaxed) && !quitFlag.load(std::memory_order_relaxed))
+		{
+			onSamplesNeeded(buff.get(), periodFrames);
+			if(wavFile)
+			{
+				auto bytes = pcmFormat.framesToBytes(periodFrames);
+				if(wavFile.write(buff.get(), bytes, wavHeaderSize + wavDataBytes) == ssize_t(bytes))
+					wavDataBytes += bytes;
+			}
+			framesConsumed += periodFrames;
+			auto wakeTime = startTime + duration_cast<SteadyClockTime>(pcmFormat.framesToTime(framesConsumed));
+			auto now = SteadyClock::now();
+			if(now - wakeTime > duration_cast<SteadyClockTime>(pcmFormat.framesToTime(periodFrames)))
+			{
+				// a real device would underrun here, restart the timeline instead of bursting to catch up
+				lateWakeups++;
+				startTime = now;
+				framesConsumed = 0;
+				continue;
+			}
+			std::this_thread::sleep_until(wakeTime);
+		}
+	}
+}
+
+void TimedOutputStream::play()
+{
+	if(!isOpen()) [[unlikely]]
+		return;
+	playing.store(true, std::memory_order_release);
+	playing.notify_one();
+}
+
+void TimedOutputStream::pause()
+{
+	if(!isOpen()) [[unlikely]]
+		return;
+	logMsg("pausing playback");
+	playing.store(false, std::memory_order_relaxed);
+}
+
+void TimedOutputStream::close()
+{
+	if(!isOpen()) [[unlikely]]
+		return;
+	logDMsg("closing stream");
+	quitFlag.store(true, std::memory_order_relaxed);
+	playing.store(true, std::memory_order_release);
+	playing.notify_one();
+	thread.join();
+	playing = false;
+	if(lateWakeups)
+		logWarn("thread woke up late %d time(s)", lateWakeups);
+	if(wavFile)
+	{
+		writeWavHeader();
+		logMsg("wrote %zu bytes of samples to %s", wavDataBytes, wavPath.data());
+		wavFile = {};
+	}
+}
+
+void TimedOutputStream::flush() {}
+
+bool TimedOutputStream::isOpen()
+{
+	return thread.joinable();
+}
+
+bool TimedOutputStream::isPlaying()
+{
+	return isOpen() && playing.load(std::memory_order_relaxed);
+}
+
+Microseconds TimedOutputStream::latency() const
+{
+	// samples are requested one period ahead of when they would be heard
+	if(!periodFrames)
+		return {};
+	return duration_cast<Microseconds>(pcmFormat.framesToTime(periodFrames));
+}
+
+TimedOutputStream::operator bool() const
+{
+	return true;
+}
+
+static void writeLE(uint8_t *dest, uint32_t val, int bytes)
+{
+	for(auto i : iotaCount(bytes))
+	{
+		dest[i] = val >> (i * 8);
+	}
+}
+
+// rewritten on close once the final data size is known
+void TimedOutputStream::writeWavHeader()
+{
+	std::array<uint8_t, wavHeaderSize> header{};
+	auto dataBytes = uint32_t(std::min(wavDataBytes, size_t(std::numeric_limits<uint32_t>::max() - 36)));
+	std::copy_n("RIFF", 4, &header[0]);
+	writeLE(&header[4], 36 + dataBytes, 4);
+	std::copy_n("WAVEfmt ", 8, &header[8]);
+	writeLE(&header[16], 16, 4);
+	writeLE(&header[20], pcmFormat.sample.isFloat() ? 3 : 1, 2); // IEEE float or integer PCM
+	writeLE(&header[22], pcmFormat.channels, 2);
+	writeLE(&header[24], pcmFormat.rate, 4);
+	writeLE(&header[28], pcmFormat.framesToBytes(pcmFormat.rate), 4);
+	writeLE(&header[32], pcmFormat.bytesPerFrame(), 2);
+	writeLE(&header[34], pcmFormat.sample.bits(), 2);
+	std::copy_n("data", 4, &header[36]);
+	writeLE(&header[40], dataBytes, 4);
+	wavFile.write(header.data(), header.size(), 0);
+}
+
+}
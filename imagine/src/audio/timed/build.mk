@@ -0,0 +1,8 @@
+ifndef inc_audio_timed
+inc_audio_timed := 1
+
+configDefs += CONFIG_AUDIO_TIMED
+
+SRC += audio/OutputStream.cc audio/timed/TimedOutputStream.cc
+
+endif
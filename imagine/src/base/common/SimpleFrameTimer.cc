@@ -18,16 +18,24 @@
 #include <imagine/base/Screen.hh>
 #include <imagine/time/Time.hh>
 #include <imagine/logger/logger.h>
+#include <algorithm>
+#include <cmath>
+#include <thread>
 
 namespace IG
 {
 
+// re-arm the timer when its whole nanosecond interval drifts this far from the exact frame grid
+constexpr Nanoseconds maxTimerDrift{Microseconds{20}};
+constexpr FloatSeconds statsWindow{10.};
+
 SimpleFrameTimer::SimpleFrameTimer(Screen &screen, EventLoop loop):
 	timer
 	{
 		"SimpleFrameTimer",
 		[this, &screen]()
 		{
+			auto timestamp = waitForNextSlot();
 			if(!requested)
 			{
 				if(keepTimer)
@@ -42,7 +50,7 @@ SimpleFrameTimer::SimpleFrameTimer(Screen &screen, EventLoop loop):
 				}
 			}
 			requested = false;
-			if(screen.frameUpdate(SteadyClock::now()))
+			if(screen.frameUpdate(timestamp))
 				scheduleVSync();
 			return true;
 		}
@@ -64,8 +72,7 @@ void SimpleFrameTimer::scheduleVSync()
 	{
 		return;
 	}
-	assert(interval.count());
-	timer.runIn(IG::Nanoseconds(1), interval, eventLoop);
+	start();
 }
 
 void SimpleFrameTimer::cancel()
@@ -76,12 +83,87 @@ void SimpleFrameTimer::cancel()
 
 void SimpleFrameTimer::setFrameRate(FrameRate rate)
 {
-	interval = fromHz<Nanoseconds>(rate);
-	logMsg("set frame rate:%.2f (timer interval:%ldns)", rate, long(interval.count()));
+	period = PreciseNanoseconds{1e9 / rate};
+	interval = round<Nanoseconds>(period);
+	logMsg("set frame rate:%.4f (timer interval:%ldns)", rate, long(interval.count()));
+	if(timer.isArmed())
+	{
+		start();
+	}
+}
+
+void SimpleFrameTimer::setWakeupMargin(Nanoseconds margin)
+{
+	wakeupMargin = margin;
 	if(timer.isArmed())
 	{
-		timer.runIn(Nanoseconds{1}, interval, eventLoop);
+		start();
+	}
+}
+
+void SimpleFrameTimer::start()
+{
+	assert(interval.count());
+	// the first tick runs immediately and its deadline is one margin later
+	gridStart = SteadyClock::now() + margin();
+	lastSlot = -1;
+	armTimer(0);
+}
+
+void SimpleFrameTimer::armTimer(int64_t slot)
+{
+	timerStartSlot = slot;
+	timer.runAt(slotTime(slot) - margin(), interval, eventLoop);
+}
+
+Nanoseconds SimpleFrameTimer::margin() const
+{
+	return std::min(wakeupMargin, round<Nanoseconds>(period / 4));
+}
+
+SteadyClockTimePoint SimpleFrameTimer::slotTime(int64_t slot) const
+{
+	return gridStart + round<Nanoseconds>(period * slot);
+}
+
+SteadyClockTimePoint SimpleFrameTimer::waitForNextSlot()
+{
+	auto now = SteadyClock::now();
+	// the nearest grid deadline to this tick, normally one margin away
+	auto slot = std::max(lastSlot + 1, int64_t(std::round((now + margin() - gridStart) / period)));
+	auto missedSlots = lastSlot >= 0 ? slot - lastSlot - 1 : 0;
+	lastSlot = slot;
+	if(std::abs(PreciseNanoseconds{interval - period}.count() * (slot - timerStartSlot)) > maxTimerDrift.count())
+	{
+		armTimer(slot + 1);
+	}
+	if(!requested)
+		return now;
+	auto deadline = slotTime(slot);
+	while(now < deadline)
+	{
+		std::this_thread::yield();
+		now = SteadyClock::now();
 	}
+	updateStats(now - deadline, missedSlots);
+	return now;
+}
+
+void SimpleFrameTimer::updateStats(Nanoseconds error, int64_t missedSlots)
+{
+	statsErrorSum += error;
+	stats.maxError = std::max(stats.maxError, error);
+	stats.missedFrames += missedSlots;
+	statsFrames++;
+	if(period * statsFrames < statsWindow)
+		return;
+	stats.averageError = statsErrorSum / statsFrames;
+	lastStats = stats;
+	logMsg("wakeup error avg:%lldns max:%lldns, missed frames:%d",
+		(long long)stats.averageError.count(), (long long)stats.maxError.count(), stats.missedFrames);
+	stats = {};
+	statsErrorSum = {};
+	statsFrames = 0;
 }
 
 }
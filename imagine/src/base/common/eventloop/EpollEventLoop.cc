@@ -0,0 +1,254 @@
+/*  This file is part of Imagine.
+
+	Imagine is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Imagine is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Imagine.  If not, see <http://www.gnu.org/licenses/> */
+
+#define LOGTAG "EventLoop"
+#include <imagine/base/EventLoop.hh>
+#include <imagine/thread/Thread.hh>
+#include <imagine/logger/logger.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#include <optional>
+
+namespace IG
+{
+
+static thread_local std::optional<EpollContext> threadContext;
+
+static void removeSource(EpollFDEventSourceInfo &info)
+{
+	auto &ctx = *info.ctx;
+	if(epoll_ctl(ctx.epollFd, EPOLL_CTL_DEL, info.fd, nullptr) == -1 && errno != EBADF)
+	{
+		logErr("error removing fd:%d from epoll:%d (%s)", info.fd, (int)ctx.epollFd, strerror(errno));
+	}
+	if(info.prepare)
+		std::erase(ctx.preparingSources, &info);
+	// drop any events still queued for this source in the current iteration
+	for(int i = ctx.nextEvent; i < ctx.pendingEvents; i++)
+	{
+		if(ctx.events[i].data.ptr == &info)
+			ctx.events[i].data.ptr = nullptr;
+	}
+	info.ctx = {};
+}
+
+static void dispatchSource(EpollFDEventSourceInfo &info, uint32_t events)
+{
+	if(!info.callback(info.fd, events) && info.ctx)
+	{
+		removeSource(info);
+	}
+}
+
+EpollFDEventSource::EpollFDEventSource(const char *debugLabel, MaybeUniqueFileDescriptor fd):
+	debugLabel{debugLabel ? debugLabel : "unnamed"},
+	info{std::make_unique<EpollFDEventSourceInfo>()},
+	fd_{std::move(fd)}
+{}
+
+EpollFDEventSource::EpollFDEventSource(EpollFDEventSource &&o) noexcept
+{
+	*this = std::move(o);
+}
+
+EpollFDEventSource &EpollFDEventSource::operator=(EpollFDEventSource &&o) noexcept
+{
+	deinit();
+	info = std::move(o.info);
+	fd_ = std::move(o.fd_);
+	debugLabel = o.debugLabel;
+	return *this;
+}
+
+EpollFDEventSource::~EpollFDEventSource()
+{
+	deinit();
+}
+
+bool FDEventSource::attach(EventLoop loop, PollEventDelegate callback, PollPrepareDelegate prepare, uint32_t events)
+{
+	assumeExpr(info);
+	detach();
+	if(!loop)
+		loop = EventLoop::forThread();
+	if(!loop)
+	{
+		logErr("no event loop in thread to attach fd:%d (%s)", (int)fd_, label());
+		return false;
+	}
+	info->callback = callback;
+	info->prepare = prepare;
+	info->fd = fd_;
+	epoll_event ev{.events = events, .data{.ptr = info.get()}};
+	if(epoll_ctl(loop.nativeObject(), EPOLL_CTL_ADD, fd_, &ev) == -1)
+	{
+		logErr("error adding fd:%d to epoll:%d (%s)", (int)fd_, loop.nativeObject(), label());
+		return false;
+	}
+	info->ctx = loop.context();
+	if(prepare)
+		info->ctx->preparingSources.emplace_back(info.get());
+	logMsg("added fd:%d to epoll:%d (%s)", (int)fd_, loop.nativeObject(), label());
+	return true;
+}
+
+bool FDEventSource::attach(EventLoop loop, PollEventDelegate callback, uint32_t events)
+{
+	return attach(loop, callback, {}, events);
+}
+
+void FDEventSource::detach()
+{
+	if(!info || !info->ctx)
+		return;
+	logMsg("removing fd:%d from epoll:%d (%s)", (int)fd_, (int)info->ctx->epollFd, label());
+	removeSource(*info);
+}
+
+void FDEventSource::setEvents(uint32_t events)
+{
+	if(!hasEventLoop())
+	{
+		logErr("trying to set events while not attached to event loop");
+		return;
+	}
+	epoll_event ev{.events = events, .data{.ptr = info.get()}};
+	if(epoll_ctl(info->ctx->epollFd, EPOLL_CTL_MOD, fd_, &ev) == -1)
+	{
+		logErr("error modifying events for fd:%d (%s)", (int)fd_, label());
+	}
+}
+
+void FDEventSource::dispatchEvents(uint32_t events)
+{
+	dispatchSource(*info, events);
+}
+
+void FDEventSource::setCallback(PollEventDelegate callback)
+{
+	if(!hasEventLoop())
+	{
+		logErr("trying to set callback while not attached to event loop");
+		return;
+	}
+	info->callback = callback;
+}
+
+bool FDEventSource::hasEventLoop() const
+{
+	return info && info->ctx;
+}
+
+int FDEventSource::fd() const
+{
+	return fd_;
+}
+
+void EpollFDEventSource::deinit()
+{
+	static_cast<FDEventSource*>(this)->detach();
+}
+
+const char *EpollFDEventSource::label() const
+{
+	return debugLabel;
+}
+
+EventLoop EventLoop::forThread()
+{
+	return {threadContext ? &*threadContext : nullptr};
+}
+
+EventLoop EventLoop::makeForThread()
+{
+	if(threadContext)
+		return {&*threadContext};
+	UniqueFileDescriptor epollFd{epoll_create1(EPOLL_CLOEXEC)};
+	UniqueFileDescriptor wakeFd{eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK)};
+	if(epollFd == -1 || wakeFd == -1)
+	{
+		logErr("error creating epoll context (%s)", strerror(errno));
+		return {};
+	}
+	auto &ctx = threadContext.emplace();
+	ctx.epollFd = std::move(epollFd);
+	ctx.wakeFd = std::move(wakeFd);
+	// the context pointer marks events from the wake fd
+	epoll_event ev{.events = EPOLLIN, .data{.ptr = &ctx}};
+	epoll_ctl(ctx.epollFd, EPOLL_CTL_ADD, ctx.wakeFd, &ev);
+	if(Config::DEBUG_BUILD)
+	{
+		logMsg("made epoll:%d for thread:%d", (int)ctx.epollFd, IG::thisThreadId());
+	}
+	return {&ctx};
+}
+
+void EventLoop::run()
+{
+	int timeout = -1;
+	auto &preparing = ctx->preparingSources;
+	for(size_t i = 0; i < preparing.size();)
+	{
+		auto infoPtr = preparing[i];
+		if(infoPtr->prepare())
+		{
+			dispatchSource(*infoPtr, POLLEV_IN);
+			timeout = 0;
+		}
+		// a callback removing this or an earlier source shifts the next one down into this slot
+		if(i < preparing.size() && preparing[i] == infoPtr)
+			i++;
+	}
+	int eventCount = epoll_wait(ctx->epollFd, ctx->events.data(), ctx->events.size(), timeout);
+	if(eventCount == -1)
+	{
+		if(errno != EINTR)
+			logErr("error in epoll_wait (%s)", strerror(errno));
+		return;
+	}
+	ctx->pendingEvents = eventCount;
+	for(ctx->nextEvent = 0; ctx->nextEvent < ctx->pendingEvents;)
+	{
+		auto &ev = ctx->events[ctx->nextEvent++];
+		if(!ev.data.ptr) // source removed by an earlier callback
+			continue;
+		if(ev.data.ptr == ctx)
+		{
+			eventfd_t counter;
+			[[maybe_unused]] auto ret = read(ctx->wakeFd, &counter, sizeof(counter));
+			continue;
+		}
+		dispatchSource(*static_cast<EpollFDEventSourceInfo*>(ev.data.ptr), ev.events);
+	}
+	ctx->pendingEvents = ctx->nextEvent = 0;
+}
+
+void EventLoop::stop()
+{
+	eventfd_t counter = 1;
+	if(write(ctx->wakeFd, &counter, sizeof(counter)) == -1)
+	{
+		logErr("error writing wake fd:%d", (int)ctx->wakeFd);
+	}
+}
+
+EventLoop::operator bool() const
+{
+	return ctx;
+}
+
+}
@@ -19,6 +19,7 @@
 #include <imagine/fs/FS.hh>
 #include <imagine/util/format.hh>
 #include <imagine/logger/logger.h>
+#include <glib.h>
 #include <sys/stat.h>
 
 namespace IG
@@ -24,10 +24,29 @@ ifeq ($(linuxWinSystem), x11)
  include $(imagineSrcDir)/base/x11/build.mk
 endif
 
-SRC += base/common/eventloop/GlibEventLoop.cc
-include $(IMAGINE_PATH)/make/package/glib.mk
+# glib: GMainContext event loop, epoll: native epoll event loop
+linuxEventLoop ?= glib
 
 ifneq ($(SUBENV), pandora)
+ linuxDBus ?= 1
+endif
+
+ifeq ($(linuxEventLoop), epoll)
+ # D-Bus & the PulseAudio GLib main loop are dispatched from the GMainContext
+ ifeq ($(linuxDBus), 1)
+  $(error linuxEventLoop=epoll doesn't support D-Bus, build with linuxDBus=0)
+ endif
+ ifeq ($(pulseAudioMainLoop), glib)
+  $(error linuxEventLoop=epoll doesn't support pulseAudioMainLoop=glib)
+ endif
+ configDefs += CONFIG_BASE_EPOLL
+ SRC += base/common/eventloop/EpollEventLoop.cc
+else
+ SRC += base/common/eventloop/GlibEventLoop.cc
+endif
+include $(IMAGINE_PATH)/make/package/glib.mk
+
+ifeq ($(linuxDBus), 1)
  configDefs += CONFIG_BASE_DBUS
  SRC += base/linux/dbus.cc
  include $(IMAGINE_PATH)/make/package/gio.mk
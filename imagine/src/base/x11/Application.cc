@@ -29,6 +29,7 @@ static constexpr char ASCII_CR = 0xD;
 namespace IG
 {
 
+#ifndef CONFIG_BASE_EPOLL
 struct XGlibSource : public GSource
 {
 	::Display *xDisplay{};
@@ -68,6 +69,7 @@ static GSourceFuncs x11SourceFuncs
 	.closure_callback{},
 	.closure_marshal{},
 };
+#endif
 
 XApplication::XApplication(ApplicationInitParams initParams):
 	LinuxApplication{initParams},
@@ -80,6 +82,8 @@ XApplication::~XApplication()
 {
 	deinitWindows();
 	deinitInputSystem();
+	if(!dpy)
+		return;
 	logMsg("closing X display");
 	XCloseDisplay(dpy);
 }
@@ -317,10 +321,21 @@ FDEventSource XApplication::makeXDisplayConnection(EventLoop loop)
 	initXScreens(appCtx, xDisplay);
 	initInputSystem();
 	FDEventSource x11Src{"XServer", ConnectionNumber(xDisplay)};
+	#ifdef CONFIG_BASE_EPOLL
+	// XPending() also flushes queued requests before the loop blocks
+	x11Src.attach(loop,
+		[this, xDisplay](int, int)
+		{
+			runX11Events(xDisplay);
+			return true;
+		},
+		[xDisplay](){ return (bool)XPending(xDisplay); });
+	#else
 	auto source = (XGlibSource*)g_source_new(&x11SourceFuncs, sizeof(XGlibSource));
 	source->xDisplay = xDisplay;
 	source->appPtr = this;
 	x11Src.attach(loop, source);
+	#endif
 	return x11Src;
 }
 
@@ -128,6 +128,9 @@ bool PixmapWriter::writeToFile(PixmapView pix, const char *path) const
 	AndroidBitmap_unlockPixels(env, bitmap);
 	auto pathJStr = env->NewStringUTF(path);
 	auto writeOK = jWritePNG(env, baseActivity, bitmap, pathJStr);
+	// release local refs since this may run many times on a native thread that never returns to Java
+	env->DeleteLocalRef(pathJStr);
+	env->DeleteLocalRef(bitmap);
 	if(!writeOK)
 	{
 		logErr("error writing PNG");
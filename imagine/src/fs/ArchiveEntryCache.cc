@@ -0,0 +1,143 @@
+/*  This file is part of Imagine.
+
+	Imagine is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Imagine is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Imagine.  If not, see <http://www.gnu.org/licenses/> */
+
+#define LOGTAG "ArchiveEntryCache"
+#include <imagine/fs/ArchiveEntryCache.hh>
+#include <imagine/io/PosixIO.hh>
+#include <imagine/logger/logger.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <vector>
+#ifdef __linux__
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace IG::FS
+{
+
+struct CachedArchiveEntry
+{
+	std::string archivePath;
+	std::string entryName;
+	int64_t archiveWriteTime{};
+	uint64_t archiveSize{};
+	PosixIO file;
+	size_t size{};
+
+	bool matches(const ArchiveEntryCacheKey &key) const
+	{
+		return archivePath == key.archivePath && entryName == key.entryName &&
+			archiveWriteTime == key.archiveWriteTime && archiveSize == key.archiveSize;
+	}
+};
+
+static std::mutex cacheMutex;
+static std::vector<CachedArchiveEntry> cache; // most recently used at the back
+static size_t cacheBytes{};
+
+static UniqueFileDescriptor makeMemoryFile(size_t size)
+{
+	#ifdef __linux__
+	UniqueFileDescriptor fd{int(syscall(__NR_memfd_create, "ArchiveEntry", MFD_CLOEXEC))};
+	if(fd == -1)
+	{
+		logErr("error creating memfd:%s", strerror(errno));
+		return {};
+	}
+	// reserve the pages up front so running out of memory fails here instead of with SIGBUS while writing
+	if(fallocate(fd, 0, 0, size) == -1)
+	{
+		logErr("error allocating %zu bytes for memfd:%s", size, strerror(errno));
+		return {};
+	}
+	return fd;
+	#else
+	return {};
+	#endif
+}
+
+static void evictEntries(size_t budget)
+{
+	while(cacheBytes > budget && cache.size())
+	{
+		auto &e = cache.front();
+		logMsg("evicting %s from %s (%zu bytes)", e.entryName.c_str(), e.archivePath.c_str(), e.size);
+		cacheBytes -= e.size;
+		cache.erase(cache.begin());
+	}
+}
+
+static MapIO mapEntry(CachedArchiveEntry &e)
+{
+	auto buff = e.file.mapRange(0, e.size, {});
+	if(!buff)
+		return {};
+	return MapIO{std::move(buff)};
+}
+
+static CachedArchiveEntry *findEntry(const ArchiveEntryCacheKey &key)
+{
+	auto it = std::ranges::find_if(cache, [&](auto &e){ return e.matches(key); });
+	if(it == cache.end())
+		return {};
+	std::rotate(it, it + 1, cache.end());
+	return &cache.back();
+}
+
+MapIO cachedArchiveEntry(const ArchiveEntryCacheKey &key, size_t size, ArchiveEntryExtractDelegate extract)
+{
+	{
+		std::scoped_lock lock{cacheMutex};
+		if(auto e = findEntry(key))
+		{
+			logMsg("using cached %s from %s", key.entryName.data(), key.archivePath.data());
+			return mapEntry(*e);
+		}
+	}
+	if(!size || size > archiveEntryCacheSize)
+		return {};
+	// extract without holding the lock so other entries can be read meanwhile
+	PosixIO file{makeMemoryFile(size)};
+	if(!file)
+		return {};
+	{
+		auto dest = file.mapRange(0, size, IOMapFlagsMask::Write);
+		if(!dest || !extract(std::span<uint8_t>{dest.data(), dest.size()}))
+			return {};
+	}
+	std::scoped_lock lock{cacheMutex};
+	if(auto e = findEntry(key)) // another thread cached the same entry first
+		return mapEntry(*e);
+	evictEntries(archiveEntryCacheSize - size);
+	cacheBytes += size;
+	cache.emplace_back(std::string{key.archivePath}, std::string{key.entryName},
+		key.archiveWriteTime, key.archiveSize, std::move(file), size);
+	logMsg("cached %s from %s (%zu bytes, %zu total)", key.entryName.data(), key.archivePath.data(), size, cacheBytes);
+	return mapEntry(cache.back());
+}
+
+void clearArchiveEntryCache()
+{
+	std::scoped_lock lock{cacheMutex};
+	evictEntries(0);
+}
+
+}
@@ -15,6 +15,7 @@
 
 #define LOGTAG "ArchFS"
 #include <imagine/fs/ArchiveFS.hh>
+#include <imagine/fs/ArchiveIndex.hh>
 #include <imagine/io/IO.hh>
 #include <imagine/util/utility.h>
 #include <imagine/util/string.h>
@@ -89,8 +90,10 @@ static ArchiveIO fileFromArchiveGeneric(auto &&init, std::string_view filePath)
 	return {};
 }
 
-ArchiveIO fileFromArchive(CStringView archivePath, std::string_view filePath)
+IO fileFromArchive(CStringView archivePath, std::string_view filePath)
 {
+	if(auto index = archiveIndex(archivePath))
+		return index->open(filePath);
 	return fileFromArchiveGeneric(archivePath, filePath);
 }
 
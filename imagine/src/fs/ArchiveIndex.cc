@@ -0,0 +1,505 @@
+/*  This file is part of Imagine.
+
+	Imagine is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Imagine is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Imagine.  If not, see <http://www.gnu.org/licenses/> */
+
+#define LOGTAG "ArchIndex"
+#include <imagine/fs/ArchiveIndex.hh>
+#include <imagine/fs/ArchiveEntryCache.hh>
+#include <imagine/fs/ArchiveFS.hh>
+#include <imagine/fs/FS.hh>
+#include <imagine/io/IO.hh>
+#include <imagine/io/FileIO.hh>
+#include <imagine/util/string.h>
+#include <imagine/util/string/uri.hh>
+#include <imagine/util/format.hh>
+#include <imagine/logger/logger.h>
+#include <zlib.h>
+#include <algorithm>
+#include <array>
+#include <mutex>
+#include <stdexcept>
+
+namespace IG::FS
+{
+
+// zip record signatures & sizes
+constexpr uint32_t localHeaderSig = 0x04034b50;
+constexpr uint32_t centralHeaderSig = 0x02014b50;
+constexpr uint32_t endOfCentralDirSig = 0x06054b50;
+constexpr uint32_t zip64EndOfCentralDirSig = 0x06064b50;
+constexpr uint32_t zip64LocatorSig = 0x07064b50;
+constexpr size_t localHeaderSize = 30;
+constexpr size_t centralHeaderSize = 46;
+constexpr size_t endOfCentralDirSize = 22;
+constexpr size_t zip64EndOfCentralDirSize = 56;
+constexpr size_t zip64LocatorSize = 20;
+constexpr size_t maxZipCommentSize = 0xFFFF;
+constexpr uint16_t zip64ExtraId = 0x0001;
+constexpr uint16_t methodStored = 0;
+constexpr uint16_t methodDeflated = 8;
+constexpr uint16_t flagEncrypted = 1;
+
+constexpr uint32_t cacheMagic = 0x58444941; // "AIDX"
+constexpr uint32_t cacheVersion = 1;
+constexpr size_t maxMemCacheEntries = 8;
+
+static PathString cacheDir;
+static std::vector<std::shared_ptr<const ArchiveIndex>> memCache; // most recently used at the back
+static std::mutex cacheMutex;
+
+static uint16_t get16(const uint8_t *p) { return p[0] | p[1] << 8; }
+static uint32_t get32(const uint8_t *p) { return get16(p) | uint32_t(get16(p + 2)) << 16; }
+static uint64_t get64(const uint8_t *p) { return get32(p) | uint64_t(get32(p + 4)) << 32; }
+
+static int64_t toSeconds(file_time_type t)
+{
+	return std::chrono::duration_cast<std::chrono::seconds>(t.time_since_epoch()).count();
+}
+
+static void readExact(IO &io, void *buff, size_t bytes, off_t offset)
+{
+	if(io.read(buff, bytes, offset) != ssize_t(bytes)) [[unlikely]]
+		throw std::runtime_error{"Error reading zip directory"};
+}
+
+ArchiveIndex::ArchiveIndex(CStringView path):
+	path_{path}
+{
+	auto s = status(path);
+	lastWriteTime = toSeconds(s.lastWriteTime());
+	fileSize = s.size();
+	if(endsWithAnyCaseless(path, ".zip"))
+	{
+		try
+		{
+			IO io{FileIO{path, IOAccessHint::Random}};
+			readZipCentralDirectory(io);
+		}
+		catch(std::exception &err)
+		{
+			logErr("error reading central directory of %s:%s, scanning archive", path.data(), err.what());
+			entries_.clear();
+			readWithArchiveScan();
+		}
+	}
+	else
+	{
+		readWithArchiveScan();
+	}
+	sortNames();
+	logMsg("indexed %zu entries in %s", entries_.size(), path.data());
+}
+
+void ArchiveIndex::readZipCentralDirectory(IO &io)
+{
+	const uint64_t size = io.size();
+	if(size < endOfCentralDirSize)
+		throw std::runtime_error{"File too small"};
+	// end of central directory record is at the end of the file followed by an optional comment
+	auto tailSize = std::min<uint64_t>(size, endOfCentralDirSize + maxZipCommentSize);
+	auto tailOffset = size - tailSize;
+	std::vector<uint8_t> tail(tailSize);
+	readExact(io, tail.data(), tailSize, tailOffset);
+	ssize_t eocdPos = tailSize - endOfCentralDirSize;
+	while(eocdPos >= 0 && get32(&tail[eocdPos]) != endOfCentralDirSig)
+		eocdPos--;
+	if(eocdPos < 0)
+		throw std::runtime_error{"Missing end of central directory"};
+	const uint8_t *eocd = &tail[eocdPos];
+	uint64_t entryCount = get16(eocd + 10);
+	uint64_t dirSize = get32(eocd + 12);
+	uint64_t dirOffset = get32(eocd + 16);
+	if(entryCount == 0xFFFF || dirSize == 0xFFFFFFFF || dirOffset == 0xFFFFFFFF)
+	{
+		// zip64 locator directly precedes the end of central directory record
+		auto eocdOffset = tailOffset + eocdPos;
+		if(eocdOffset < zip64LocatorSize)
+			throw std::runtime_error{"Missing zip64 locator"};
+		std::array<uint8_t, zip64LocatorSize> locator;
+		readExact(io, locator.data(), locator.size(), eocdOffset - zip64LocatorSize);
+		if(get32(locator.data()) != zip64LocatorSig)
+			throw std::runtime_error{"Missing zip64 locator"};
+		std::array<uint8_t, zip64EndOfCentralDirSize> eocd64;
+		readExact(io, eocd64.data(), eocd64.size(), get64(&locator[8]));
+		if(get32(eocd64.data()) != zip64EndOfCentralDirSig)
+			throw std::runtime_error{"Missing zip64 end of central directory"};
+		entryCount = get64(&eocd64[32]);
+		dirSize = get64(&eocd64[40]);
+		dirOffset = get64(&eocd64[48]);
+	}
+	if(dirOffset > size || dirSize > size - dirOffset)
+		throw std::runtime_error{"Central directory out of range"};
+	std::vector<uint8_t> dir(dirSize);
+	readExact(io, dir.data(), dirSize, dirOffset);
+	entries_.reserve(std::min<uint64_t>(entryCount, dirSize / centralHeaderSize));
+	const uint8_t *p = dir.data();
+	const uint8_t *dirEnd = p + dirSize;
+	while(dirEnd - p >= ssize_t(centralHeaderSize) && get32(p) == centralHeaderSig)
+	{
+		auto flags = get16(p + 8);
+		auto method = get16(p + 10);
+		auto nameSize = get16(p + 28);
+		auto extraSize = get16(p + 30);
+		auto commentSize = get16(p + 32);
+		auto recordSize = centralHeaderSize + nameSize + extraSize + commentSize;
+		if(dirEnd - p < ssize_t(recordSize))
+			throw std::runtime_error{"Truncated central directory"};
+		std::string_view name{reinterpret_cast<const char*>(p + centralHeaderSize), nameSize};
+		ArchiveIndexEntry entry
+		{
+			.name = std::string{name},
+			.size = get32(p + 24),
+			.compressedSize = get32(p + 20),
+			.headerOffset = get32(p + 42),
+			.crc32 = get32(p + 16),
+			.type = name.ends_with('/') ? file_type::directory : file_type::regular,
+		};
+		// zip64 extended info holds the 64-bit versions of any saturated fields in this order
+		auto extra = p + centralHeaderSize + nameSize;
+		auto extraEnd = extra + extraSize;
+		while(extraEnd - extra >= 4)
+		{
+			auto id = get16(extra);
+			auto field = extra + 4;
+			auto fieldEnd = field + get16(extra + 2);
+			if(fieldEnd > extraEnd)
+				break;
+			extra = fieldEnd;
+			if(id != zip64ExtraId)
+				continue;
+			for(auto val : {&entry.size, &entry.compressedSize, &entry.headerOffset})
+			{
+				if(*val != 0xFFFFFFFF || fieldEnd - field < 8)
+					continue;
+				*val = get64(field);
+				field += 8;
+			}
+		}
+		if(!(flags & flagEncrypted) && (method == methodStored || method == methodDeflated)
+			&& entry.headerOffset < dirOffset)
+		{
+			entry.compression = method;
+		}
+		entries_.emplace_back(std::move(entry));
+		p += recordSize;
+	}
+}
+
+void ArchiveIndex::readWithArchiveScan()
+{
+	for(auto &entry : ArchiveIterator{path_})
+	{
+		entries_.emplace_back(ArchiveIndexEntry
+		{
+			.name = std::string{entry.name()},
+			.size = entry.size(),
+			.crc32 = entry.crc32(),
+			.type = entry.type(),
+		});
+	}
+}
+
+void ArchiveIndex::sortNames()
+{
+	sortedIdxs.resize(entries_.size());
+	for(uint32_t i = 0; auto &idx : sortedIdxs) { idx = i++; }
+	std::ranges::stable_sort(sortedIdxs, {}, [&](auto i){ return std::string_view{entries_[i].name}; });
+}
+
+const ArchiveIndexEntry *ArchiveIndex::find(std::string_view name) const
+{
+	auto it = std::ranges::lower_bound(sortedIdxs, name, {}, [&](auto i){ return std::string_view{entries_[i].name}; });
+	if(it == sortedIdxs.end() || entries_[*it].name != name)
+		return {};
+	return &entries_[*it];
+}
+
+static bool inflateEntry(PosixIO &io, off_t dataOffset, const ArchiveIndexEntry &entry, std::span<uint8_t> dest)
+{
+	if(entry.size > UINT32_MAX || entry.compressedSize > UINT32_MAX || dest.size() != entry.size)
+		return false;
+	auto src = io.mapRange(dataOffset, entry.compressedSize, {});
+	if(!src)
+		return false;
+	z_stream strm{};
+	if(inflateInit2(&strm, -MAX_WBITS) != Z_OK)
+		return false;
+	strm.next_in = src.data();
+	strm.avail_in = src.size();
+	strm.next_out = dest.data();
+	strm.avail_out = dest.size();
+	auto res = inflate(&strm, Z_FINISH);
+	inflateEnd(&strm);
+	if(res != Z_STREAM_END || strm.total_out != entry.size)
+	{
+		logErr("error inflating %s", entry.name.c_str());
+		return false;
+	}
+	if(::crc32(0, dest.data(), dest.size()) != entry.crc32)
+	{
+		logErr("CRC mismatch in %s", entry.name.c_str());
+		return false;
+	}
+	return true;
+}
+
+static bool extractEntry(CStringView archivePath, const ArchiveIndexEntry &entry, std::span<uint8_t> dest)
+{
+	for(auto &e : ArchiveIterator{archivePath})
+	{
+		if(e.type() == file_type::directory || e.name() != entry.name)
+			continue;
+		auto io = e.releaseIO();
+		for(size_t pos = 0; pos < dest.size();)
+		{
+			auto bytesRead = io.read(&dest[pos], dest.size() - pos);
+			if(bytesRead <= 0)
+			{
+				logErr("error extracting %s", entry.name.c_str());
+				return false;
+			}
+			pos += bytesRead;
+		}
+		return true;
+	}
+	return false;
+}
+
+IO ArchiveIndex::open(const ArchiveIndexEntry &entry, bool useEntryCache) const
+{
+	if(entry.hasDirectOffset() && entry.size)
+	{
+		// read the data offset from the local header since its extra field can differ from the central directory's
+		PosixIO io{path_, OpenFlagsMask::Test};
+		std::array<uint8_t, localHeaderSize> header;
+		if(io && io.read(header.data(), header.size(), entry.headerOffset) == ssize_t(header.size())
+			&& get32(header.data()) == localHeaderSig)
+		{
+			off_t dataOffset = entry.headerOffset + localHeaderSize + get16(&header[26]) + get16(&header[28]);
+			if(entry.compression == methodStored)
+			{
+				if(auto buff = io.mapRange(dataOffset, entry.size, {}))
+					return MapIO{std::move(buff)};
+			}
+			else
+			{
+				struct { PosixIO &io; off_t dataOffset; } src{io, dataOffset};
+				if(useEntryCache)
+				{
+					if(auto cached = cachedArchiveEntry(cacheKey(entry), entry.size,
+						[src = &src, &entry](std::span<uint8_t> dest){ return inflateEntry(src->io, src->dataOffset, entry, dest); }))
+						return cached;
+				}
+				IOBuffer buff{size_t(entry.size)};
+				if(inflateEntry(io, dataOffset, entry, {buff.data(), buff.size()}))
+					return MapIO{std::move(buff)};
+			}
+		}
+		logErr("can't directly open %s in %s, scanning archive", entry.name.c_str(), path_.data());
+	}
+	else if(useEntryCache && entry.type != file_type::directory)
+	{
+		// formats like 7z and rar can only be read forward, so extract once and serve later opens from memory
+		if(auto cached = cachedArchiveEntry(cacheKey(entry), entry.size,
+			[this, &entry](std::span<uint8_t> dest){ return extractEntry(path_, entry, dest); }))
+			return cached;
+	}
+	for(auto &e : ArchiveIterator{path_})
+	{
+		if(e.type() != file_type::directory && e.name() == entry.name)
+			return e.releaseIO();
+	}
+	return {};
+}
+
+ArchiveEntryCacheKey ArchiveIndex::cacheKey(const ArchiveIndexEntry &entry) const
+{
+	return {path_, entry.name, lastWriteTime, fileSize};
+}
+
+IO ArchiveIndex::open(std::string_view name) const
+{
+	auto entryPtr = find(name);
+	if(!entryPtr)
+		return {};
+	return open(*entryPtr);
+}
+
+bool ArchiveIndex::matchesFile(const file_status &s) const
+{
+	return lastWriteTime == toSeconds(s.lastWriteTime()) && fileSize == s.size();
+}
+
+// cache file layout: magic, version, last write time, file size, path length, path,
+// entry count, then each entry's fields followed by its name
+
+bool ArchiveIndex::readCache(FileIO &io, CStringView path, const file_status &s)
+{
+	try
+	{
+		auto get = [&]<class T>(T &val)
+		{
+			if(io.read(val).bytes != ssize_t(sizeof(T))) [[unlikely]]
+				throw std::runtime_error{"truncated file"};
+		};
+		auto getString = [&](std::string &str, size_t size)
+		{
+			str.resize(size);
+			if(io.read(std::span{str.data(), size}).bytes != ssize_t(size)) [[unlikely]]
+				throw std::runtime_error{"truncated file"};
+		};
+		uint32_t magic, version;
+		get(magic);
+		get(version);
+		if(magic != cacheMagic || version != cacheVersion)
+			return false;
+		get(lastWriteTime);
+		get(fileSize);
+		uint16_t pathSize;
+		get(pathSize);
+		std::string cachedPath;
+		getString(cachedPath, pathSize);
+		if(cachedPath != std::string_view{path} || !matchesFile(s))
+			return false;
+		path_ = path;
+		uint32_t entryCount;
+		get(entryCount);
+		entries_.resize(entryCount);
+		for(auto &e : entries_)
+		{
+			get(e.size);
+			get(e.compressedSize);
+			get(e.headerOffset);
+			get(e.crc32);
+			get(e.compression);
+			get(e.type);
+			uint16_t nameSize;
+			get(nameSize);
+			getString(e.name, nameSize);
+		}
+	}
+	catch(std::exception &err)
+	{
+		logErr("error reading index cache:%s", err.what());
+		return false;
+	}
+	sortNames();
+	return true;
+}
+
+void ArchiveIndex::writeCache(FileIO &io) const
+{
+	io.put(cacheMagic);
+	io.put(cacheVersion);
+	io.put(lastWriteTime);
+	io.put(fileSize);
+	io.put(uint16_t(path_.size()));
+	io.write(path_.data(), path_.size());
+	io.put(uint32_t(entries_.size()));
+	for(const auto &e : entries_)
+	{
+		io.put(e.size);
+		io.put(e.compressedSize);
+		io.put(e.headerOffset);
+		io.put(e.crc32);
+		io.put(e.compression);
+		io.put(e.type);
+		io.put(uint16_t(e.name.size()));
+		io.write(e.name.data(), e.name.size());
+	}
+}
+
+static PathString indexCachePath(CStringView path)
+{
+	if(cacheDir.empty())
+		return {};
+	// 64-bit FNV-1a hash of the archive path
+	uint64_t hash = 0xcbf29ce484222325;
+	for(auto c : std::string_view{path})
+	{
+		hash ^= uint8_t(c);
+		hash *= 0x100000001b3;
+	}
+	return format<PathString>("{}/{:016x}.idx", cacheDir, hash);
+}
+
+static std::shared_ptr<const ArchiveIndex> loadIndex(CStringView path, const file_status &s)
+{
+	auto cachePath = indexCachePath(path);
+	if(cachePath.size())
+	{
+		auto index = std::make_shared<ArchiveIndex>();
+		if(FileIO io{cachePath, IOAccessHint::Sequential, OpenFlagsMask::Test};
+			io && index->readCache(io, path, s))
+		{
+			logMsg("loaded index of %s from cache", path.data());
+			return index;
+		}
+	}
+	auto index = std::make_shared<ArchiveIndex>(path);
+	if(cachePath.size())
+	{
+		if(FileIO io{cachePath, OpenFlagsMask::New | OpenFlagsMask::Test}; io)
+			index->writeCache(io);
+	}
+	return index;
+}
+
+std::shared_ptr<const ArchiveIndex> archiveIndex(CStringView path, bool useMemoryCache)
+{
+	if(isUri(path))
+		return {};
+	auto s = status(path);
+	if(s.type() != file_type::regular)
+		return {};
+	std::scoped_lock lock{cacheMutex};
+	if(auto it = std::ranges::find_if(memCache, [&](auto &i){ return std::string_view{i->path()} == std::string_view{path}; });
+		it != memCache.end())
+	{
+		auto index = *it;
+		if(index->matchesFile(s))
+		{
+			if(useMemoryCache) // move to the back as the most recently used
+				std::ranges::rotate(it, it + 1, memCache.end());
+			return index;
+		}
+		memCache.erase(it);
+	}
+	try
+	{
+		auto index = loadIndex(path, s);
+		if(useMemoryCache)
+		{
+			if(memCache.size() == maxMemCacheEntries)
+				memCache.erase(memCache.begin());
+			memCache.emplace_back(index);
+		}
+		return index;
+	}
+	catch(std::exception &err)
+	{
+		logErr("error indexing %s:%s", path.data(), err.what());
+		return {};
+	}
+}
+
+void setArchiveIndexCacheDirectory(CStringView path)
+{
+	std::scoped_lock lock{cacheMutex};
+	cacheDir = path;
+	if(cacheDir.size())
+		create_directory(cacheDir);
+}
+
+}
@@ -51,9 +51,11 @@ GLRenderer::GLRenderer(ApplicationContext ctx):
 	mainTask{ctx, "Main GL Context Messages", *static_cast<Renderer*>(this)},
 	releaseShaderCompilerEvent{"GLRenderer::releaseShaderCompilerEvent"}
 {
+	// a missing display is only an error once a context is needed, allowing headless use
 	if(!glManager)
 	{
-		throw std::runtime_error("Renderer error getting GL display");
+		logErr("error getting GL display");
+		return;
 	}
 	glManager.logInfo();
 }
@@ -64,6 +66,10 @@ void Renderer::initMainTask(Window *initialWindow, DrawableConfig drawableConfig
 	{
 		return;
 	}
+	if(!glManager)
+	{
+		throw std::runtime_error("Renderer error getting GL display");
+	}
 	auto ctx = appContext();
 	auto bufferConfig = makeGLBufferConfig(ctx, drawableConfig.pixelFormat, initialWindow);
 	if(!bufferConfig) [[unlikely]]
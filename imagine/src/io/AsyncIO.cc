@@ -0,0 +1,255 @@
+/*  This file is part of Imagine.
+
+	Imagine is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Imagine is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Imagine.  If not, see <http://www.gnu.org/licenses/> */
+
+#define LOGTAG "AsyncIO"
+#include <imagine/io/AsyncIO.hh>
+#include <imagine/util/variant.hh>
+#include <imagine/logger/logger.h>
+#include <span>
+#include <utility>
+
+namespace IG
+{
+
+AsyncIO::AsyncIO(unsigned queueDepth):
+	requests{std::make_unique<AsyncIORequest[]>(queueDepth)},
+	requestCount{queueDepth}
+{
+	freeRequests.reserve(queueDepth);
+	completed.reserve(queueDepth);
+	for(unsigned i = queueDepth; i--;)
+	{
+		freeRequests.emplace_back(&requests[i]);
+	}
+	#ifdef __linux__
+	// Android's seccomp filter kills apps making io_uring system calls
+	if(!Config::envIsAndroid && queue.emplace<IOUringQueue>(queueDepth, completionEvent.fd()))
+	{
+		logMsg("using io_uring with queue depth:%u", queueDepth);
+		return;
+	}
+	#endif
+	queue.emplace<ThreadIOQueue>(completionEvent);
+	logMsg("using worker thread with queue depth:%u", queueDepth);
+}
+
+AsyncIO::~AsyncIO()
+{
+	while(pendingRequests_)
+	{
+		processCompletions(true);
+	}
+	// futures may outlive this object, leave them only the result since the requests are freed with it
+	for(auto &req : std::span{requests.get(), requestCount})
+	{
+		if(req.future)
+			req.future->orphan();
+	}
+}
+
+IOFuture AsyncIO::queueRead(int fd, void *buff, size_t bytes, off_t offset)
+{
+	auto reqPtr = queueRequest(AsyncIORequest::Op::Read, fd, buff, bytes, offset, {});
+	return reqPtr ? IOFuture{*this, *reqPtr} : IOFuture{};
+}
+
+IOFuture AsyncIO::queueWrite(int fd, const void *buff, size_t bytes, off_t offset)
+{
+	auto reqPtr = queueRequest(AsyncIORequest::Op::Write, fd, const_cast<void*>(buff), bytes, offset, {});
+	return reqPtr ? IOFuture{*this, *reqPtr} : IOFuture{};
+}
+
+bool AsyncIO::queueRead(int fd, void *buff, size_t bytes, off_t offset, AsyncIOCompletionDelegate onComplete)
+{
+	assumeExpr(onComplete);
+	return queueRequest(AsyncIORequest::Op::Read, fd, buff, bytes, offset, onComplete);
+}
+
+bool AsyncIO::queueWrite(int fd, const void *buff, size_t bytes, off_t offset, AsyncIOCompletionDelegate onComplete)
+{
+	assumeExpr(onComplete);
+	return queueRequest(AsyncIORequest::Op::Write, fd, const_cast<void*>(buff), bytes, offset, onComplete);
+}
+
+IOFuture AsyncIO::readAtPos(int fd, void *buff, size_t bytes, off_t offset)
+{
+	auto future = queueRead(fd, buff, bytes, offset);
+	submit();
+	return future;
+}
+
+IOFuture AsyncIO::writeAtPos(int fd, const void *buff, size_t bytes, off_t offset)
+{
+	auto future = queueWrite(fd, buff, bytes, offset);
+	submit();
+	return future;
+}
+
+int AsyncIO::submit()
+{
+	return visit(overloaded
+	{
+		[](std::monostate &) { return 0; },
+		[](auto &q) { return q.hasUnsubmitted() ? q.submit() : 0; }
+	}, queue);
+}
+
+int AsyncIO::processCompletions(bool wait)
+{
+	if(!pendingRequests_)
+		return 0;
+	visit(overloaded
+	{
+		[](std::monostate &) {},
+		[&](auto &q)
+		{
+			if(wait && q.hasUnsubmitted())
+				q.submit();
+			q.reap(wait, completed);
+		}
+	}, queue);
+	int count{};
+	// delegates may queue new requests or process completions themselves
+	while(completed.size())
+	{
+		auto &req = *completed.back();
+		completed.pop_back();
+		pendingRequests_--;
+		count++;
+		req.state = AsyncIORequest::State::Done;
+		if(req.onComplete)
+		{
+			auto onComplete = req.onComplete;
+			auto result = req.result;
+			freeRequest(req);
+			onComplete(result);
+		}
+	}
+	return count;
+}
+
+bool AsyncIO::attach(EventLoop loop)
+{
+	if(!completionEvent)
+		return false;
+	completionEvent.attach(loop, [this]{ processCompletions(); });
+	return true;
+}
+
+void AsyncIO::detach()
+{
+	completionEvent.detach();
+}
+
+AsyncIORequest *AsyncIO::queueRequest(AsyncIORequest::Op op, int fd, void *buff, size_t bytes, off_t offset, AsyncIOCompletionDelegate onComplete)
+{
+	if(freeRequests.empty())
+	{
+		submit();
+		while(freeRequests.empty() && pendingRequests_)
+		{
+			processCompletions(true);
+		}
+		if(freeRequests.empty())
+		{
+			logErr("no free requests, all are held by unfinished futures");
+			return {};
+		}
+	}
+	auto &req = *freeRequests.back();
+	freeRequests.pop_back();
+	req = {.onComplete = onComplete, .buff = buff, .bytes = bytes, .offset = offset,
+		.fd = fd, .op = op, .state = AsyncIORequest::State::Queued};
+	visit(overloaded
+	{
+		[](std::monostate &) {},
+		[&](auto &q) { q.queue(req); }
+	}, queue);
+	pendingRequests_++;
+	return &req;
+}
+
+void AsyncIO::freeRequest(AsyncIORequest &req)
+{
+	req.state = AsyncIORequest::State::Free;
+	freeRequests.emplace_back(&req);
+}
+
+IOFuture::IOFuture(IOFuture &&o) noexcept
+{
+	*this = std::move(o);
+}
+
+IOFuture &IOFuture::operator=(IOFuture &&o) noexcept
+{
+	release();
+	asyncIO = std::exchange(o.asyncIO, nullptr);
+	req = std::exchange(o.req, nullptr);
+	result = std::exchange(o.result, -EAGAIN);
+	if(req)
+		req->future = this;
+	return *this;
+}
+
+IOFuture::~IOFuture()
+{
+	release();
+}
+
+bool IOFuture::poll()
+{
+	if(!req)
+		return true;
+	if(req->state != AsyncIORequest::State::Done)
+		asyncIO->processCompletions();
+	return req->state == AsyncIORequest::State::Done;
+}
+
+ssize_t IOFuture::get()
+{
+	if(!req)
+		return result;
+	while(req->state != AsyncIORequest::State::Done)
+	{
+		asyncIO->processCompletions(true);
+	}
+	auto result = req->result;
+	release();
+	return result;
+}
+
+void IOFuture::release()
+{
+	if(!req)
+		return;
+	while(req->state != AsyncIORequest::State::Done)
+	{
+		asyncIO->processCompletions(true);
+	}
+	req->future = {};
+	asyncIO->freeRequest(*req);
+	req = {};
+	asyncIO = {};
+}
+
+void IOFuture::orphan()
+{
+	assumeExpr(req && req->state == AsyncIORequest::State::Done);
+	result = req->result;
+	req = {};
+	asyncIO = {};
+}
+
+}
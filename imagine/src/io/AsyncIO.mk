@@ -0,0 +1,10 @@
+ifndef inc_io_async
+inc_io_async := 1
+
+SRC += io/AsyncIO.cc io/ThreadIOQueue.cc
+
+ifneq ($(filter linux android,$(ENV)),)
+ SRC += io/IOUringQueue.cc
+endif
+
+endif
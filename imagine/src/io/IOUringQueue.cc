@@ -0,0 +1,175 @@
+/*  This file is part of Imagine.
+
+	Imagine is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Imagine is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Imagine.  If not, see <http://www.gnu.org/licenses/> */
+
+#define LOGTAG "IOUringQueue"
+#include <imagine/io/AsyncIO.hh>
+#include <imagine/logger/logger.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+
+namespace IG
+{
+
+// same limit as read()/write() on Linux
+constexpr size_t maxTransferBytes = 0x7ffff000;
+
+static int ioUringSetup(unsigned entries, io_uring_params *params)
+{
+	return syscall(__NR_io_uring_setup, entries, params);
+}
+
+static int ioUringEnter(int fd, unsigned toSubmit, unsigned minComplete, unsigned flags)
+{
+	return syscall(__NR_io_uring_enter, fd, toSubmit, minComplete, flags, nullptr, 0);
+}
+
+static int ioUringRegister(int fd, unsigned opcode, void *arg, unsigned args)
+{
+	return syscall(__NR_io_uring_register, fd, opcode, arg, args);
+}
+
+static bool supportsReadWriteOps(int fd)
+{
+	constexpr unsigned probeOps = IORING_OP_WRITE + 1;
+	alignas(io_uring_probe) std::array<uint8_t, sizeof(io_uring_probe) + probeOps * sizeof(io_uring_probe_op)> probeMem{};
+	auto &probe = *reinterpret_cast<io_uring_probe*>(probeMem.data());
+	if(ioUringRegister(fd, IORING_REGISTER_PROBE, &probe, probeOps) == -1)
+		return false;
+	auto isSupported = [&](unsigned op) { return op <= probe.last_op && (probe.ops[op].flags & IO_URING_OP_SUPPORTED); };
+	return isSupported(IORING_OP_READ) && isSupported(IORING_OP_WRITE);
+}
+
+IOUringQueue::IOUringQueue(unsigned entries, int eventFd)
+{
+	io_uring_params params{};
+	UniqueFileDescriptor fd{ioUringSetup(entries, &params)};
+	if(fd == -1)
+	{
+		logMsg("io_uring_setup failed:%s", strerror(errno));
+		return;
+	}
+	// requires Linux 5.6+ for the single ring mapping and plain read/write ops
+	if(!(params.features & IORING_FEAT_SINGLE_MMAP) || !supportsReadWriteOps(fd))
+	{
+		logMsg("io_uring missing required features");
+		return;
+	}
+	ringMemSize = std::max(params.sq_off.array + params.sq_entries * sizeof(uint32_t),
+		params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe));
+	ringMem = mmap(nullptr, ringMemSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+	if(ringMem == MAP_FAILED)
+	{
+		logErr("error mapping io_uring ring:%s", strerror(errno));
+		ringMem = {};
+		return;
+	}
+	sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+	auto sqesMem = mmap(nullptr, sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+	if(sqesMem == MAP_FAILED)
+	{
+		logErr("error mapping io_uring SQEs:%s", strerror(errno));
+		deinit();
+		return;
+	}
+	sqes = static_cast<io_uring_sqe*>(sqesMem);
+	auto ring = static_cast<uint8_t*>(ringMem);
+	sqTail = reinterpret_cast<uint32_t*>(ring + params.sq_off.tail);
+	sqArray = reinterpret_cast<uint32_t*>(ring + params.sq_off.array);
+	sqMask = *reinterpret_cast<uint32_t*>(ring + params.sq_off.ring_mask);
+	cqHead = reinterpret_cast<uint32_t*>(ring + params.cq_off.head);
+	cqTail = reinterpret_cast<uint32_t*>(ring + params.cq_off.tail);
+	cqes = reinterpret_cast<io_uring_cqe*>(ring + params.cq_off.cqes);
+	cqMask = *reinterpret_cast<uint32_t*>(ring + params.cq_off.ring_mask);
+	if(ioUringRegister(fd, IORING_REGISTER_EVENTFD, &eventFd, 1) == -1)
+	{
+		logErr("error registering io_uring eventfd:%s", strerror(errno));
+		deinit();
+		return;
+	}
+	ringFd = std::move(fd);
+}
+
+IOUringQueue::~IOUringQueue()
+{
+	deinit();
+}
+
+void IOUringQueue::deinit()
+{
+	if(sqes)
+		munmap(sqes, sqesSize);
+	if(ringMem)
+		munmap(ringMem, ringMemSize);
+	sqes = {};
+	ringMem = {};
+}
+
+void IOUringQueue::queue(AsyncIORequest &req)
+{
+	// only this thread produces SQEs, the kernel just needs to see the tail update after the entry
+	auto tail = *sqTail;
+	auto idx = tail & sqMask;
+	auto &sqe = sqes[idx];
+	sqe = {};
+	sqe.opcode = req.op == AsyncIORequest::Op::Read ? IORING_OP_READ : IORING_OP_WRITE;
+	sqe.fd = req.fd;
+	sqe.off = req.offset;
+	sqe.addr = uintptr_t(req.buff);
+	sqe.len = std::min(req.bytes, maxTransferBytes);
+	sqe.user_data = uintptr_t(&req);
+	sqArray[idx] = idx;
+	std::atomic_ref{*sqTail}.store(tail + 1, std::memory_order_release);
+	unsubmitted++;
+}
+
+int IOUringQueue::submit()
+{
+	auto submitted = ioUringEnter(ringFd, unsubmitted, 0, 0);
+	if(submitted == -1)
+	{
+		logErr("error submitting %u requests:%s", unsubmitted, strerror(errno));
+		return -1;
+	}
+	unsubmitted -= submitted;
+	return submitted;
+}
+
+void IOUringQueue::reap(bool wait, std::vector<AsyncIORequest*> &completed)
+{
+	auto head = *cqHead;
+	auto tail = std::atomic_ref{*cqTail}.load(std::memory_order_acquire);
+	if(head == tail && wait)
+	{
+		if(ioUringEnter(ringFd, 0, 1, IORING_ENTER_GETEVENTS) == -1 && errno != EINTR)
+			logErr("error waiting for completions:%s", strerror(errno));
+		tail = std::atomic_ref{*cqTail}.load(std::memory_order_acquire);
+	}
+	for(; head != tail; head++)
+	{
+		auto &cqe = cqes[head & cqMask];
+		auto &req = *reinterpret_cast<AsyncIORequest*>(cqe.user_data);
+		req.result = cqe.res;
+		completed.emplace_back(&req);
+	}
+	std::atomic_ref{*cqHead}.store(head, std::memory_order_release);
+}
+
+}
@@ -18,6 +18,7 @@
 #include <imagine/util/fd-utils.h>
 #include <imagine/util/utility.h>
 #include <imagine/util/string/StaticString.hh>
+#include <imagine/vmem/pageSize.hh>
 #include <imagine/config/defs.hh>
 #include <imagine/logger/logger.h>
 #include "utils.hh"
@@ -242,14 +243,17 @@ IOBuffer PosixIO::mapRange(off_t start, size_t size, IOMapFlagsMask mapFlags)
 	int prot = PROT_READ;
 	if(to_underlying(mapFlags & IOMapFlagsMask::Write))
 		prot |= PROT_WRITE;
-	void *data = mmap(nullptr, size, prot, flags, fd(), start);
+	// mmap offsets must be page aligned, map from the preceding page boundary if needed
+	auto alignedStart = off_t(roundDownToPageSize(start));
+	auto pageOffset = size_t(start - alignedStart);
+	void *data = mmap(nullptr, size + pageOffset, prot, flags, fd(), alignedStart);
 	if(data == MAP_FAILED) [[unlikely]]
 	{
 		logErr("mmap (%s) fd:%d @ %zu (%zu bytes) failed", protectionFlagsString(prot).data(), fd(), (size_t)start, size);
 		return {};
 	}
 	logMsg("mapped (%s) fd:%d @ %zu to %p (%zu bytes)", protectionFlagsString(prot).data(), fd(), (size_t)start, data, size);
-	return byteBufferFromMmap(data, size);
+	return byteBufferFromMmap((uint8_t*)data + pageOffset, size);
 }
 
 IOBuffer PosixIO::byteBufferFromMmap(void *data, size_t size)
@@ -257,8 +261,10 @@ IOBuffer PosixIO::byteBufferFromMmap(void *data, size_t size)
 	return
 	{
 		{(uint8_t*)data, size}, IOBuffer::MAPPED_FILE_BIT,
-		[](const uint8_t *ptr, size_t size)
+		[](const uint8_t *dataPtr, size_t dataSize)
 		{
+			auto ptr = roundDownToPageSize((uint8_t*)dataPtr);
+			auto size = dataSize + (dataPtr - ptr);
 			logMsg("unmapping:%p (%zu bytes)", ptr, size);
 			if(munmap((void*)ptr, size) == -1)
 			{
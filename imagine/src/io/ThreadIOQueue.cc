@@ -0,0 +1,89 @@
+/*  This file is part of Imagine.
+
+	Imagine is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Imagine is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Imagine.  If not, see <http://www.gnu.org/licenses/> */
+
+#define LOGTAG "ThreadIOQueue"
+#include <imagine/io/AsyncIO.hh>
+#include <imagine/logger/logger.h>
+#include <unistd.h>
+#include <cerrno>
+
+namespace IG
+{
+
+ThreadIOQueue::ThreadIOQueue(CustomEvent &completionEvent):
+	completionEventPtr{&completionEvent}
+{
+	thread = std::thread{[this](){ run(); }};
+}
+
+ThreadIOQueue::~ThreadIOQueue()
+{
+	{
+		std::scoped_lock lock{mutex};
+		quit = true;
+	}
+	pendingCondition.notify_one();
+	thread.join();
+}
+
+void ThreadIOQueue::queue(AsyncIORequest &req)
+{
+	unsubmitted.emplace_back(&req);
+}
+
+int ThreadIOQueue::submit()
+{
+	int count = unsubmitted.size();
+	{
+		std::scoped_lock lock{mutex};
+		pending.insert(pending.end(), unsubmitted.begin(), unsubmitted.end());
+	}
+	unsubmitted.clear();
+	pendingCondition.notify_one();
+	return count;
+}
+
+void ThreadIOQueue::reap(bool wait, std::vector<AsyncIORequest*> &completed)
+{
+	std::unique_lock lock{mutex};
+	if(wait)
+		completedCondition.wait(lock, [&]{ return finished.size(); });
+	completed.insert(completed.end(), finished.begin(), finished.end());
+	finished.clear();
+}
+
+void ThreadIOQueue::run()
+{
+	std::unique_lock lock{mutex};
+	while(true)
+	{
+		pendingCondition.wait(lock, [&]{ return quit || pending.size(); });
+		if(pending.empty())
+			return;
+		auto &req = *pending.front();
+		pending.pop_front();
+		lock.unlock();
+		auto result = req.op == AsyncIORequest::Op::Read ?
+			::pread(req.fd, req.buff, req.bytes, req.offset) :
+			::pwrite(req.fd, req.buff, req.bytes, req.offset);
+		req.result = result == -1 ? -errno : result;
+		lock.lock();
+		finished.emplace_back(&req);
+		completedCondition.notify_one();
+		completionEventPtr->notify();
+	}
+}
+
+}
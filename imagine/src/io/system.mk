@@ -1,12 +1,16 @@
 ifeq ($(ENV), linux)
  include $(imagineSrcDir)/io/PosixIO.mk
+ include $(imagineSrcDir)/io/AsyncIO.mk
 else ifeq ($(ENV), android)
  include $(imagineSrcDir)/io/PosixIO.mk
  include $(imagineSrcDir)/io/AAssetIO.mk
+ include $(imagineSrcDir)/io/AsyncIO.mk
 else ifeq ($(ENV), ios)
  include $(imagineSrcDir)/io/PosixIO.mk
+ include $(imagineSrcDir)/io/AsyncIO.mk
 else ifeq ($(ENV), macosx)
  include $(imagineSrcDir)/io/PosixIO.mk
+ include $(imagineSrcDir)/io/AsyncIO.mk
 else ifeq ($(ENV), win32)
  include $(imagineSrcDir)/io/Win32IO.mk
 endif
@@ -13,8 +13,19 @@
 	You should have received a copy of the GNU General Public License
 	along with Imagine.  If not, see <http://www.gnu.org/licenses/> */
 
+#define LOGTAG "Pixmap"
+#include <imagine/pixmap/Pixmap.hh>
+#include <imagine/logger/logger.h>
 #include <array>
 #include <cstdint>
+#include <utility>
+#if defined __x86_64__ || defined __i386__
+#define IG_PIXEL_CONVERT_X86
+#include <immintrin.h>
+#elif defined __ARM_NEON && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#define IG_PIXEL_CONVERT_NEON
+#include <arm_neon.h>
+#endif
 
 namespace IG
 {
@@ -109,4 +120,342 @@ static uint32_t transformRGB888ToRGBX8888Impl(RGBTripleArray p)
 uint32_t transformRGB888ToRGBX8888(RGBTripleArray p) { return transformRGB888ToRGBX8888Impl(p); }
 uint32_t transformRGB888ToBGRX8888(RGBTripleArray p) { return transformRGB888ToRGBX8888Impl<true>(p); }
 
+// Line conversion kernels, the vector versions produce identical results to the scalar transform functions:
+// 5/6-bit expansion uses (x * 527 + 23) >> 6 and (x * 259 + 33) >> 6, and division by 255 uses (t + 1 + (t >> 8)) >> 8
+
+template <bool BGR_SWAP>
+static void convertLineRGB565ToRGBX8888Scalar(const uint16_t *src, uint32_t *dest, size_t pixels)
+{
+	for(size_t i = 0; i < pixels; i++)
+		dest[i] = transformRGB565ToRGBX8888Impl<BGR_SWAP>(src[i]);
+}
+
+template <bool BGR_SWAP>
+static void convertLineRGBX8888ToRGB565Scalar(const uint32_t *src, uint16_t *dest, size_t pixels)
+{
+	for(size_t i = 0; i < pixels; i++)
+		dest[i] = transformRGBX8888ToRGB565Impl<BGR_SWAP>(src[i]);
+}
+
+static void convertLineRGBA8888ToBGRA8888Scalar(const uint32_t *src, uint32_t *dest, size_t pixels)
+{
+	for(size_t i = 0; i < pixels; i++)
+		dest[i] = transformRGBA8888ToBGRA8888(src[i]);
+}
+
+template <class Src, class Dest>
+static void expandIndexedLineScalar(const Src *src, Dest *dest, size_t pixels, const Dest *palette)
+{
+	for(size_t i = 0; i < pixels; i++)
+		dest[i] = palette[src[i]];
+}
+
+#ifdef IG_PIXEL_CONVERT_X86
+
+template <bool BGR_SWAP>
+[[gnu::target("sse2")]]
+static void convertLineRGB565ToRGBX8888SSE2(const uint16_t *src, uint32_t *dest, size_t pixels)
+{
+	const auto mask5 = _mm_set1_epi16(0x1F);
+	const auto mask6 = _mm_set1_epi16(0x3F);
+	size_t i = 0;
+	for(; i + 8 <= pixels; i += 8)
+	{
+		auto p = _mm_loadu_si128((const __m128i*)(src + i));
+		auto r = _mm_srli_epi16(p, 11);
+		auto g = _mm_and_si128(_mm_srli_epi16(p, 5), mask6);
+		auto b = _mm_and_si128(p, mask5);
+		r = _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(r, _mm_set1_epi16(527)), _mm_set1_epi16(23)), 6);
+		g = _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(g, _mm_set1_epi16(259)), _mm_set1_epi16(33)), 6);
+		b = _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(b, _mm_set1_epi16(527)), _mm_set1_epi16(23)), 6);
+		if constexpr(BGR_SWAP) { std::swap(r, b); }
+		auto rg = _mm_or_si128(r, _mm_slli_epi16(g, 8));
+		_mm_storeu_si128((__m128i*)(dest + i), _mm_unpacklo_epi16(rg, b));
+		_mm_storeu_si128((__m128i*)(dest + i + 4), _mm_unpackhi_epi16(rg, b));
+	}
+	convertLineRGB565ToRGBX8888Scalar<BGR_SWAP>(src + i, dest + i, pixels - i);
+}
+
+[[gnu::target("sse2")]]
+static __m128i div255SSE2(__m128i t)
+{
+	return _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(t, _mm_set1_epi16(1)), _mm_srli_epi16(t, 8)), 8);
+}
+
+template <bool BGR_SWAP>
+[[gnu::target("sse2")]]
+static void convertLineRGBX8888ToRGB565SSE2(const uint32_t *src, uint16_t *dest, size_t pixels)
+{
+	const auto mask8 = _mm_set1_epi32(0xFF);
+	size_t i = 0;
+	for(; i + 8 <= pixels; i += 8)
+	{
+		auto p0 = _mm_loadu_si128((const __m128i*)(src + i));
+		auto p1 = _mm_loadu_si128((const __m128i*)(src + i + 4));
+		auto r = _mm_packs_epi32(_mm_and_si128(p0, mask8), _mm_and_si128(p1, mask8));
+		auto g = _mm_packs_epi32(_mm_and_si128(_mm_srli_epi32(p0, 8), mask8), _mm_and_si128(_mm_srli_epi32(p1, 8), mask8));
+		auto b = _mm_packs_epi32(_mm_and_si128(_mm_srli_epi32(p0, 16), mask8), _mm_and_si128(_mm_srli_epi32(p1, 16), mask8));
+		if constexpr(BGR_SWAP) { std::swap(r, b); }
+		r = div255SSE2(_mm_add_epi16(_mm_mullo_epi16(r, _mm_set1_epi16(31)), _mm_set1_epi16(127)));
+		g = div255SSE2(_mm_add_epi16(_mm_mullo_epi16(g, _mm_set1_epi16(63)), _mm_set1_epi16(127)));
+		b = div255SSE2(_mm_add_epi16(_mm_mullo_epi16(b, _mm_set1_epi16(31)), _mm_set1_epi16(127)));
+		auto out = _mm_or_si128(_mm_or_si128(_mm_slli_epi16(r, 11), _mm_slli_epi16(g, 5)), b);
+		_mm_storeu_si128((__m128i*)(dest + i), out);
+	}
+	convertLineRGBX8888ToRGB565Scalar<BGR_SWAP>(src + i, dest + i, pixels - i);
+}
+
+[[gnu::target("sse2")]]
+static void convertLineRGBA8888ToBGRA8888SSE2(const uint32_t *src, uint32_t *dest, size_t pixels)
+{
+	const auto maskGA = _mm_set1_epi32(0xFF00FF00);
+	const auto maskRB = _mm_set1_epi32(0x00FF00FF);
+	size_t i = 0;
+	for(; i + 4 <= pixels; i += 4)
+	{
+		auto p = _mm_loadu_si128((const __m128i*)(src + i));
+		auto rb = _mm_and_si128(p, maskRB);
+		rb = _mm_or_si128(_mm_srli_epi32(rb, 16), _mm_slli_epi32(rb, 16));
+		_mm_storeu_si128((__m128i*)(dest + i), _mm_or_si128(_mm_and_si128(p, maskGA), rb));
+	}
+	convertLineRGBA8888ToBGRA8888Scalar(src + i, dest + i, pixels - i);
+}
+
+template <bool BGR_SWAP>
+[[gnu::target("avx2")]]
+static void convertLineRGB565ToRGBX8888AVX2(const uint16_t *src, uint32_t *dest, size_t pixels)
+{
+	const auto mask5 = _mm256_set1_epi16(0x1F);
+	const auto mask6 = _mm256_set1_epi16(0x3F);
+	size_t i = 0;
+	for(; i + 16 <= pixels; i += 16)
+	{
+		auto p = _mm256_loadu_si256((const __m256i*)(src + i));
+		auto r = _mm256_srli_epi16(p, 11);
+		auto g = _mm256_and_si256(_mm256_srli_epi16(p, 5), mask6);
+		auto b = _mm256_and_si256(p, mask5);
+		r = _mm256_srli_epi16(_mm256_add_epi16(_mm256_mullo_epi16(r, _mm256_set1_epi16(527)), _mm256_set1_epi16(23)), 6);
+		g = _mm256_srli_epi16(_mm256_add_epi16(_mm256_mullo_epi16(g, _mm256_set1_epi16(259)), _mm256_set1_epi16(33)), 6);
+		b = _mm256_srli_epi16(_mm256_add_epi16(_mm256_mullo_epi16(b, _mm256_set1_epi16(527)), _mm256_set1_epi16(23)), 6);
+		if constexpr(BGR_SWAP) { std::swap(r, b); }
+		auto rg = _mm256_or_si256(r, _mm256_slli_epi16(g, 8));
+		// unpack works within 128-bit lanes, so re-order the lanes back into pixel order
+		auto lo = _mm256_unpacklo_epi16(rg, b);
+		auto hi = _mm256_unpackhi_epi16(rg, b);
+		_mm256_storeu_si256((__m256i*)(dest + i), _mm256_permute2x128_si256(lo, hi, 0x20));
+		_mm256_storeu_si256((__m256i*)(dest + i + 8), _mm256_permute2x128_si256(lo, hi, 0x31));
+	}
+	convertLineRGB565ToRGBX8888Scalar<BGR_SWAP>(src + i, dest + i, pixels - i);
+}
+
+[[gnu::target("avx2")]]
+static __m256i div255AVX2(__m256i t)
+{
+	return _mm256_srli_epi16(_mm256_add_epi16(_mm256_add_epi16(t, _mm256_set1_epi16(1)), _mm256_srli_epi16(t, 8)), 8);
+}
+
+template <bool BGR_SWAP>
+[[gnu::target("avx2")]]
+static void convertLineRGBX8888ToRGB565AVX2(const uint32_t *src, uint16_t *dest, size_t pixels)
+{
+	const auto mask8 = _mm256_set1_epi32(0xFF);
+	size_t i = 0;
+	for(; i + 16 <= pixels; i += 16)
+	{
+		auto p0 = _mm256_loadu_si256((const __m256i*)(src + i));
+		auto p1 = _mm256_loadu_si256((const __m256i*)(src + i + 8));
+		auto r = _mm256_packs_epi32(_mm256_and_si256(p0, mask8), _mm256_and_si256(p1, mask8));
+		auto g = _mm256_packs_epi32(_mm256_and_si256(_mm256_srli_epi32(p0, 8), mask8), _mm256_and_si256(_mm256_srli_epi32(p1, 8), mask8));
+		auto b = _mm256_packs_epi32(_mm256_and_si256(_mm256_srli_epi32(p0, 16), mask8), _mm256_and_si256(_mm256_srli_epi32(p1, 16), mask8));
+		if constexpr(BGR_SWAP) { std::swap(r, b); }
+		r = div255AVX2(_mm256_add_epi16(_mm256_mullo_epi16(r, _mm256_set1_epi16(31)), _mm256_set1_epi16(127)));
+		g = div255AVX2(_mm256_add_epi16(_mm256_mullo_epi16(g, _mm256_set1_epi16(63)), _mm256_set1_epi16(127)));
+		b = div255AVX2(_mm256_add_epi16(_mm256_mullo_epi16(b, _mm256_set1_epi16(31)), _mm256_set1_epi16(127)));
+		auto out = _mm256_or_si256(_mm256_or_si256(_mm256_slli_epi16(r, 11), _mm256_slli_epi16(g, 5)), b);
+		// pack works within 128-bit lanes, so re-order the 64-bit groups back into pixel order
+		_mm256_storeu_si256((__m256i*)(dest + i), _mm256_permute4x64_epi64(out, 0xD8));
+	}
+	convertLineRGBX8888ToRGB565Scalar<BGR_SWAP>(src + i, dest + i, pixels - i);
+}
+
+[[gnu::target("avx2")]]
+static void convertLineRGBA8888ToBGRA8888AVX2(const uint32_t *src, uint32_t *dest, size_t pixels)
+{
+	const auto swapRB = _mm256_setr_epi8(2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15,
+		2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15);
+	size_t i = 0;
+	for(; i + 8 <= pixels; i += 8)
+	{
+		auto p = _mm256_loadu_si256((const __m256i*)(src + i));
+		_mm256_storeu_si256((__m256i*)(dest + i), _mm256_shuffle_epi8(p, swapRB));
+	}
+	convertLineRGBA8888ToBGRA8888Scalar(src + i, dest + i, pixels - i);
+}
+
+[[gnu::target("avx2")]]
+static void expandIndexedLineAVX2(const uint8_t *src, uint32_t *dest, size_t pixels, const uint32_t *palette)
+{
+	size_t i = 0;
+	for(; i + 8 <= pixels; i += 8)
+	{
+		auto idx = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)(src + i)));
+		_mm256_storeu_si256((__m256i*)(dest + i), _mm256_i32gather_epi32((const int*)palette, idx, 4));
+	}
+	expandIndexedLineScalar(src + i, dest + i, pixels - i, palette);
+}
+
+[[gnu::target("avx2")]]
+static void expandIndexedLineAVX2(const uint16_t *src, uint32_t *dest, size_t pixels, const uint32_t *palette)
+{
+	size_t i = 0;
+	for(; i + 8 <= pixels; i += 8)
+	{
+		auto idx = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i*)(src + i)));
+		_mm256_storeu_si256((__m256i*)(dest + i), _mm256_i32gather_epi32((const int*)palette, idx, 4));
+	}
+	expandIndexedLineScalar(src + i, dest + i, pixels - i, palette);
+}
+
+#endif
+
+#ifdef IG_PIXEL_CONVERT_NEON
+
+template <bool BGR_SWAP>
+static void convertLineRGB565ToRGBX8888NEON(const uint16_t *src, uint32_t *dest, size_t pixels)
+{
+	size_t i = 0;
+	for(; i + 8 <= pixels; i += 8)
+	{
+		auto p = vld1q_u16(src + i);
+		auto r = vshrq_n_u16(p, 11);
+		auto g = vandq_u16(vshrq_n_u16(p, 5), vdupq_n_u16(0x3F));
+		auto b = vandq_u16(p, vdupq_n_u16(0x1F));
+		r = vshrq_n_u16(vmlaq_n_u16(vdupq_n_u16(23), r, 527), 6);
+		g = vshrq_n_u16(vmlaq_n_u16(vdupq_n_u16(33), g, 259), 6);
+		b = vshrq_n_u16(vmlaq_n_u16(vdupq_n_u16(23), b, 527), 6);
+		if constexpr(BGR_SWAP) { std::swap(r, b); }
+		uint8x8x4_t out{{vmovn_u16(r), vmovn_u16(g), vmovn_u16(b), vdup_n_u8(0)}};
+		vst4_u8((uint8_t*)(dest + i), out);
+	}
+	convertLineRGB565ToRGBX8888Scalar<BGR_SWAP>(src + i, dest + i, pixels - i);
+}
+
+static uint16x8_t div255NEON(uint16x8_t t)
+{
+	return vshrq_n_u16(vaddq_u16(vaddq_u16(t, vdupq_n_u16(1)), vshrq_n_u16(t, 8)), 8);
+}
+
+template <bool BGR_SWAP>
+static void convertLineRGBX8888ToRGB565NEON(const uint32_t *src, uint16_t *dest, size_t pixels)
+{
+	size_t i = 0;
+	for(; i + 8 <= pixels; i += 8)
+	{
+		auto p = vld4_u8((const uint8_t*)(src + i));
+		auto r = vmovl_u8(p.val[0]);
+		auto g = vmovl_u8(p.val[1]);
+		auto b = vmovl_u8(p.val[2]);
+		if constexpr(BGR_SWAP) { std::swap(r, b); }
+		r = div255NEON(vmlaq_n_u16(vdupq_n_u16(127), r, 31));
+		g = div255NEON(vmlaq_n_u16(vdupq_n_u16(127), g, 63));
+		b = div255NEON(vmlaq_n_u16(vdupq_n_u16(127), b, 31));
+		vst1q_u16(dest + i, vorrq_u16(vorrq_u16(vshlq_n_u16(r, 11), vshlq_n_u16(g, 5)), b));
+	}
+	convertLineRGBX8888ToRGB565Scalar<BGR_SWAP>(src + i, dest + i, pixels - i);
+}
+
+static void convertLineRGBA8888ToBGRA8888NEON(const uint32_t *src, uint32_t *dest, size_t pixels)
+{
+	size_t i = 0;
+	for(; i + 16 <= pixels; i += 16)
+	{
+		auto p = vld4q_u8((const uint8_t*)(src + i));
+		std::swap(p.val[0], p.val[2]);
+		vst4q_u8((uint8_t*)(dest + i), p);
+	}
+	convertLineRGBA8888ToBGRA8888Scalar(src + i, dest + i, pixels - i);
+}
+
+#endif
+
+struct PixelConvertFuncs
+{
+	const char *name;
+	void (*rgb565ToRGBX8888)(const uint16_t *, uint32_t *, size_t);
+	void (*rgb565ToBGRX8888)(const uint16_t *, uint32_t *, size_t);
+	void (*rgbx8888ToRGB565)(const uint32_t *, uint16_t *, size_t);
+	void (*bgrx8888ToRGB565)(const uint32_t *, uint16_t *, size_t);
+	void (*rgba8888ToBGRA8888)(const uint32_t *, uint32_t *, size_t);
+	void (*indexed8To32)(const uint8_t *, uint32_t *, size_t, const uint32_t *);
+	void (*indexed16To32)(const uint16_t *, uint32_t *, size_t, const uint32_t *);
+};
+
+static PixelConvertFuncs selectPixelConvertFuncs()
+{
+	PixelConvertFuncs funcs
+	{
+		"scalar",
+		convertLineRGB565ToRGBX8888Scalar<false>,
+		convertLineRGB565ToRGBX8888Scalar<true>,
+		convertLineRGBX8888ToRGB565Scalar<false>,
+		convertLineRGBX8888ToRGB565Scalar<true>,
+		convertLineRGBA8888ToBGRA8888Scalar,
+		expandIndexedLineScalar<uint8_t, uint32_t>,
+		expandIndexedLineScalar<uint16_t, uint32_t>,
+	};
+	#if defined IG_PIXEL_CONVERT_X86
+	__builtin_cpu_init();
+	if(__builtin_cpu_supports("avx2"))
+	{
+		funcs =
+		{
+			"AVX2",
+			convertLineRGB565ToRGBX8888AVX2<false>,
+			convertLineRGB565ToRGBX8888AVX2<true>,
+			convertLineRGBX8888ToRGB565AVX2<false>,
+			convertLineRGBX8888ToRGB565AVX2<true>,
+			convertLineRGBA8888ToBGRA8888AVX2,
+			expandIndexedLineAVX2,
+			expandIndexedLineAVX2,
+		};
+	}
+	else if(__builtin_cpu_supports("sse2"))
+	{
+		// no gather instruction, palette lookups stay scalar
+		funcs.name = "SSE2";
+		funcs.rgb565ToRGBX8888 = convertLineRGB565ToRGBX8888SSE2<false>;
+		funcs.rgb565ToBGRX8888 = convertLineRGB565ToRGBX8888SSE2<true>;
+		funcs.rgbx8888ToRGB565 = convertLineRGBX8888ToRGB565SSE2<false>;
+		funcs.bgrx8888ToRGB565 = convertLineRGBX8888ToRGB565SSE2<true>;
+		funcs.rgba8888ToBGRA8888 = convertLineRGBA8888ToBGRA8888SSE2;
+	}
+	#elif defined IG_PIXEL_CONVERT_NEON
+	funcs.name = "NEON";
+	funcs.rgb565ToRGBX8888 = convertLineRGB565ToRGBX8888NEON<false>;
+	funcs.rgb565ToBGRX8888 = convertLineRGB565ToRGBX8888NEON<true>;
+	funcs.rgbx8888ToRGB565 = convertLineRGBX8888ToRGB565NEON<false>;
+	funcs.bgrx8888ToRGB565 = convertLineRGBX8888ToRGB565NEON<true>;
+	funcs.rgba8888ToBGRA8888 = convertLineRGBA8888ToBGRA8888NEON;
+	#endif
+	logMsg("using %s pixel conversion", funcs.name);
+	return funcs;
+}
+
+static const PixelConvertFuncs &pixelConvertFuncs()
+{
+	static const PixelConvertFuncs funcs = selectPixelConvertFuncs();
+	return funcs;
+}
+
+void convertLineRGB565ToRGBX8888(const uint16_t *src, uint32_t *dest, size_t pixels) { pixelConvertFuncs().rgb565ToRGBX8888(src, dest, pixels); }
+void convertLineRGB565ToBGRX8888(const uint16_t *src, uint32_t *dest, size_t pixels) { pixelConvertFuncs().rgb565ToBGRX8888(src, dest, pixels); }
+void convertLineRGBX8888ToRGB565(const uint32_t *src, uint16_t *dest, size_t pixels) { pixelConvertFuncs().rgbx8888ToRGB565(src, dest, pixels); }
+void convertLineBGRX8888ToRGB565(const uint32_t *src, uint16_t *dest, size_t pixels) { pixelConvertFuncs().bgrx8888ToRGB565(src, dest, pixels); }
+void convertLineRGBA8888ToBGRA8888(const uint32_t *src, uint32_t *dest, size_t pixels) { pixelConvertFuncs().rgba8888ToBGRA8888(src, dest, pixels); }
+void expandIndexedLine(const uint8_t *src, uint16_t *dest, size_t pixels, const uint16_t *palette) { expandIndexedLineScalar(src, dest, pixels, palette); }
+void expandIndexedLine(const uint8_t *src, uint32_t *dest, size_t pixels, const uint32_t *palette) { pixelConvertFuncs().indexed8To32(src, dest, pixels, palette); }
+void expandIndexedLine(const uint16_t *src, uint16_t *dest, size_t pixels, const uint16_t *palette) { expandIndexedLineScalar(src, dest, pixels, palette); }
+void expandIndexedLine(const uint16_t *src, uint32_t *dest, size_t pixels, const uint32_t *palette) { pixelConvertFuncs().indexed16To32(src, dest, pixels, palette); }
+const char *pixelConvertImplName() { return pixelConvertFuncs().name; }
+
 }
@@ -57,6 +57,34 @@ void setThreadPriority(ThreadId id, int nice)
 	#endif
 }
 
+bool setThreadSchedulingPolicy(ThreadId id, ThreadSchedulingPolicy policy, int realtimePriority)
+{
+	#ifdef __linux__
+	if(policy == ThreadSchedulingPolicy::Normal)
+	{
+		sched_param param{};
+		if(sched_setscheduler(id, SCHED_OTHER, &param) && Config::DEBUG_BUILD)
+			logErr("error:%s restoring thread:0x%X scheduling policy", strerror(errno), (unsigned)id);
+		setThreadPriority(id, 0);
+		return true;
+	}
+	sched_param param{.sched_priority = realtimePriority};
+	// don't let any child processes inherit the real-time policy
+	int schedPolicy = (policy == ThreadSchedulingPolicy::FIFO ? SCHED_FIFO : SCHED_RR) | SCHED_RESET_ON_FORK;
+	if(sched_setscheduler(id, schedPolicy, &param))
+	{
+		// needs CAP_SYS_NICE or an RLIMIT_RTPRIO allowance
+		logWarn("error:%s setting thread:0x%X real-time priority:%d, using nice level instead",
+			strerror(errno), (unsigned)id, realtimePriority);
+		setThreadPriority(id, -10);
+		return false;
+	}
+	return true;
+	#else
+	return false;
+	#endif
+}
+
 void setThisThreadPriority(int nice)
 {
 	#ifdef __linux__
@@ -0,0 +1,16 @@
+ifndef inc_main
+inc_main := 1
+
+include $(IMAGINE_PATH)/make/imagineAppBase.mk
+
+SRC += main/main.cc
+
+include $(IMAGINE_PATH)/make/package/imagine.mk
+
+ifndef target
+target := AsyncIOTest
+endif
+
+include $(IMAGINE_PATH)/make/imagineAppTarget.mk
+
+endif
@@ -0,0 +1,139 @@
+/*  This file is part of Imagine.
+
+	Imagine is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Imagine is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Imagine.  If not, see <http://www.gnu.org/licenses/> */
+
+#define LOGTAG "main"
+#include <imagine/base/ApplicationContext.hh>
+#include <imagine/base/Application.hh>
+#include <imagine/base/EventLoop.hh>
+#include <imagine/io/AsyncIO.hh>
+#include <imagine/io/PosixIO.hh>
+#include <imagine/fs/FS.hh>
+#include <imagine/util/ranges.hh>
+#include <imagine/logger/logger.h>
+#include <meta.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+// Runs reads and writes through AsyncIO with futures, completion delegates, and an event loop,
+// exiting with a non-zero status if any result or transferred data is wrong
+
+namespace IG
+{
+
+constexpr unsigned queueDepth = 8;
+constexpr size_t blockSize = 4096;
+constexpr size_t blocks = 64; // several times the queue depth
+
+static int failures;
+
+static void check(bool passed, const char *name)
+{
+	if(passed)
+		return;
+	failures++;
+	std::printf("FAIL: %s\n", name);
+}
+
+static void runTests(int fd)
+{
+	std::vector<uint8_t> data(blockSize * blocks);
+	for(auto i : iotaCount(blocks))
+	{
+		std::fill_n(&data[i * blockSize], blockSize, uint8_t(i * 7 + 1));
+	}
+	AsyncIO aio{queueDepth};
+	std::printf("backend: %s\n", aio.isUsingIOUring() ? "io_uring" : "worker thread");
+
+	// futures hold their request until released, so write one queue depth at a time
+	bool writesOK = true;
+	for(size_t i = 0; i < blocks; i += queueDepth)
+	{
+		std::vector<IOFuture> futures;
+		for(auto b : iotaCount(queueDepth))
+		{
+			auto offset = (i + b) * blockSize;
+			futures.emplace_back(aio.queueWrite(fd, &data[offset], blockSize, offset));
+		}
+		aio.submit();
+		for(auto &f : futures)
+		{
+			writesOK &= f.get() == ssize_t(blockSize);
+		}
+	}
+	check(writesOK, "write with futures");
+
+	// queueing past the depth with delegates waits for earlier requests to complete
+	std::vector<uint8_t> readData(data.size());
+	size_t goodReads{};
+	for(auto i : iotaCount(blocks))
+	{
+		auto offset = i * blockSize;
+		aio.queueRead(fd, &readData[offset], blockSize, offset,
+			[&goodReads](ssize_t result) { goodReads += result == ssize_t(blockSize); });
+	}
+	aio.submit();
+	while(aio.pendingRequests())
+	{
+		aio.processCompletions(true);
+	}
+	check(goodReads == blocks && readData == data, "read with delegates");
+
+	uint8_t byte{};
+	check(aio.readAtPos(-1, &byte, 1, 0).get() == -EBADF, "error result");
+
+	// completions delivered by an event loop
+	auto loop = EventLoop::makeForThread();
+	aio.attach(loop);
+	bool running = true;
+	aio.queueRead(fd, &byte, 1, blockSize * 3, [&running](ssize_t) { running = false; });
+	aio.submit();
+	loop.run(running);
+	aio.detach();
+	check(byte == data[blockSize * 3], "event loop completion");
+
+	// a future outliving its AsyncIO keeps the result
+	IOFuture future;
+	std::vector<uint8_t> block(blockSize);
+	{
+		AsyncIO tempAIO{1};
+		future = tempAIO.readAtPos(fd, block.data(), blockSize, blockSize);
+	}
+	check(future.get() == ssize_t(blockSize) && std::ranges::equal(block, std::span{&data[blockSize], blockSize}),
+		"future outliving AsyncIO");
+}
+
+const char *const ApplicationContext::applicationName{CONFIG_APP_NAME};
+
+void ApplicationContext::onInit(ApplicationInitParams)
+{
+	auto path = FS::pathString(cachePath(), "AsyncIOTest.bin");
+	{
+		PosixIO file{path, OpenFlagsMask::New | OpenFlagsMask::Read};
+		// completions are run on this thread's own event loop
+		std::thread{[&]{ runTests(file.fd()); }}.join();
+	}
+	FS::remove(path);
+	if(failures)
+		std::printf("%d test(s) failed\n", failures);
+	else
+		std::printf("all tests passed\n");
+	std::exit(failures ? EXIT_FAILURE : EXIT_SUCCESS);
+}
+
+}
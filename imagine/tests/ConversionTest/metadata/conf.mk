@@ -0,0 +1,7 @@
+metadata_name = Conversion Test
+metadata_pkgName = ConversionTest
+metadata_exec = conversiontest
+metadata_id = com.explusalpha.$(metadata_pkgName)
+metadata_vendor = Robert Broglia
+metadata_version = 1.0.0
+metadata_noIcon = 1
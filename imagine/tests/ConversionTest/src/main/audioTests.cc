@@ -0,0 +1,123 @@
+/*  This file is part of Imagine.
+
+	Imagine is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Imagine is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Imagine.  If not, see <http://www.gnu.org/licenses/> */
+
+#include <imagine/audio/Format.hh>
+#include <imagine/util/math/math.hh>
+#include "tests.hh"
+#include <algorithm>
+#include <limits>
+#include <random>
+#include <vector>
+
+namespace ConversionTest
+{
+
+using namespace IG::Audio;
+
+template <class T>
+static std::vector<T> randomSamples(size_t size, uint32_t seed)
+{
+	std::mt19937 rng{seed};
+	std::vector<T> data(size);
+	if constexpr(std::is_floating_point_v<T>)
+	{
+		std::uniform_real_distribution<T> dist{-1, 1};
+		std::ranges::generate(data, [&]{ return dist(rng); });
+	}
+	else
+	{
+		std::ranges::generate(data, [&]{ return T(rng()); });
+	}
+	return data;
+}
+
+template <class T>
+static constexpr SampleFormat sampleFormatOf() { return std::is_floating_point_v<T> ? SampleFormats::f32 : SampleFormats::i16; }
+
+// Scalar reference for Format::copyFrames(), applying refFunc per sample and duplicating mono input into stereo
+template <class Src, class Dest>
+static void copyFramesRef(Dest *dest, int destChannels, const Src *src, int srcChannels, size_t frames, auto &&refFunc)
+{
+	for(size_t i = 0; i < frames * destChannels; i++)
+	{
+		dest[i] = refFunc(src[srcChannels == destChannels ? i : i / 2]);
+	}
+}
+
+// Runs Format::copyFrames() over every test size, at both an aligned and an unaligned start, and
+// compares it bit for bit against refFunc. Destination guard values catch writes past either end.
+template <class Src, class Dest>
+static void testCopy(TestContext &ctx, std::string_view name, int srcChannels, int destChannels, float volume, auto &&refFunc)
+{
+	const Format srcFormat{44100, sampleFormatOf<Src>(), int8_t(srcChannels)};
+	const Format destFormat{44100, sampleFormatOf<Dest>(), int8_t(destChannels)};
+	constexpr Dest guard = Dest(12345);
+	auto maxFrames = std::ranges::max(testLineSizes);
+	auto src = randomSamples<Src>((maxFrames + 1) * srcChannels, 1);
+	std::vector<Dest> dest((maxFrames + 2) * destChannels), ref(dest.size());
+	for(auto frames : testLineSizes)
+	{
+		for(size_t offset : {0, 1})
+		{
+			std::ranges::fill(dest, guard);
+			destFormat.copyFrames(dest.data() + offset, src.data() + offset, frames, srcFormat, volume);
+			copyFramesRef(ref.data(), destChannels, src.data() + offset, srcChannels, frames, refFunc);
+			auto samples = frames * destChannels;
+			bool passed = dest[offset + samples] == guard && (!offset || dest[0] == guard) &&
+				std::equal(dest.begin() + offset, dest.begin() + offset + samples, ref.begin());
+			ctx.check(passed, name, frames, offset);
+		}
+	}
+	auto benchSrc = randomSamples<Src>(benchmarkSize * srcChannels, 2);
+	std::vector<Dest> benchDest(benchmarkSize * destChannels);
+	auto scalarTime = timeRuns([&]
+	{
+		copyFramesRef(benchDest.data(), destChannels, benchSrc.data(), srcChannels, benchmarkSize, refFunc);
+	});
+	auto simdTime = timeRuns([&]
+	{
+		destFormat.copyFrames(benchDest.data(), benchSrc.data(), benchmarkSize, srcFormat, volume);
+	});
+	ctx.printBenchmark(name, scalarTime, simdTime, benchmarkSize);
+}
+
+static auto i16ToFloatRef(float volume) { return [=](int16_t s){ return (float(s) / 32768.f) * volume; }; }
+
+static auto floatToI16Ref(float volume)
+{
+	return [=](float s) -> int16_t
+	{
+		if(volume <= 1.f)
+			return remap(s * volume, -1.f, 1.f, std::numeric_limits<int16_t>{});
+		return remapClamp(s * volume, -1.f, 1.f, std::numeric_limits<int16_t>{});
+	};
+}
+
+static auto scaleI16Ref(float volume) { return [=](int16_t s){ return floatToI16Ref(volume)(float(s) / 32768.f); }; }
+
+void runAudioTests(TestContext &ctx)
+{
+	std::printf("sample conversion: %s\n", sampleConvertImplName());
+	testCopy<int16_t, float>(ctx, "I16 -> F32", 2, 2, .5f, i16ToFloatRef(.5f));
+	testCopy<float, int16_t>(ctx, "F32 -> I16", 2, 2, 1.f, floatToI16Ref(1.f));
+	testCopy<float, int16_t>(ctx, "F32 -> I16 (clamped)", 2, 2, 1.25f, floatToI16Ref(1.25f));
+	testCopy<int16_t, int16_t>(ctx, "I16 volume", 2, 2, .75f, scaleI16Ref(.75f));
+	testCopy<int16_t, int16_t>(ctx, "I16 volume (clamped)", 2, 2, 1.25f, scaleI16Ref(1.25f));
+	testCopy<int16_t, int16_t>(ctx, "I16 mono -> stereo", 1, 2, 1.f, [](int16_t s){ return s; });
+	testCopy<float, float>(ctx, "F32 mono -> stereo", 1, 2, 1.f, [](float s){ return s; });
+	testCopy<int16_t, float>(ctx, "I16 mono -> F32 stereo", 1, 2, .5f, i16ToFloatRef(.5f));
+}
+
+}
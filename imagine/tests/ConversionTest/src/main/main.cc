@@ -0,0 +1,44 @@
+/*  This file is part of Imagine.
+
+	Imagine is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Imagine is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Imagine.  If not, see <http://www.gnu.org/licenses/> */
+
+#define LOGTAG "main"
+#include <imagine/base/ApplicationContext.hh>
+#include <imagine/base/Application.hh>
+#include <imagine/logger/logger.h>
+#include "tests.hh"
+#include <meta.h>
+#include <cstdlib>
+
+// Checks the SIMD conversion kernels against their scalar reference implementations
+// and prints the speed of each, exiting with a non-zero status if any output differs
+
+namespace IG
+{
+
+const char *const ApplicationContext::applicationName{CONFIG_APP_NAME};
+
+void ApplicationContext::onInit(ApplicationInitParams)
+{
+	ConversionTest::TestContext ctx;
+	ConversionTest::runPixmapTests(ctx);
+	ConversionTest::runAudioTests(ctx);
+	if(ctx.failures)
+		std::printf("%d test(s) failed\n", ctx.failures);
+	else
+		std::printf("all tests passed\n");
+	std::exit(ctx.failures ? EXIT_FAILURE : EXIT_SUCCESS);
+}
+
+}
@@ -0,0 +1,103 @@
+/*  This file is part of Imagine.
+
+	Imagine is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Imagine is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Imagine.  If not, see <http://www.gnu.org/licenses/> */
+
+#include <imagine/pixmap/Pixmap.hh>
+#include "tests.hh"
+#include <algorithm>
+#include <random>
+#include <vector>
+
+namespace ConversionTest
+{
+
+template <class T>
+static std::vector<T> randomData(size_t size, uint32_t seed)
+{
+	std::mt19937 rng{seed};
+	std::vector<T> data(size);
+	std::ranges::generate(data, [&]{ return T(rng()); });
+	return data;
+}
+
+// Runs lineFunc over every test size, at both an aligned and an unaligned start, and compares
+// against refFunc applied per pixel. Destination guard values catch writes past either end.
+template <class Src, class Dest>
+static void testLine(TestContext &ctx, std::string_view name, auto &&lineFunc, auto &&refFunc)
+{
+	constexpr Dest guard = Dest(0xA5A5A5A5);
+	auto maxSize = std::ranges::max(testLineSizes);
+	auto src = randomData<Src>(maxSize + 1, 1);
+	std::vector<Dest> dest(maxSize + 2);
+	for(auto size : testLineSizes)
+	{
+		for(size_t offset : {0, 1})
+		{
+			std::ranges::fill(dest, guard);
+			lineFunc(src.data() + offset, dest.data() + offset, size);
+			bool passed = dest[offset + size] == guard && (!offset || dest[0] == guard);
+			for(size_t i = 0; i < size; i++)
+			{
+				if(dest[offset + i] != refFunc(src[offset + i]))
+				{
+					passed = false;
+					break;
+				}
+			}
+			ctx.check(passed, name, size, offset);
+		}
+	}
+	auto benchSrc = randomData<Src>(benchmarkSize, 2);
+	std::vector<Dest> benchDest(benchmarkSize);
+	auto scalarTime = timeRuns([&]
+	{
+		std::ranges::transform(benchSrc, benchDest.begin(), refFunc);
+	});
+	auto simdTime = timeRuns([&]
+	{
+		lineFunc(benchSrc.data(), benchDest.data(), benchSrc.size());
+	});
+	ctx.printBenchmark(name, scalarTime, simdTime, benchmarkSize);
+}
+
+template <class Src, class Dest>
+static void testIndexedLine(TestContext &ctx, std::string_view name)
+{
+	// 16-bit indexes use a full palette so every possible index is valid
+	auto palette = randomData<Dest>(size_t(1) << (sizeof(Src) * 8), 3);
+	testLine<Src, Dest>(ctx, name,
+		[&](const Src *src, Dest *dest, size_t pixels) { expandIndexedLine(src, dest, pixels, palette.data()); },
+		[&](Src idx) { return palette[idx]; });
+}
+
+void runPixmapTests(TestContext &ctx)
+{
+	std::printf("pixel conversion: %s\n", pixelConvertImplName());
+	testLine<uint16_t, uint32_t>(ctx, "RGB565 -> RGBX8888", convertLineRGB565ToRGBX8888,
+		[](uint16_t p) { return transformRGB565ToRGBX8888(p); });
+	testLine<uint16_t, uint32_t>(ctx, "RGB565 -> BGRX8888", convertLineRGB565ToBGRX8888,
+		[](uint16_t p) { return transformRGB565ToBGRX8888(p); });
+	testLine<uint32_t, uint16_t>(ctx, "RGBX8888 -> RGB565", convertLineRGBX8888ToRGB565,
+		[](uint32_t p) { return transformRGBX8888ToRGB565(p); });
+	testLine<uint32_t, uint16_t>(ctx, "BGRX8888 -> RGB565", convertLineBGRX8888ToRGB565,
+		[](uint32_t p) { return transformBGRX8888ToRGB565(p); });
+	testLine<uint32_t, uint32_t>(ctx, "RGBA8888 <-> BGRA8888", convertLineRGBA8888ToBGRA8888,
+		[](uint32_t p) { return transformRGBA8888ToBGRA8888(p); });
+	testIndexedLine<uint8_t, uint32_t>(ctx, "I8 -> 32-bit");
+	testIndexedLine<uint16_t, uint32_t>(ctx, "I16 -> 32-bit");
+	testIndexedLine<uint8_t, uint16_t>(ctx, "I8 -> 16-bit");
+	testIndexedLine<uint16_t, uint16_t>(ctx, "I16 -> 16-bit");
+}
+
+}
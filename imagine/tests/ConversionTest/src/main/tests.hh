@@ -0,0 +1,67 @@
+#pragma once
+
+/*  This file is part of Imagine.
+
+	Imagine is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Imagine is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Imagine.  If not, see <http://www.gnu.org/licenses/> */
+
+#include <imagine/time/Time.hh>
+#include <cstdio>
+#include <string_view>
+
+namespace ConversionTest
+{
+
+using namespace IG;
+
+// line lengths covering empty input, partial vectors, and unaligned tails for every SIMD width
+constexpr size_t testLineSizes[]{0, 1, 3, 7, 8, 15, 16, 17, 31, 32, 33, 63, 64, 65, 257, 1021};
+constexpr size_t benchmarkSize = 1024 * 1024;
+constexpr int benchmarkRuns = 16;
+
+class TestContext
+{
+public:
+	int failures{};
+
+	void check(bool passed, std::string_view name, size_t size, size_t offset)
+	{
+		if(passed)
+			return;
+		failures++;
+		std::printf("FAIL: %.*s (size:%zu offset:%zu)\n", int(name.size()), name.data(), size, offset);
+	}
+
+	// prints the throughput of the scalar reference and the dispatched kernel in millions of units per second
+	void printBenchmark(std::string_view name, SteadyClockTime scalarTime, SteadyClockTime simdTime, size_t units) const
+	{
+		auto rate = [&](SteadyClockTime t) { return double(units) * benchmarkRuns / std::chrono::duration<double>(t).count() / 1e6; };
+		std::printf("%.*s: %.0f -> %.0f M/s\n", int(name.size()), name.data(), rate(scalarTime), rate(simdTime));
+	}
+};
+
+template <class Func>
+inline SteadyClockTime timeRuns(Func &&f)
+{
+	auto start = SteadyClock::now();
+	for(int i = 0; i < benchmarkRuns; i++)
+	{
+		f();
+	}
+	return SteadyClock::now() - start;
+}
+
+void runPixmapTests(TestContext &);
+void runAudioTests(TestContext &);
+
+}
@@ -72,6 +72,7 @@ FrameRateTestApplication::FrameRateTestApplication(IG::ApplicationInitParams ini
 			auto &winData = win.makeAppData<WindowData>(IG::ViewAttachParams{viewManager, win, renderer.task()});
 			std::vector<TestDesc> testDesc;
 			testDesc.emplace_back(TEST_CLEAR, "Clear");
+			testDesc.emplace_back(TEST_EVENT_LOOP, "Event Loop Wakeup");
 			WSize pixmapSize{256, 256};
 			for(auto desc: renderer.textureBufferModes())
 			{
@@ -324,6 +325,7 @@ TestFramework *FrameRateTestApplication::startTest(IG::Window &win, const TestPa
 			case TEST_CLEAR: return std::make_unique<ClearTest>();
 			case TEST_DRAW: return std::make_unique<DrawTest>();
 			case TEST_WRITE: return std::make_unique<WriteTest>();
+			case TEST_EVENT_LOOP: return std::make_unique<EventLoopTest>();
 		}
 		bug_unreachable("invalid TestID");
 	}();
@@ -24,6 +24,7 @@
 #include <imagine/base/Window.hh>
 #include <imagine/base/Screen.hh>
 #include <imagine/logger/logger.h>
+#include <imagine/thread/Thread.hh>
 #include "tests.hh"
 #include "cpuUtils.hh"
 
@@ -37,6 +38,7 @@ const char *testIDToStr(TestID id)
 		case TEST_CLEAR: return "Clear";
 		case TEST_DRAW: return "Draw";
 		case TEST_WRITE: return "Write";
+		case TEST_EVENT_LOOP: return "Event Loop";
 		default: return "Unknown";
 	}
 }
@@ -155,6 +157,11 @@ void TestFramework::frameUpdate(Gfx::RendererTask &rTask, IG::Window &win, IG::F
 			if(skippedFrameStr.size() && statsStr.size())
 				str += '\n';
 			str += statsStr;
+			if(testStatsStr.size())
+			{
+				str += '\n';
+				str += testStatsStr;
+			}
 			frameStatsText.resetString(str);
 			placeFrameStatsText(rTask.renderer());
 		}
@@ -320,4 +327,70 @@ void WriteTest::drawTest(Gfx::RendererCommands &cmds, Gfx::ClipRect bounds)
 	sprite.draw(cmds, cmds.basicEffect());
 }
 
+static SteadyClockTime processCPUTime()
+{
+	timespec ts{};
+	clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+	return Seconds{ts.tv_sec} + Nanoseconds{ts.tv_nsec};
+}
+
+EventLoopTest::~EventLoopTest()
+{
+	if(!wakeThread.joinable())
+		return;
+	wakePort.send(SteadyClockTimePoint{});
+	wakeThread.join();
+}
+
+void EventLoopTest::initTest(IG::ApplicationContext, Gfx::Renderer &, WSize, Gfx::TextureBufferMode)
+{
+	wakeThread = makeThreadSync(
+		[this](auto &sem)
+		{
+			auto eventLoop = EventLoop::makeForThread();
+			bool running = true;
+			wakePort.attach(eventLoop, [this, &running](auto msgs)
+			{
+				auto now = SteadyClock::now();
+				for(auto sendTime : msgs)
+				{
+					if(!hasTime(sendTime))
+					{
+						running = false;
+						EventLoop::forThread().stop();
+						return false;
+					}
+					auto latency = duration_cast<Nanoseconds>(now - sendTime).count();
+					totalLatencyNs.fetch_add(latency, std::memory_order_relaxed);
+					if(latency > maxLatencyNs.load(std::memory_order_relaxed))
+						maxLatencyNs.store(latency, std::memory_order_relaxed);
+					wakeups.fetch_add(1, std::memory_order_relaxed);
+				}
+				return true;
+			});
+			sem.release();
+			eventLoop.run(running);
+			wakePort.detach();
+		});
+	statsStartCPUTime = processCPUTime();
+}
+
+void EventLoopTest::frameUpdateTest(Gfx::RendererTask &task, Screen &screen, SteadyClockTimePoint timestamp)
+{
+	ClearTest::frameUpdateTest(task, screen, timestamp);
+	wakePort.send(SteadyClock::now());
+	auto statsFrames = frames - statsStartFrame;
+	if(statsFrames < 120)
+		return;
+	auto cpuTime = processCPUTime();
+	auto wakeupCount = wakeups.exchange(0, std::memory_order_relaxed);
+	testStatsStr.clear();
+	IG::formatTo(testStatsStr, "Wakeup Latency: {:.1f}us (max {:.1f}us)\nCPU Time Per Frame: {:.1f}us",
+		wakeupCount ? totalLatencyNs.exchange(0, std::memory_order_relaxed) / 1000. / wakeupCount : 0.,
+		maxLatencyNs.exchange(0, std::memory_order_relaxed) / 1000.,
+		duration_cast<Nanoseconds>(cpuTime - statsStartCPUTime).count() / 1000. / statsFrames);
+	statsStartCPUTime = cpuTime;
+	statsStartFrame = frames;
+}
+
 }
@@ -22,6 +22,9 @@
 #include <imagine/time/Time.hh>
 #include <imagine/thread/Semaphore.hh>
 #include <imagine/base/ApplicationContext.hh>
+#include <imagine/base/MessagePort.hh>
+#include <atomic>
+#include <thread>
 
 namespace IG
 {
@@ -38,6 +41,7 @@ enum TestID
 	TEST_CLEAR,
 	TEST_DRAW,
 	TEST_WRITE,
+	TEST_EVENT_LOOP,
 };
 
 struct FramePresentTime
@@ -109,6 +113,7 @@ protected:
 	std::string cpuUseStr{};
 	std::string skippedFrameStr{};
 	std::string statsStr{};
+	std::string testStatsStr{};
 	WRect viewBounds{};
 	WRect cpuStatsRect{};
 	WRect frameStatsRect{};
@@ -149,6 +154,25 @@ public:
 	void drawTest(Gfx::RendererCommands &cmds, Gfx::ClipRect bounds) override;
 };
 
+// Wakes a thread's event loop once per frame to measure its wakeup latency, and the process CPU time
+// spent per frame while nothing else is running
+class EventLoopTest : public ClearTest
+{
+public:
+	~EventLoopTest() override;
+	void initTest(IG::ApplicationContext, Gfx::Renderer &, WSize pixmapSize, Gfx::TextureBufferMode) override;
+	void frameUpdateTest(Gfx::RendererTask &, Screen &, SteadyClockTimePoint) override;
+
+protected:
+	MessagePort<SteadyClockTimePoint> wakePort{"EventLoopTest::wakePort"};
+	std::thread wakeThread;
+	std::atomic<int64_t> totalLatencyNs{};
+	std::atomic<int64_t> maxLatencyNs{};
+	std::atomic<unsigned> wakeups{};
+	SteadyClockTime statsStartCPUTime{};
+	unsigned statsStartFrame{};
+};
+
 const char *testIDToStr(TestID id);
 
 }